@@ -0,0 +1,2 @@
+#version 450
+#define COMPACT_VERTICES
\ No newline at end of file
@@ -11,7 +11,7 @@ layout (std140) uniform LightViews
 
 layout (location = 0)   uniform int     viewIndex;  //!< The index of the light view transform to use.
 
-layout (location = 0)   in      vec3    position;   //!< The local position of the current vertex.
+layout (location = 0)   in      vec3    position;   //!< The local position of the current vertex, dequantised by the model transform if compact.
 layout (location = 4)   in      mat4x3  model;      //!< The model transform representing the position and rotation of the object in world space.
 
 
@@ -11,8 +11,12 @@ layout (std140) uniform Scene
     vec3    ambience;       //!< The ambient lighting in the scene.
 } scene;
 
-layout (location = 0)   in  vec3    position;       //!< The local position of the current vertex.
+layout (location = 0)   in  vec3    position;       //!< The local position of the current vertex, dequantised by the model transform if compact.
+#ifdef COMPACT_VERTICES
+layout (location = 1)   in  vec2    normal;         //!< The octahedral encoded local normal, skewed so the model transform restores it.
+#else
 layout (location = 1)   in  vec3    normal;         //!< The local normal vector of the current vertex.
+#endif
 layout (location = 2)   in  vec2    uv;             //!< The texture co-ordinates for the vertex, used for mapping a texture to the object.
 layout (location = 3)   in  int     matID;          //!< The material ID of the instance being drawn.
 layout (location = 4)   in  mat4x3  model;          //!< The model transform representing the position and rotation of the object in world space.
@@ -23,6 +27,20 @@ layout (location = 4)   in  mat4x3  model;          //!< The model transform rep
 flat                    out int     materialID;     //!< Allows the fragment shader to fetch the correct material data.
 
 
+#ifdef COMPACT_VERTICES
+/**
+    Unfolds an octahedral encoded unit vector, see util::compactVertex().
+*/
+vec3 decodeOctahedral (const vec2 e)
+{
+    vec3 n          = vec3 (e, 1.0 - abs (e.x) - abs (e.y));
+    const float t   = max (-n.z, 0.0);
+    n.xy            += mix (vec2 (t), vec2 (-t), greaterThanEqual (n.xy, vec2 (0.0)));
+    return normalize (n);
+}
+#endif
+
+
 /**
     Applies transformations to the vertex position to place it in the scene and outputs data to the fragment shader. 
 */
@@ -34,7 +52,11 @@ void main()
 
     // Set the outputs first.
     worldPosition   = model * homogeneousPosition;
-    worldNormal     = mat3 (model) * normal;
+    #ifdef COMPACT_VERTICES
+        worldNormal = mat3 (model) * decodeOctahedral (normal);
+    #else
+        worldNormal = mat3 (model) * normal;
+    #endif
     texturePoint    = uv;
     materialID      = matID;
 
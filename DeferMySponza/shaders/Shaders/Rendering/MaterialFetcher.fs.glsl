@@ -13,23 +13,67 @@ struct Material
 };
 
 uniform usamplerBuffer  materials;      //!< Contains every material in the scene.
+
+#ifdef BINDLESS_TEXTURES
+uniform usamplerBuffer  textureHandles; //!< The bindless handle of each texture array, split into two halves.
+#else
 uniform sampler2DArray  textures[16];   //!< An array of samplers containing different texture formats.
+#endif
+
+/// Components with this sampler index store a constant RGBA8 value in place of the array depth.
+const uint constantComponent = 0xFFFFFFFFu;
+
+
+vec4 fetchComponent (const in vec2 uvCoordinates, const in vec2 dx, const in vec2 dy, const in uvec4 component)
+{
+    // Constant components don't need a texture lookup.
+    if (component.x == constantComponent)
+    {
+        return unpackUnorm4x8 (component.y);
+    }
+
+    // Textures may only occupy a region of the layer so they must be repeated manually.
+    const vec2 offset   = unpackUnorm2x16 (component.z);
+    const vec2 scale    = unpackUnorm2x16 (component.w);
+    const vec2 region   = fract (uvCoordinates) * scale + offset;
+
+    // Derivatives are given explicitly because neighbouring fragments may not take this branch and the wrapped
+    // co-ordinates are discontinuous.
+    #ifdef BINDLESS_TEXTURES
+
+        // Handles are stored in the same order as the arrays they refer to.
+        const uvec2 handle = texelFetch (textureHandles, int (component.x)).xy;
+        return textureGrad (sampler2DArray (handle), vec3 (region, component.y), dx * scale, dy * scale);
+
+    #else
+
+        return textureGrad (textures[component.x], vec3 (region, component.y), dx * scale, dy * scale);
+
+    #endif
+}
 
 
 Material fetchMaterialProperties (const in vec2 uvCoordinates, const in int materialID)
 {
-    // Materials can contain up to three maps, requiring two texel fetches.
-    const int texelCount    = 2;
+    // Materials contain three maps, each requiring a texel fetch.
+    const int texelCount    = 3;
     const int materialIndex = materialID * texelCount;
 
     // Now we can fetch each component.
-    const uvec4 propertiesAndAlbedo = texelFetch (materials, materialIndex);
-    const uvec2 normal              = texelFetch (materials, materialIndex + 1).xy;
+    const uvec4 propertiesComponent = texelFetch (materials, materialIndex);
+    const uvec4 albedoComponent     = texelFetch (materials, materialIndex + 1);
+    const uvec4 normalComponent     = texelFetch (materials, materialIndex + 2);
+
+    // Components are the array, depth and region of each map, this allows us to retrieve the correct map.
+    const vec2 dx           = dFdx (uvCoordinates);
+    const vec2 dy           = dFdy (uvCoordinates);
+    const vec3 properties   = fetchComponent (uvCoordinates, dx, dy, propertiesComponent).xyz;
+    const vec4 albedo       = fetchComponent (uvCoordinates, dx, dy, albedoComponent);
+    const vec2 normalXY     = fetchComponent (uvCoordinates, dx, dy, normalComponent).rg * 2.0 - 1.0;
 
-    // Components are array-depth pairs, this allows us to retrieve the correct map.
-    const vec3 properties   = texture (textures[propertiesAndAlbedo.x], vec3 (uvCoordinates, propertiesAndAlbedo.y)).xyz;
-    const vec4 albedo       = texture (textures[propertiesAndAlbedo.z], vec3 (uvCoordinates, propertiesAndAlbedo.w));
-    const vec3 normalMap    = texture (textures[normal.x], vec3 (uvCoordinates, normal.y)).rgb;
+    // Normal maps are stored as two channels so Z must be reconstructed, it always faces away from the surface.
+    const float normalZ     = sqrt (max (1.0 - dot (normalXY, normalXY), 0.0));
+    const vec3 normalMap    = vec3 (normalXY, normalZ) * 0.5 + 0.5;
 
     // Reflectance controls the fresnel effect of a material. Here we restrict the F0 co-efficient based conductivity.
     const float dielecticReflectance = 0.2;
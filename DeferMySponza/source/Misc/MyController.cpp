@@ -14,7 +14,7 @@ MyController::MyController() : camera_turn_mode_(false)
     camera_move_speed_[3] = 0;
     camera_rotate_speed_[0] = 0;
     camera_rotate_speed_[1] = 0;
-    scene_ = new scene::Context();
+    scene_ = new scene::Context(true);
     view_ = new MyView();
     view_->setScene(scene_);
 }
@@ -53,6 +53,7 @@ struct MultiDrawCommands final
     size_t      start       { 0 };                  //!< The byte offset to the first draw command in the buffer.
     GLsizei     count       { 0 };                  //!< How many draw commands from the starting offset to call.
     GLsizei     capacity    { 0 };                  //!< The maximum capacity of the draw command buffer, useful for batching.
+    GLsizei     shortCount  { 0 };                  //!< How many commands from the starting offset use GL_UNSIGNED_SHORT elements, the rest use type.
 
 
     MultiDrawCommands (const GLenum mode, const GLenum type, const size_t start, const GLsizei count, 
@@ -80,11 +81,20 @@ struct MultiDrawCommands final
 
     /// <summary> 
     /// Performs a draw command with the stored offset and count values. Assumes the buffer has already been bound to
-    /// GL_DRAW_INDIRECT_BUFFER.
+    /// GL_DRAW_INDIRECT_BUFFER. Commands using 16-bit elements are drawn in a separate call to the rest.
     /// </summary>
     void drawWithoutBinding() const noexcept
     {
-        glMultiDrawElementsIndirect (mode, type, (void*) start, count, 0);
+        if (shortCount > 0)
+        {
+            glMultiDrawElementsIndirect (mode, GL_UNSIGNED_SHORT, (void*) start, shortCount, 0);
+        }
+
+        if (count > shortCount)
+        {
+            const auto wideStart = start + sizeof (MultiDrawElementsIndirectCommand) * shortCount;
+            glMultiDrawElementsIndirect (mode, type, (void*) wideStart, count - shortCount, 0);
+        }
     }
 
     /// <summary> Increments the start of the command buffer by the given number of commands. </summary>
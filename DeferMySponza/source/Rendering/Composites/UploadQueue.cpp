@@ -0,0 +1,437 @@
+#include "UploadQueue.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Personal headers.
+#include <Rendering/Composites/PersistentMappedBuffer.hpp>
+#include <Rendering/Objects/Sync.hpp>
+#include <Utility/StartupTimeline.hpp>
+
+
+/// <summary>
+/// The ring and the bookkeeping shared between producers and the OpenGL thread. Reservations are released in the order
+/// they were made so the free space is always the region between the newest and oldest unreleased reservation.
+/// </summary>
+class UploadQueue::Internals final
+{
+    public:
+
+        /// <summary> The progress of a reservation, its space is released once the GPU has finished with it. </summary>
+        enum class State : std::uint8_t
+        {
+            Reserved,   //!< The producer is still writing to it.
+            Submitted,  //!< Waiting to be issued by process().
+            Issued,     //!< Waiting for the fence of its batch to be signalled.
+            Cancelled   //!< Released without being copied.
+        };
+
+        /// <summary> A reservation which hasn't been released yet. </summary>
+        struct Block final
+        {
+            GLsizeiptr      size    { 0 };                  //!< The reserved bytes plus any padding skipped before them.
+            std::uint64_t   batch   { 0 };                  //!< The batch which issued the copy.
+            State           state   { State::Reserved };    //!< Whether the block can be released.
+        };
+
+        /// <summary> A submitted copy waiting to be issued. </summary>
+        struct Copy final
+        {
+            Staging         staging { };    //!< Where the data is in the ring.
+            GLuint          buffer  { 0 };  //!< The buffer to copy into, zero if copying into a texture.
+            GLintptr        offset  { 0 };  //!< Where to copy into the buffer.
+            TextureRegion   region  { };    //!< Where to copy into the texture.
+        };
+
+        /// <summary> A group of copies issued together and the fence which follows them. </summary>
+        struct Batch final
+        {
+            std::uint64_t   id      { 0 };  //!< Identifies the batch, blocks record which batch issued them.
+            Sync            fence   { };    //!< Signalled once every copy in the batch has completed.
+        };
+
+        PersistentMappedBuffer<1>   ring        { };    //!< The persistently mapped staging memory.
+        mutable std::mutex          mutex       { };    //!< Protects everything except the ring and batches.
+        std::deque<Block>           blocks      { };    //!< Every unreleased reservation, in reservation order.
+        std::vector<Copy>           submitted   { };    //!< Copies waiting to be issued, in submission order.
+        std::deque<Batch>           batches     { };    //!< Issued batches waiting for their fence, GL thread only.
+        std::uint64_t               firstBlock  { 1 };  //!< The reservation ID of the front block.
+        std::uint64_t               nextBatch   { 1 };  //!< The ID to give the next batch.
+        std::uint64_t               completed   { 0 };  //!< The newest batch which the GPU has finished.
+        GLsizeiptr                  head        { 0 };  //!< Where the next reservation will start looking for space.
+        GLsizeiptr                  used        { 0 };  //!< How many bytes are reserved, including padding.
+
+
+        /// <summary> Gets the block of the given reservation, the mutex must be locked. </summary>
+        Block& block (const Staging& staging) noexcept
+        {
+            return blocks[static_cast<size_t> (staging.id - firstBlock)];
+        }
+
+        /// <summary> Checks whether any reservation is still being written, the mutex must be locked. </summary>
+        bool isWriting() const noexcept
+        {
+            return std::any_of (std::begin (blocks), std::end (blocks), 
+                [] (const Block& block) { return block.state == State::Reserved; });
+        }
+
+        /// <summary> Releases every finished block at the front of the ring, the mutex must be locked. </summary>
+        void release() noexcept
+        {
+            while (!blocks.empty())
+            {
+                const auto& front = blocks.front();
+                if (!(front.state == State::Cancelled || (front.state == State::Issued && front.batch <= completed)))
+                {
+                    break;
+                }
+
+                used -= front.size;
+                blocks.pop_front();
+                ++firstBlock;
+            }
+
+            // An empty ring can start from the beginning again, reducing how often reservations wrap.
+            if (blocks.empty())
+            {
+                head = 0;
+                used = 0;
+            }
+        }
+};
+
+
+UploadQueue::UploadQueue() noexcept
+{
+    m_internals = std::make_unique<Internals>();
+}
+
+
+UploadQueue::UploadQueue (UploadQueue&& move) noexcept
+{
+    *this = std::move (move);
+}
+
+
+UploadQueue& UploadQueue::operator= (UploadQueue&& move) noexcept
+{
+    if (this != &move)
+    {
+        clean();
+        m_internals = std::move (move.m_internals);
+    }
+
+    return *this;
+}
+
+
+UploadQueue::~UploadQueue()
+{
+    clean();
+}
+
+
+bool UploadQueue::isInitialised() const noexcept
+{
+    return m_internals && m_internals->ring.isInitialised();
+}
+
+
+GLsizeiptr UploadQueue::getCapacity() const noexcept
+{
+    return m_internals ? m_internals->ring.getSize() : 0;
+}
+
+
+bool UploadQueue::initialise (const GLsizeiptr capacity) noexcept
+{
+    // Producers only ever write to the ring and a coherent mapping means we never need to flush.
+    auto ring = PersistentMappedBuffer<1> { };
+    if (capacity <= 0 || !ring.initialise (capacity, false, true))
+    {
+        return false;
+    }
+
+    clean();
+    m_internals->ring = std::move (ring);
+    return true;
+}
+
+
+void UploadQueue::clean() noexcept
+{
+    if (!isInitialised())
+    {
+        return;
+    }
+
+    // Anything still waiting must be issued before we can wait for the GPU to finish with the ring.
+    process();
+    while (waitForSpace()) { }
+
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+
+    internals.ring.clean();
+    internals.blocks.clear();
+    internals.submitted.clear();
+    internals.batches.clear();
+    internals.head = 0;
+    internals.used = 0;
+}
+
+
+UploadQueue::Staging UploadQueue::reserve (const GLsizeiptr size, const GLsizeiptr alignment) noexcept
+{
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+    const auto capacity = internals.ring.getSize();
+
+    if (size <= 0 || size > capacity || alignment <= 0)
+    {
+        return { };
+    }
+
+    // Space skipped to align the reservation, or at the end of the ring if it has to wrap, belongs to the block.
+    auto start  = (internals.head + alignment - 1) / alignment * alignment;
+    auto pad    = start - internals.head;
+
+    if (start + size > capacity)
+    {
+        start   = 0;
+        pad     = capacity - internals.head;
+    }
+
+    if (internals.used + pad + size > capacity)
+    {
+        return { };
+    }
+
+    internals.head = start + size;
+    internals.used += pad + size;
+    internals.blocks.push_back ({ pad + size, 0, Internals::State::Reserved });
+
+    auto staging    = Staging { };
+    staging.id      = internals.firstBlock + internals.blocks.size() - 1;
+    staging.offset  = start;
+    staging.size    = size;
+    staging.pointer = internals.ring.pointer() + start;
+    return staging;
+}
+
+
+void UploadQueue::copyToBuffer (const Staging& staging, const GLuint buffer, const GLintptr offset) noexcept
+{
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+
+    internals.block (staging).state = Internals::State::Submitted;
+    internals.submitted.push_back ({ staging, buffer, offset, TextureRegion { } });
+}
+
+
+void UploadQueue::copyToTexture (const Staging& staging, const TextureRegion& region) noexcept
+{
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+
+    internals.block (staging).state = Internals::State::Submitted;
+    internals.submitted.push_back ({ staging, 0, 0, region });
+}
+
+
+void UploadQueue::cancel (const Staging& staging) noexcept
+{
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+
+    internals.block (staging).state = Internals::State::Cancelled;
+    internals.release();
+}
+
+
+bool UploadQueue::isIssued (const Staging& staging) const noexcept
+{
+    auto& internals = *m_internals;
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+
+    if (staging.id < internals.firstBlock)
+    {
+        return true;
+    }
+
+    const auto state = internals.blocks[static_cast<size_t> (staging.id - internals.firstBlock)].state;
+    return state == Internals::State::Issued || state == Internals::State::Cancelled;
+}
+
+
+size_t UploadQueue::process() noexcept
+{
+    auto& internals = *m_internals;
+    auto copies     = std::vector<Internals::Copy> { };
+    auto issued     = size_t { 0 };
+
+    // Take the submitted copies so producers aren't blocked whilst they're issued.
+    {
+        const std::lock_guard<std::mutex> lock { internals.mutex };
+        copies.swap (internals.submitted);
+    }
+
+    if (!copies.empty())
+    {
+        const auto ring = internals.ring.getID();
+
+        // Texel offsets are read from the ring through the pixel unpack binding, staged texels are tightly packed.
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, ring);
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+
+        for (const auto& copy : copies)
+        {
+            const auto& staging = copy.staging;
+            const auto& region  = copy.region;
+            const auto texels   = reinterpret_cast<const void*> (staging.offset);
+
+            if (copy.buffer != 0)
+            {
+                glCopyNamedBufferSubData (ring, copy.buffer, staging.offset, copy.offset, staging.size);
+            }
+
+            else if (region.type == 0)
+            {
+                glCompressedTextureSubImage3D (region.texture, region.level, region.x, region.y, region.z,
+                    region.width, region.height, region.depth, region.format, static_cast<GLsizei> (staging.size),
+                    texels);
+            }
+
+            else
+            {
+                glTextureSubImage3D (region.texture, region.level, region.x, region.y, region.z,
+                    region.width, region.height, region.depth, region.format, region.type, texels);
+            }
+
+            issued += static_cast<size_t> (staging.size);
+        }
+
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+        glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+        StartupTimeline::recordUpload (issued);
+
+        // Fence the batch, if that fails we have no choice but to wait for the copies now.
+        auto batch  = Internals::Batch { internals.nextBatch++, Sync { } };
+        auto fenced = batch.fence.initialise();
+
+        if (!fenced)
+        {
+            glFinish();
+        }
+
+        const std::lock_guard<std::mutex> lock { internals.mutex };
+        for (const auto& copy : copies)
+        {
+            auto& block = internals.block (copy.staging);
+            block.state = Internals::State::Issued;
+            block.batch = batch.id;
+        }
+
+        if (fenced)
+        {
+            internals.batches.push_back (std::move (batch));
+        }
+
+        else
+        {
+            internals.completed = batch.id;
+        }
+    }
+
+    // Now release the space of any batches the GPU has finished with.
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+    while (!internals.batches.empty() && internals.batches.front().fence.checkIfSignalled())
+    {
+        internals.completed = internals.batches.front().id;
+        internals.batches.pop_front();
+    }
+
+    internals.release();
+    return issued;
+}
+
+
+bool UploadQueue::upload (const GLuint buffer, const GLintptr offset, const GLsizeiptr size,
+    const void* data) noexcept
+{
+    if (!isInitialised() || !data)
+    {
+        return false;
+    }
+
+    // Smaller chunks let the GPU start copying whilst the rest are being staged.
+    const auto chunkSize    = std::max (getCapacity() / 4, GLsizeiptr { 1 });
+    const auto bytes        = static_cast<const GLbyte*> (data);
+
+    for (auto copied = GLsizeiptr { 0 }; copied < size;)
+    {
+        const auto length   = std::min (chunkSize, size - copied);
+        auto staging        = reserve (length);
+
+        while (!staging.isValid())
+        {
+            // Issue anything waiting so its space can be reclaimed, otherwise wait for the GPU to finish a batch. 
+            // Space held by other producers is only reclaimable once they submit, so give them time to do so.
+            if (process() == 0 && !waitForSpace())
+            {
+                if (!isWriting())
+                {
+                    return false;
+                }
+
+                std::this_thread::yield();
+            }
+
+            staging = reserve (length);
+        }
+
+        std::memcpy (staging.pointer, bytes + copied, static_cast<size_t> (length));
+        copyToBuffer (staging, buffer, offset + copied);
+        copied += length;
+    }
+
+    process();
+    return true;
+}
+
+
+bool UploadQueue::isWriting() const noexcept
+{
+    const std::lock_guard<std::mutex> lock { m_internals->mutex };
+    return m_internals->isWriting();
+}
+
+
+bool UploadQueue::waitForSpace() noexcept
+{
+    // Batches are only modified on the OpenGL thread so the fence can be waited on without blocking producers.
+    auto& internals = *m_internals;
+    if (internals.batches.empty())
+    {
+        return false;
+    }
+
+    auto& oldest = internals.batches.front();
+    oldest.fence.waitForSignal (true, std::numeric_limits<GLuint64>::max());
+
+    const std::lock_guard<std::mutex> lock { internals.mutex };
+    internals.completed = oldest.id;
+    internals.batches.pop_front();
+    internals.release();
+    return true;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#if !defined    _RENDERING_COMPOSITES_UPLOAD_QUEUE_
+#define         _RENDERING_COMPOSITES_UPLOAD_QUEUE_
+
+// STL headers.
+#include <cstdint>
+#include <memory>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+/// <summary>
+/// Streams data into buffers and textures through a persistently mapped staging ring. Producers on any thread reserve
+/// space in the ring, write their data straight into it and then submit a copy. The OpenGL thread issues submitted
+/// copies with process() so the driver never has to copy from client memory on the calling thread. Each batch of
+/// copies is fenced and its space is reused once the GPU has signalled the fence.
+/// </summary>
+class UploadQueue final
+{
+    public:
+
+        constexpr static auto defaultCapacity   = GLsizeiptr { 32 * 1024 * 1024 };    //!< The default ring size.
+        constexpr static auto defaultAlignment  = GLsizeiptr { 64 };                   //!< Reservations start on this.
+
+        /// <summary> Space in the ring which a producer fills before submitting a copy. </summary>
+        struct Staging final
+        {
+            std::uint64_t   id      { 0 };          //!< Identifies the reservation, zero if nothing was reserved.
+            GLintptr        offset  { 0 };          //!< Where the reserved space starts in the ring.
+            GLsizeiptr      size    { 0 };          //!< How many bytes were reserved.
+            GLbyte*         pointer { nullptr };    //!< Where the producer should write its data.
+
+            /// <summary> Checks whether space was actually reserved. </summary>
+            inline bool isValid() const noexcept { return id != 0; }
+        };
+
+        /// <summary> Where staged texels are placed in a texture, the texels must be tightly packed. </summary>
+        struct TextureRegion final
+        {
+            GLuint      texture     { 0 };  //!< The texture to copy into.
+            GLint       level       { 0 };  //!< The mipmap level to copy into.
+            GLint       x           { 0 };  //!< The starting texel along the width.
+            GLint       y           { 0 };  //!< The starting texel along the height.
+            GLint       z           { 0 };  //!< The starting layer or depth, zero for 2D textures.
+            GLsizei     width       { 0 };  //!< How many texels wide the region is.
+            GLsizei     height      { 0 };  //!< How many texels high the region is.
+            GLsizei     depth       { 1 };  //!< How many layers deep the region is.
+            GLenum      format      { 0 };  //!< The pixel format, or internal format if compressed, e.g. GL_RGBA.
+            GLenum      type        { 0 };  //!< The pixel type, e.g. GL_UNSIGNED_BYTE. Zero for compressed data.
+        };
+
+    public:
+
+        UploadQueue() noexcept;
+        UploadQueue (UploadQueue&&) noexcept;
+        UploadQueue& operator= (UploadQueue&&) noexcept;
+        ~UploadQueue();
+
+        UploadQueue (const UploadQueue&)            = delete;
+        UploadQueue& operator= (const UploadQueue&) = delete;
+
+
+        /// <summary> Checks whether the ring has been created. </summary>
+        bool isInitialised() const noexcept;
+
+        /// <summary> Gets the size of the ring, reservations larger than this can never succeed. </summary>
+        GLsizeiptr getCapacity() const noexcept;
+
+        /// <summary>
+        /// Creates and persistently maps the ring, this must be called on the OpenGL thread. Successive calls will
+        /// wait for the previous ring to be idle before replacing it. Upon failure the object will not be modified.
+        /// </summary>
+        /// <param name="capacity"> How many bytes the ring should contain. </param>
+        /// <returns> Whether the ring could be created. </returns>
+        bool initialise (const GLsizeiptr capacity = defaultCapacity) noexcept;
+
+        /// <summary> Waits for every issued copy to complete and then deletes the ring. </summary>
+        void clean() noexcept;
+
+
+        /// <summary>
+        /// Reserves contiguous space in the ring, this may be called on any thread. Reservations are never blocked,
+        /// an invalid reservation is returned if there isn't enough space so the producer can try again later.
+        /// Every valid reservation must be given to copyToBuffer(), copyToTexture() or cancel().
+        /// </summary>
+        /// <param name="size"> How many bytes are required. </param>
+        /// <param name="alignment"> The offset of the reservation will be a multiple of this. </param>
+        Staging reserve (const GLsizeiptr size, const GLsizeiptr alignment = defaultAlignment) noexcept;
+
+        /// <summary> Submits a copy of every reserved byte into the given buffer, this may be called on any thread. </summary>
+        /// <param name="staging"> A filled reservation. </param>
+        /// <param name="buffer"> The buffer to copy into, it doesn't need GL_DYNAMIC_STORAGE_BIT. </param>
+        /// <param name="offset"> How many bytes into the buffer the data should be copied. </param>
+        void copyToBuffer (const Staging& staging, const GLuint buffer, const GLintptr offset) noexcept;
+
+        /// <summary> Submits a copy of reserved texels into the given texture, this may be called on any thread. </summary>
+        /// <param name="staging"> A filled reservation. </param>
+        /// <param name="region"> Where the texels should be placed. </param>
+        void copyToTexture (const Staging& staging, const TextureRegion& region) noexcept;
+
+        /// <summary> Releases a reservation without copying it anywhere, this may be called on any thread. </summary>
+        void cancel (const Staging& staging) noexcept;
+
+        /// <summary>
+        /// Checks whether the copy of the given reservation has been issued, commands issued afterwards will see the
+        /// copied data. Cancelled reservations count as issued.
+        /// </summary>
+        bool isIssued (const Staging& staging) const noexcept;
+
+
+        /// <summary>
+        /// Issues every submitted copy in submission order and fences them, then releases the space of any copies the
+        /// GPU has finished with. This must be called on the OpenGL thread, usually once per frame.
+        /// </summary>
+        /// <returns> How many bytes were issued. </returns>
+        size_t process() noexcept;
+
+        /// <summary>
+        /// Copies the given data into a buffer through the ring, splitting it into chunks if necessary. This must be
+        /// called on the OpenGL thread and will wait for the GPU if the ring is full, or for other producers to submit
+        /// if their reservations fill it. The copies are issued before returning so the buffer can be used
+        /// immediately.
+        /// </summary>
+        /// <param name="buffer"> The buffer to copy into, it doesn't need GL_DYNAMIC_STORAGE_BIT. </param>
+        /// <param name="offset"> How many bytes into the buffer the data should be copied. </param>
+        /// <param name="size"> How many bytes to copy. </param>
+        /// <param name="data"> The data to copy, this can be freed as soon as the function returns. </param>
+        /// <returns> Whether every chunk was copied. </returns>
+        bool upload (const GLuint buffer, const GLintptr offset, const GLsizeiptr size, const void* data) noexcept;
+
+    private:
+
+        class Internals;
+        using Pimpl = std::unique_ptr<Internals>;
+
+        Pimpl m_internals { };  //!< The ring, its reservations and the fences protecting it.
+
+    private:
+
+        /// <summary> Waits for the oldest fence to be signalled and releases its space, only on the OpenGL thread. </summary>
+        /// <returns> Whether any space could be released. </returns>
+        bool waitForSpace() noexcept;
+
+        /// <summary> Checks whether any reservation is still being written, on any thread. </summary>
+        bool isWriting() const noexcept;
+};
+
+#endif // _RENDERING_COMPOSITES_UPLOAD_QUEUE_
@@ -7,6 +7,10 @@
 #include <tgl/tgl.h>
 
 
+// Personal headers.
+#include <Utility/StartupTimeline.hpp>
+
+
 /// <summary>
 /// Manages an OpenGL buffer. This is a general purpose RAII encapsulation with the expectation of being used in
 /// the composition of more complex object types.
@@ -53,7 +57,8 @@ class Buffer final
         /// <param name="size"> How many bytes of memory to allocate. </param>
         /// <param name="flags"> 
         /// Flags that determine the capabilities of the buffer. E.g. GL_DYNAMIC_STORAGE_BIT allows for data to be
-        /// placed inside the storage. 0 should not be given because the contents will be permanently uninitialised.
+        /// placed inside the storage. 0 should only be given if the buffer will be filled by copying from another
+        /// buffer, e.g. with an UploadQueue, otherwise the contents will be permanently uninitialised.
         /// </param>
         void allocateImmutableStorage (const GLsizeiptr size, const GLbitfield flags = GL_DYNAMIC_STORAGE_BIT) noexcept
         {
@@ -76,6 +81,7 @@ class Buffer final
         {
             const auto size = data.size() * sizeof (Data);
             glNamedBufferStorage (m_buffer, size, data.data(), flags);
+            StartupTimeline::recordUpload (size);
             return size;
         }
 
@@ -87,9 +93,24 @@ class Buffer final
         GLsizeiptr immutablyFillWith (const Data* data, const GLbitfield flags = 0) noexcept
         {
             glNamedBufferStorage (m_buffer, sizeof (Data), data, flags);
+            StartupTimeline::recordUpload (sizeof (Data));
             return sizeof (Data);
         }
 
+        /// <summary>
+        /// Fills the buffer with a raw block of memory, such as a region of a memory-mapped file. This avoids the need
+        /// to copy data into a container before it can be uploaded.
+        /// </summary>
+        /// <param name="size"> How many bytes should be copied from the given data. </param>
+        /// <param name="data"> The start of the memory to fill the buffer with. </param>
+        /// <returns> The amount of allocated data. </returns>
+        GLsizeiptr immutablyFillWith (const GLsizeiptr size, const void* data, const GLbitfield flags = 0) noexcept
+        {
+            glNamedBufferStorage (m_buffer, size, data, flags);
+            StartupTimeline::recordUpload (data ? size : 0);
+            return size;
+        }
+
         /// <summary> 
         /// Allocates the desired amount of memory to the buffer. This function will bind and unbind itself to the
         /// given target. Mutable storage can be reallocated but may restrict implementation optimisation. This
@@ -113,6 +134,7 @@ class Buffer final
         {
             const auto size = data.size() * sizeof (Data);
             glNamedBufferData (m_buffer, data.size() * sizeof (Data), data.data(), usage);
+            StartupTimeline::recordUpload (size);
             return size;
         }
 
@@ -127,6 +149,7 @@ class Buffer final
         void placeAt (const GLintptr offset, const Container<Data, Args...>& data) noexcept
         {
             glNamedBufferSubData (m_buffer, offset, data.size() * sizeof (Data), data.data());
+            StartupTimeline::recordUpload (data.size() * sizeof (Data));
         }
 
         /// <summary> 
@@ -140,6 +163,7 @@ class Buffer final
         void placeAt (const GLintptr offset, const Data& data) noexcept
         {
             glNamedBufferSubData (m_buffer, offset, sizeof (Data), &data);
+            StartupTimeline::recordUpload (sizeof (Data));
         }
 
         /// <summary> 
@@ -155,6 +179,7 @@ class Buffer final
             if (data)
             {
                 glNamedBufferSubData (m_buffer, offset, size, data);
+                StartupTimeline::recordUpload (size);
             }
         }
 
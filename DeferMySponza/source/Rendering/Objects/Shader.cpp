@@ -9,11 +9,11 @@
 
 // Engine headers.
 #include <tgl/tgl.h>
-#include <tygra/FileHelper.hpp>
 
 
 // Personal headers.
 #include <Utility/Algorithm.hpp>
+#include <Utility/FileService.hpp>
 
 
 Shader::Shader (Shader&& move) noexcept
@@ -77,8 +77,8 @@ void Shader::clean() noexcept
 
 bool Shader::attachSource (const std::string& fileLocation) noexcept
 {
-    // Use the tygra library to read the entire file.
-    auto string = tygra::createStringFromFile (fileLocation);
+    // Read the entire file, this will claim the result if the file has already been prefetched.
+    auto string = FileService::instance().readText (fileLocation).get();
     
     // Ensure it's valid.
     if (string.empty())
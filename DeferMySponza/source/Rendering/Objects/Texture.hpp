@@ -7,6 +7,11 @@
 #include <tgl/tgl.h>
 
 
+// Personal headers.
+#include <Utility/OpenGL/Textures.hpp>
+#include <Utility/StartupTimeline.hpp>
+
+
 // Forward declarations.
 template <GLenum target>
 class TextureT;
@@ -154,6 +159,7 @@ class TextureT final : public Texture
             GLenum pixelFormat, GLenum pixelType, const GLvoid* pixelData = nullptr, GLsizei level = 0) noexcept
         {
             glTextureSubImage2D (m_texture, level, xOffset, yOffset, width, height, pixelFormat, pixelType, pixelData);
+            StartupTimeline::recordUpload (pixelData ? width * height * util::pixelSize (pixelFormat, pixelType) : 0);
         }
 
         /// <summary> 
@@ -176,6 +182,31 @@ class TextureT final : public Texture
         {
             glTextureSubImage3D (m_texture, level, xOffset, yOffset, zOffset,
                 width, height, depth, pixelFormat, pixelType, pixelData);
+            StartupTimeline::recordUpload (pixelData ?
+                width * height * depth * util::pixelSize (pixelFormat, pixelType) : 0);
+        }
+
+        /// <summary>
+        /// Places block compressed data at the given location inside the texture. Offsets and dimensions must be
+        /// multiples of the block size unless they reach the edge of the level. This is only for 3D textures types.
+        /// </summary>
+        /// <param name="xOffset"> The number of texels to offset into the image on the X axis. </param>
+        /// <param name="yOffset"> The number of texels to offset into the image on the Y axis. </param>
+        /// <param name="zOffset"> The number of texels to offset into the image on the Z axis. </param>
+        /// <param name="width"> How many texels wide the data is. </param>
+        /// <param name="height"> How many texels tall the data is. </param>
+        /// <param name="depth"> How many texels deep the data is. </param>
+        /// <param name="internalFormat"> The compressed format of the data, this must match the storage. </param>
+        /// <param name="dataSize"> How many bytes of compressed data are given. </param>
+        /// <param name="data"> The compressed blocks to upload to the allocated storage. </param>
+        /// <param name="level"> The mipmap level of the image to set the data for, 0 is the base image. </param>
+        template <typename = std::enable_if_t<Target == GL_TEXTURE_2D_ARRAY || Target == GL_TEXTURE_3D || Target == GL_TEXTURE_CUBE_MAP_ARRAY>>
+        void placeCompressedAt (GLint xOffset, GLint yOffset, GLint zOffset, GLsizei width, GLsizei height,
+            GLsizei depth, GLenum internalFormat, GLsizei dataSize, const GLvoid* data, GLsizei level = 0) noexcept
+        {
+            glCompressedTextureSubImage3D (m_texture, level, xOffset, yOffset, zOffset,
+                width, height, depth, internalFormat, dataSize, data);
+            StartupTimeline::recordUpload (data ? dataSize : 0);
         }
 
         /// <summary> Tells OpenGL to generate mipmaps based on the data currently stored by the texture. </summary>
@@ -18,8 +18,7 @@ ShadowMaps::ShadowMaps (ShadowMaps&& move) noexcept
 
 GLint ShadowMaps::operator[] (const scene::LightId lightID) const noexcept
 {
-    const auto iterator = m_ids.find (lightID);
-    return iterator != std::cend (m_ids) ? iterator->second : -1;
+    return m_ids.get (lightID, -1);
 }
 
 
@@ -29,7 +28,7 @@ bool ShadowMaps::isInitialised() const noexcept
 }
 
 
-bool ShadowMaps::initialise (const std::vector<scene::SpotLight>& spotlights, const GLuint textureUnit) noexcept
+bool ShadowMaps::initialise (const scene::Span<const scene::SpotLight> spotlights, const GLuint textureUnit) noexcept
 {
     // Create temporary objects.
     auto fbo    = decltype (m_fbo) { };
@@ -48,7 +47,7 @@ bool ShadowMaps::initialise (const std::vector<scene::SpotLight>& spotlights, co
     {
         if (light.getCastShadow())
         {
-            ids[light.getId()] = static_cast<GLint> (lights.size());
+            ids.set (light.getId(), static_cast<GLint> (lights.size()));
             lights.push_back (light.getId());
         }
     }
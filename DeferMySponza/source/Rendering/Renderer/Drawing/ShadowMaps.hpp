@@ -4,13 +4,13 @@
 #define	        _RENDERING_RENDERER_DRAWING_SHADOW_MAPS_
 
 // Personal headers.
-#include <unordered_map>
 #include <vector>
 
 
 // Engine headers
 #include <glm/fwd.hpp>
 #include <scene/scene_fwd.hpp>
+#include <scene/Span.hpp>
 
 
 // Personal headers.
@@ -18,6 +18,7 @@
 #include <Rendering/Objects/Framebuffer.hpp>
 #include <Rendering/Objects/Texture.hpp>
 #include <Rendering/Renderer/Uniforms/Blocks/FullBlock.hpp>
+#include <Utility/DenseIDMap.hpp>
 
 
 /// <summary> 
@@ -59,7 +60,7 @@ class ShadowMaps final
         /// <param name="spotlights"> A collection of spotlights to produce shadow maps for. </param>
         /// <param name="textureUnit"> The texture unit to use for storing shadow maps. </param>
         /// <returns> Whether initialisation was successful. </returns>
-        bool initialise (const std::vector<scene::SpotLight>& spotlights, const GLuint textureUnit) noexcept;
+        bool initialise (const scene::Span<const scene::SpotLight> spotlights, const GLuint textureUnit) noexcept;
 
         /// <summary> Deletes every stored object. </summary>
         void clean() noexcept;
@@ -86,7 +87,7 @@ class ShadowMaps final
         constexpr static auto maxResolution = 2048; //!< The maximum resolution of the shadow maps.
 
         using Spotlights    = std::vector<scene::LightId>;
-        using MapIDs        = std::unordered_map<scene::LightId, GLint>;
+        using MapIDs        = DenseIDMap<scene::LightId, GLint>;
 
         Framebuffer     m_fbo       { };    //!< A framebuffer containing a depth attachment to render with.
         Texture2DArray  m_maps      { };    //!< Contains every shadow map in the scene.
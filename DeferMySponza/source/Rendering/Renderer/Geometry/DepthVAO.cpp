@@ -0,0 +1,46 @@
+#include "DepthVAO.hpp"
+
+
+// Engine headers.
+#include <glm/vec3.hpp>
+
+
+void DepthVAO::configureAttributes (const bool compactVertices) noexcept
+{
+    // Enable each attribute.
+    vao.setAttributeStatus (positionAttributeIndex, true);
+    vao.setAttributeStatus (modelTransformAttributeIndex, modelTransformAttributeCount, true);
+
+    // Positions are the only per-vertex data.
+    vao.setAttributeBufferBinding (positionAttributeIndex, positionsBufferIndex);
+    
+    // Use static buffers by default for instance data.
+    useStaticBuffers();
+
+    // Compact positions are dequantised by the model transform, just like the scene VAO.
+    if (compactVertices)
+    {
+        vao.setAttributeFormat (positionAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                3, GL_UNSIGNED_SHORT, 0, GL_TRUE);
+    }
+
+    else
+    {
+        vao.setAttributeFormat (positionAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                3, GL_FLOAT, 0);
+    }
+
+    // The model transform must be added as multiple separate columns.
+    constexpr auto componentCount   = GLint { sizeof (glm::vec3) / sizeof (GLfloat) };
+    constexpr auto attributeStride  = GLuint { componentCount * sizeof (GLfloat) };
+    vao.setAttributeFormat (modelTransformAttributeIndex, modelTransformAttributeCount, attributeStride, 
+                            VertexArray::AttributeLayout::Float32, componentCount, GL_FLOAT, 0);
+}
+
+
+void DepthVAO::useStaticBuffers() noexcept
+{
+    // Model transforms are a 4x3 matrix.
+    vao.setAttributeBufferBinding (modelTransformAttributeIndex, modelTransformAttributeCount, 
+        staticTransformsBufferIndex);
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#if !defined    _RENDERING_RENDERER_GEOMETRY_DEPTH_VAO_
+#define         _RENDERING_RENDERER_GEOMETRY_DEPTH_VAO_
+
+// Personal headers.
+#include <Rendering/Objects/VertexArray.hpp>
+#include <Rendering/Renderer/Types.hpp>
+
+
+/// <summary> 
+/// A VAO used for depth-only passes over scene geometry, such as shadow mapping. Positions are read from a tightly 
+/// packed stream which parallels the interleaved scene vertices, so the same elements and draw commands can be used
+/// without fetching normals and texture co-ordinates. Attribute indices match SceneVAO so shaders work with either.
+/// </summary>
+struct DepthVAO final
+{
+    VertexArray vao { }; //!< A VAO containing the positions of all renderable meshes in the scene.
+
+    constexpr static auto positionsBufferIndex          = GLuint { 0 }; //!< The binding index where the position stream for all objects will be bound.
+    constexpr static auto staticTransformsBufferIndex   = GLuint { 1 }; //!< The binding index where the transform buffer for static objects will be bound.
+    constexpr static auto dynamicTransformsBufferIndex  = GLuint { 2 }; //!< The base binding index where the transform buffer for dynamic objects will start being bound.
+    
+    constexpr static auto positionAttributeIndex        = GLuint { 0 }; //!< The attribute index for vertex position.
+    constexpr static auto modelTransformAttributeIndex  = GLuint { 4 }; //!< The attribute index for instanced model transforms.
+
+    constexpr static auto modelTransformAttributeCount  = GLuint { sizeof (types::ModelTransform) / sizeof (glm::vec3) }; //!< The model transform requires multiple attributes.
+    
+
+    DepthVAO() noexcept                             = default;
+    DepthVAO (DepthVAO&&) noexcept                  = default;
+    DepthVAO (const DepthVAO&) noexcept             = default;
+    DepthVAO& operator= (const DepthVAO&) noexcept  = default;
+    DepthVAO& operator= (DepthVAO&&) noexcept       = default;
+    ~DepthVAO()                                     = default;
+
+
+    /// <summary> Attachs the given buffers to the VAO based on the compile-time indices in the class. </summary>
+    /// <param name="compactVertices"> Whether the position stream contains CompactPosition rather than floats. </param>
+    template <size_t MultiBuffering>
+    void attachVertexBuffers (const bool compactVertices, const Buffer& positions, const Buffer& elements, 
+        const Buffer& staticTransforms, const PersistentMappedBuffer<MultiBuffering>& dynamicTransforms) noexcept;
+
+    /// <summary> Sets the binding points and formatting of attributes in the VAO. </summary>
+    /// <param name="compactVertices"> Whether positions are quantised like CompactPosition. </param>
+    void configureAttributes (const bool compactVertices) noexcept;
+
+    /// <summary> Configures the instanced attributes to retrieve data from the static buffers. </summary>
+    void useStaticBuffers() noexcept;
+
+    /// <summary> Configures the instanced attributes to retrieve data from the dynamic buffers. </summary>
+    /// <param name="partition"> The partition of the dynamic buffers to use. </param>
+    template <size_t MultiBuffering>
+    void useDynamicBuffers (const size_t partition) noexcept;
+};
+
+
+// Personal headers.
+#include <Rendering/Composites/PersistentMappedBuffer.hpp>
+#include <Rendering/Renderer/Geometry/Internals/CompactVertex.hpp>
+
+
+template <size_t MultiBuffering>
+void DepthVAO::attachVertexBuffers (const bool compactVertices, const Buffer& positions, const Buffer& elements, 
+    const Buffer& staticTransforms, const PersistentMappedBuffer<MultiBuffering>& dynamicTransforms) noexcept
+{
+    // We need to calculate our strides.
+    const auto positionStride   = static_cast<GLuint> (compactVertices ? sizeof (CompactPosition) : sizeof (types::VertexPosition));
+    constexpr auto modelStride  = GLuint { sizeof (types::ModelTransform) };
+
+    // Instancing data contains one item per instance.
+    constexpr auto divisor = GLuint { 1 };
+
+    // Attach static buffers.
+    vao.attachVertexBuffer (positions, positionsBufferIndex, 0, positionStride);
+    vao.attachVertexBuffer (staticTransforms, staticTransformsBufferIndex, 0, modelStride, divisor);
+    vao.setElementBuffer (elements);
+
+    // Attach dynamic buffers.
+    vao.attachPersistentMappedBuffer (dynamicTransforms, dynamicTransformsBufferIndex, modelStride, divisor);
+}
+
+
+template <size_t MultiBuffering>
+void DepthVAO::useDynamicBuffers (const size_t partition) noexcept
+{
+    // Model transforms are a 4x3 matrix.
+    vao.setAttributeBufferBinding (modelTransformAttributeIndex, modelTransformAttributeCount,
+        static_cast<GLuint> (dynamicTransformsBufferIndex + partition));
+}
+
+#endif // _RENDERING_RENDERER_GEOMETRY_DEPTH_VAO_
\ No newline at end of file
@@ -3,7 +3,11 @@
 
 // STL headers.
 #include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <map>
+#include <tuple>
+#include <utility>
 
 
 // Engine headers.
@@ -12,17 +16,27 @@
 
 
 // Personal headers.
+#include <Rendering/Renderer/Geometry/Internals/CompactVertex.hpp>
 #include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
 #include <Rendering/Renderer/Materials/Materials.hpp>
 #include <Rendering/Renderer/Types.hpp>
+#include <Utility/Algorithm.hpp>
+#include <Utility/MeshSplitting.hpp>
 #include <Utility/Scene.hpp>
+#include <Utility/StartupTimeline.hpp>
 #include <Utility/TSL.hpp>
+#include <Utility/VertexQuantisation.hpp>
 
 
 // Namespace inclusions.
 using namespace types;
 
 
+// Constants.
+constexpr auto sceneFile        = "sponza_with_friends_2x.tcf";         //!< The scene file which geometry is loaded from.
+constexpr auto geometryPackFile = "sponza_with_friends_2x.geometry";    //!< Where baked scene geometry is stored.
+
+
 Geometry::Geometry() noexcept
 {
     try
@@ -37,7 +51,7 @@ Geometry::Geometry() noexcept
 }
 
 
-const Mesh& Geometry::operator[] (const scene::MeshId id) const noexcept
+const MeshLevels& Geometry::operator[] (const scene::MeshId id) const noexcept
 {
     return m_internals->sceneMeshes[id];
 }
@@ -45,12 +59,12 @@ const Mesh& Geometry::operator[] (const scene::MeshId id) const noexcept
 
 bool Geometry::isInitialised() const noexcept
 {
-    return m_scene.vao.isInitialised() && m_drawCommands.buffer.isInitialised() && m_triangle.vao.isInitialised() &&
+    return m_scene.vao.isInitialised() && m_depth.vao.isInitialised() && m_triangle.vao.isInitialised() && 
         m_lighting.vao.isInitialised() && m_internals->isInitialised();
 }
 
 
-const std::unordered_map<scene::MeshId, Mesh>& Geometry::getMeshes() const noexcept
+const Geometry::Meshes& Geometry::getMeshes() const noexcept
 {
     return m_internals->sceneMeshes;
 }
@@ -59,65 +73,297 @@ const std::unordered_map<scene::MeshId, Mesh>& Geometry::getMeshes() const noexc
 void Geometry::clean() noexcept
 {
      m_scene.vao.clean();
-     m_drawCommands.buffer.clean();
+     m_depth.vao.clean();
      m_triangle.vao.clean();
      m_lighting.vao.clean();
      m_internals->clean();
 
+     m_staticBatches.clear();
+     m_staticBounds.clear();
      m_quad = m_sphere = m_cone = Mesh { };
 }
 
 
-void Geometry::buildMeshData (Internals& internals) const noexcept
+GeometryPack Geometry::loadPack() noexcept
 {
-    // Begin to construct the scene. We take a copy of the meshes data so we can sort it.
-    auto meshes = scene::GeometryBuilder().getAllMeshes();
-
-    // Ensure the meshes are sorted in order of their ID.
-    std::sort (std::begin (meshes), std::end (meshes), 
-        [] (const auto& a, const auto& b) { return a.getId() < b.getId(); });
-
-    // We'll need a temporary vectors to store the vertex and element data. 
-    auto vertices       = std::vector<Vertex> { };
-    auto elements       = std::vector<Element> { };
-    auto vertexCount    = size_t { 0 };
-    auto elementCount   = size_t { 0 };
-
-    // Start by allocating enough memory in each container to store the scene.
-    util::calculateSceneSize (meshes, vertexCount, elementCount);
-    internals.sceneMeshes.reserve (meshes.size());
-    vertices.reserve (vertexCount);
-    elements.reserve (elementCount);
-
-    // Iterate through each mesh adding the vertices, elements and mapping to their corresponding container.
-    auto mesh           = Mesh { };
-    auto vertexIndex    = GLuint { 0 };
-    auto elementsIndex  = GLuint { 0 };
+    // Scene geometry is baked into a pack which can be mapped on successive runs. Stale packs will be rebaked.
+    auto pack = GeometryPack { };
     
-	for (const auto& sceneMesh : meshes)
-    {
-        // Retrieve the required mesh data.
-        const auto meshVertices     = util::assembleVertices (sceneMesh);
-        const auto& meshElements    = sceneMesh.getElementArray();
-        
-        // Set the mesh parameters, the element offset must be a pointer type.
-        mesh.verticesIndex  = vertexIndex;
-        mesh.elementsIndex  = elementsIndex;
-        mesh.elementCount   = static_cast<GLuint> (meshElements.size());
-
-        // Now we can add the mesh to the map and the vertices/elements to the vectors.
-        internals.sceneMeshes[sceneMesh.getId()] = mesh;
-        vertices.insert (std::end (vertices), std::begin (meshVertices), std::end (meshVertices));
-        elements.insert (std::end (elements), std::begin (meshElements), std::end (meshElements));
-
-        // The vertexIndex needs an actual index value whereas elementOffset needs to be in bytes.
-        vertexIndex     += static_cast<GLuint> (meshVertices.size());
-        elementsIndex   += mesh.elementCount;
+    if (!pack.initialise (geometryPackFile, sceneFile))
+    {
+        // The builder shares the scene file data which is cached for the entire process so we only need to sort
+        // pointers to each mesh instead of copying every vertex.
+        const auto builder  = scene::GeometryBuilder { };
+        const auto& meshes  = builder.getAllMeshes();
+        auto sortedMeshes   = std::vector<const scene::Mesh*> { };
+
+        // Ensure the meshes are sorted in order of their ID.
+        sortedMeshes.reserve (meshes.size());
+        for (const auto& mesh : meshes)
+        {
+            sortedMeshes.push_back (&mesh);
+        }
+
+        std::sort (std::begin (sortedMeshes), std::end (sortedMeshes), 
+            [] (const auto a, const auto b) { return a->getId() < b->getId(); });
+
+        if (!pack.bake (sortedMeshes, geometryPackFile, sceneFile))
+        {
+            std::cerr << "Geometry::loadPack(): Unable to bake the scene geometry." << std::endl;
+            pack.clean();
+        }
+    }
+
+    return pack;
+}
+
+
+bool Geometry::buildMeshData (Internals& internals, const GeometryPack& pack, UploadQueue& uploads, 
+    const bool compactVertices) const noexcept
+{
+    const StartupTimeline::Scope step { "Geometry::buildMeshData" };
+
+    const auto& header  = pack.getHeader();
+    const auto records  = pack.getMeshes();
+    auto meshes         = std::vector<Mesh> { };
+    auto compacted      = std::vector<CompactVertex> { };
+
+    meshes.reserve (header.meshCount);
+    for (size_t i { 0 }; i < header.meshCount; ++i)
+    {
+        meshes.push_back (records[i].toMesh());
+    }
+
+    // Compact vertices are quantised across the bounds of the vertex range they belong to. Identical meshes share a
+    // range so each range only needs encoding once, it ends where the next range starts.
+    if (compactVertices)
+    {
+        auto ranges = std::map<GLuint, size_t> { };
+        for (size_t i { 0 }; i < header.meshCount; ++i)
+        {
+            ranges.emplace (records[i].verticesIndex, i);
+        }
+
+        auto starts = std::vector<std::pair<GLuint, size_t>> (std::begin (ranges), std::end (ranges));
+        auto errors = std::vector<util::QuantisationError> (starts.size());
+        compacted.resize (header.vertexCount);
+
+        util::parallelFor (starts.size(), [&] (const size_t i)
+        {
+            const auto first    = static_cast<size_t> (starts[i].first);
+            const auto last     = i + 1 < starts.size() ? static_cast<size_t> (starts[i + 1].first) 
+                : static_cast<size_t> (header.vertexCount);
+            const auto& record  = records[starts[i].second];
+
+            auto offset = glm::vec3 { 0.f };
+            auto scale  = glm::vec3 { 1.f };
+            util::calculateQuantisation (record.min, record.max, offset, scale);
+            
+            errors[i] = util::compactVertices (pack.getVertices() + first, last - first, offset, scale, 
+                compacted.data() + first);
+        });
+
+        // Every mesh using a range needs to know how to dequantise it.
+        for (auto& mesh : meshes)
+        {
+            const auto& record = records[ranges[mesh.verticesIndex]];
+            util::calculateQuantisation (record.min, record.max, mesh.positionOffset, mesh.positionScale);
+        }
+
+        auto total = util::QuantisationError { };
+        for (const auto& error : errors)
+        {
+            total.merge (error);
+        }
+
+        std::cout << "Geometry::buildMeshData(): Compacted " << total.vertices << " vertices from " 
+            << total.vertices * sizeof (Vertex) << " to " << total.vertices * sizeof (CompactVertex) << " bytes."
+            << " Maximum error: position " << total.position << ", normal " << total.normalDegrees 
+            << " degrees, texture point " << total.texturePoint << "." << std::endl;
+    }
+
+    // Levels of detail are narrowed like any other mesh, they only differ from their mesh by their elements.
+    auto levelMeshes    = std::vector<Mesh> { };
+    auto firstLevels    = std::vector<size_t> { };
+
+    for (size_t i { 0 }; i < header.meshCount; ++i)
+    {
+        firstLevels.push_back (levelMeshes.size());
+        levelMeshes.push_back (meshes[i]);
+
+        for (size_t l { 0 }; l < records[i].levelCount; ++l)
+        {
+            auto level          = meshes[i];
+            level.elementsIndex = records[i].levels[l].elementsIndex;
+            level.elementCount  = records[i].levels[l].elementCount;
+            levelMeshes.push_back (level);
+        }
+    }
+
+    // Add the parts of each level to the map.
+    auto parts          = std::vector<MeshParts> { };
+    const auto elements = narrowElements (pack, levelMeshes, parts);
+
+    internals.sceneMeshes.reserve (header.meshCount);
+    for (size_t i { 0 }; i < header.meshCount; ++i)
+    {
+        const auto& record  = records[i];
+        auto mesh           = MeshLevels { };
+        mesh.centre         = (record.min + record.max) / 2.f;
+        mesh.radius         = glm::length (record.max - record.min) / 2.f;
+
+        for (size_t l { 0 }; l <= record.levelCount; ++l)
+        {
+            mesh.levels.push_back (std::move (parts[firstLevels[i] + l]));
+            mesh.errors.push_back (l > 0 ? record.levels[l - 1].error : 0.f);
+        }
+
+        // A mesh without elements has no parts, it shouldn't appear to have anything to draw.
+        if (mesh.levels.front().empty())
+        {
+            mesh.levels.clear();
+            mesh.errors.clear();
+        }
+
+        internals.sceneMeshes.set (record.id, std::move (mesh));
+    }
+
+    // The buffers are left with no access flags so they can be static. When possible the pack is staged through
+    // the upload ring so the driver doesn't need to make its own copy of the entire pack.
+    const auto fill = [&] (Buffer& buffer, const GLsizeiptr size, const void* data)
+    {
+        if (!uploads.isInitialised())
+        {
+            buffer.immutablyFillWith (size, data);
+            return true;
+        }
+
+        buffer.allocateImmutableStorage (size, 0);
+        if (!uploads.upload (buffer.getID(), 0, size, data))
+        {
+            // Chunks which were staged must be issued whilst the buffer still exists.
+            uploads.process();
+            std::cerr << "Geometry::buildMeshData(): Unable to stage scene geometry." << std::endl;
+            return false;
+        }
+
+        return true;
+    };
+
+    // Depth-only passes read positions from their own stream so they don't fetch the rest of each vertex.
+    if (compactVertices)
+    {
+        auto positions = std::vector<CompactPosition> (compacted.size());
+        std::transform (std::begin (compacted), std::end (compacted), std::begin (positions),
+            [] (const CompactVertex& vertex) { return CompactPosition { vertex.position, vertex.padding }; });
+
+        if (!fill (internals.buffers[internals.sceneVerticesIndex], 
+                static_cast<GLsizeiptr> (compacted.size() * sizeof (CompactVertex)), compacted.data()) ||
+            !fill (internals.buffers[internals.scenePositionsIndex], 
+                static_cast<GLsizeiptr> (positions.size() * sizeof (CompactPosition)), positions.data()))
+        {
+            return false;
+        }
+    }
+
+    else
+    {
+        const auto vertices = pack.getVertices();
+        auto positions      = std::vector<VertexPosition> (header.vertexCount);
+        std::transform (vertices, vertices + header.vertexCount, std::begin (positions),
+            [] (const Vertex& vertex) { return vertex.position; });
+
+        if (!fill (internals.buffers[internals.sceneVerticesIndex], 
+                static_cast<GLsizeiptr> (header.vertexCount * sizeof (Vertex)), vertices) ||
+            !fill (internals.buffers[internals.scenePositionsIndex], 
+                static_cast<GLsizeiptr> (positions.size() * sizeof (VertexPosition)), positions.data()))
+        {
+            return false;
+        }
+    }
+
+    return fill (internals.buffers[internals.sceneElementsIndex], 
+        static_cast<GLsizeiptr> (elements.size() * sizeof (GLushort)), elements.data());
+}
+
+
+std::vector<GLushort> Geometry::narrowElements (const GeometryPack& pack, const std::vector<Mesh>& meshes, 
+    std::vector<MeshParts>& parts) const noexcept
+{
+    const StartupTimeline::Scope step { "Geometry::narrowElements" };
+
+    // Identical meshes share their elements so each range of elements only needs splitting once.
+    const auto elements = pack.getElements();
+    auto uniqueRanges   = std::map<GLuint, size_t> { };
+    auto firstMeshes    = std::vector<size_t> { };
+
+    for (size_t i { 0 }; i < meshes.size(); ++i)
+    {
+        if (uniqueRanges.emplace (meshes[i].elementsIndex, firstMeshes.size()).second)
+        {
+            firstMeshes.push_back (i);
+        }
+    }
+
+    auto splits = std::vector<util::SplitElements> (firstMeshes.size());
+    util::parallelFor (firstMeshes.size(), [&] (const size_t i)
+    {
+        const auto& mesh    = meshes[firstMeshes[i]];
+        splits[i]           = util::splitForShortElements (elements + mesh.elementsIndex, mesh.elementCount);
+    });
+
+    // Every 16-bit element is stored first, 32-bit elements then start on the next four byte boundary.
+    auto shortStarts    = std::vector<size_t> (splits.size());
+    auto wideStarts     = std::vector<size_t> (splits.size());
+    auto shortCount     = size_t { 0 };
+    auto wideCount      = size_t { 0 };
+    auto splitMeshes    = size_t { 0 };
+
+    for (size_t i { 0 }; i < splits.size(); ++i)
+    {
+        shortStarts[i]  = shortCount;
+        wideStarts[i]   = wideCount;
+        shortCount      += splits[i].shortElements.size();
+        wideCount       += splits[i].wideElements.size();
+        splitMeshes     += splits[i].ranges.size() > 1 ? 1 : 0;
     }
 
-    // Now we can fill the mesh and element buffer. We will leave them with no access flags so they can be static.
-    internals.buffers[internals.sceneVerticesIndex].immutablyFillWith (vertices);
-    internals.buffers[internals.sceneElementsIndex].immutablyFillWith (elements);
+    const auto wideOffset   = (shortCount + 1) / 2;
+    auto buffer             = std::vector<GLushort> ((wideOffset + wideCount) * 2);
+
+    for (size_t i { 0 }; i < splits.size(); ++i)
+    {
+        const auto& split = splits[i];
+        std::copy (std::begin (split.shortElements), std::end (split.shortElements), 
+            std::begin (buffer) + shortStarts[i]);
+        std::memcpy (buffer.data() + (wideOffset + wideStarts[i]) * 2, split.wideElements.data(), 
+            split.wideElements.size() * sizeof (GLuint));
+    }
+
+    // Each part is drawn with the 16-bit or 32-bit index of its first element.
+    parts.resize (meshes.size());
+    for (size_t i { 0 }; i < meshes.size(); ++i)
+    {
+        const auto index = uniqueRanges[meshes[i].elementsIndex];
+        for (const auto& range : splits[index].ranges)
+        {
+            auto part           = meshes[i];
+            part.verticesIndex  += range.baseVertex;
+            part.elementsIndex  = static_cast<GLuint> (range.isShort ? 
+                shortStarts[index] + range.first : wideOffset + wideStarts[index] + range.first);
+            part.elementCount   = static_cast<GLuint> (range.count);
+            part.elementType    = range.isShort ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+            parts[i].push_back (part);
+        }
+    }
+
+    const auto& header = pack.getHeader();
+    std::cout << "Geometry::narrowElements(): Narrowed " << header.elementCount << " elements from " 
+        << header.elementCount * sizeof (Element) << " to " << buffer.size() * sizeof (GLushort) << " bytes. " 
+        << splitMeshes << " meshes were split and " << wideCount / 3 << " triangles kept 32-bit elements." 
+        << std::endl;
+
+    return buffer;
 }
 
 
@@ -178,53 +424,75 @@ void Geometry::buildLighting (Internals& internals, Mesh& quad, Mesh& sphere, Me
 }
 
 
-void Geometry::fillStaticBuffers (Internals& internals, DrawCommands& drawCommands, const Materials& materials,
-            const std::map<scene::MeshId, std::vector<scene::Instance>>& staticInstances) const noexcept
+void Geometry::fillStaticBuffers (Internals& internals, StaticBatches& batches, StaticBounds& bounds, 
+    const Materials& materials, 
+    const std::map<scene::MeshId, std::vector<scene::Instance>>& staticInstances) const noexcept
 {
+    const StartupTimeline::Scope step { "Geometry::fillStaticBuffers" };
+
+    // Meshes with identical data share the same parts of the vertex and element buffers. The instances of each are
+    // merged so that every unique mesh only needs a single batch. The map keeps the batches in buffer order, meshes 
+    // without any elements are skipped.
+    using Range = std::tuple<GLuint, GLuint, GLuint>;
+    using Batch = std::pair<const MeshLevels*, std::vector<const scene::Instance*>>;
+    auto sharedMeshes = std::map<Range, Batch> { };
+
+    for (const auto& meshInstancePair : staticInstances)
+    {
+        const auto& mesh = internals.sceneMeshes[meshInstancePair.first];
+        if (mesh.empty())
+        {
+            continue;
+        }
+
+        const auto& part    = mesh.front();
+        auto& batch         = sharedMeshes[Range { part.elementsIndex, part.verticesIndex, part.elementCount }];
+
+        batch.first = &mesh;
+        batch.second.reserve (batch.second.size() + meshInstancePair.second.size());
+        for (const auto& instance : meshInstancePair.second)
+        {
+            batch.second.push_back (&instance);
+        }
+    }
+
     // We'll need vectors to store each piece of data that needs buffering.
-    auto commands       = std::vector<MultiDrawElementsIndirectCommand> { };
     auto materialIDs    = std::vector<MaterialID> { };
     auto transforms     = std::vector<ModelTransform> { };
 
-    // We can immediately reserve enough memory for the draw commands.
-    commands.reserve (staticInstances.size());
+    // We can immediately reserve enough memory for the batches.
+    batches.clear();
+    bounds.clear();
+    batches.reserve (sharedMeshes.size());
 
-    // Now we can interate through each mesh collecting instancing data.
-    for (const auto& meshInstancePair : staticInstances)
+    // Now we can interate through each batch collecting instancing data.
+    for (const auto& sharedMesh : sharedMeshes)
     {
         // Cache each component
-        const auto meshID       = meshInstancePair.first;
-        const auto& instances   = meshInstancePair.second;
+        const auto& mesh        = *sharedMesh.second.first;
+        const auto& instances   = sharedMesh.second.second;
 
         // Speed things up by reserving enough space.
         const auto capacity = materialIDs.size() + instances.size();
         materialIDs.reserve (capacity);
         transforms.reserve (capacity);
+        bounds.reserve (capacity);
 
-        // Add the draw command.
-        const auto mesh = internals.sceneMeshes[meshID];
-        commands.emplace_back (
-            mesh.elementCount,
-            static_cast<GLuint> (instances.size()),
-            mesh.elementsIndex,
-            mesh.verticesIndex,
-            static_cast<GLuint> (materialIDs.size())
-        );
+        // Every instance in the batch is stored contiguously so they can share draw commands.
+        batches.push_back ({ &mesh, static_cast<GLuint> (materialIDs.size()), static_cast<GLuint> (instances.size()) });
 
         // Now collect the instancing data.
-        for (const auto& instance : meshInstancePair.second)
+        for (const auto instance : instances)
         {
-            materialIDs.push_back (materials[instance.getMaterialId()]);
-            transforms.push_back (util::toGLM (instance.getTransformationMatrix()));
+            const auto model = util::toGLM (instance->getTransformationMatrix());
+
+            materialIDs.push_back (materials[instance->getMaterialId()]);
+            transforms.push_back (mesh.front().dequantise (model));
+            bounds.push_back (mesh.bounds (model));
         }
     }
 
-    // Prepare the draw commands objects.
-    drawCommands.count      = static_cast<GLsizei> (commands.size());
-    drawCommands.capacity   = drawCommands.count;
-
     // Finally fill the buffers.
-    drawCommands.buffer.immutablyFillWith (commands);
     internals.buffers[internals.materialIDsIndex].immutablyFillWith (materialIDs);
     internals.buffers[internals.transformsIndex].immutablyFillWith (transforms);
-}
\ No newline at end of file
+}
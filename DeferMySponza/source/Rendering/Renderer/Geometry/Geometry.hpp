@@ -6,7 +6,6 @@
 // STL headers.
 #include <map>
 #include <memory>
-#include <unordered_map>
 #include <vector>
 
 
@@ -16,11 +15,16 @@
 
 // Personal headers.
 #include <Rendering/Composites/DrawCommands.hpp>
+#include <Rendering/Composites/UploadQueue.hpp>
 #include <Rendering/Objects/Buffer.hpp>
+#include <Rendering/Renderer/Geometry/GeometryPack.hpp>
 #include <Rendering/Renderer/Geometry/Mesh.hpp>
+#include <Rendering/Renderer/Geometry/MeshLevels.hpp>
+#include <Rendering/Renderer/Geometry/DepthVAO.hpp>
 #include <Rendering/Renderer/Geometry/FullScreenTriangleVAO.hpp>
 #include <Rendering/Renderer/Geometry/SceneVAO.hpp>
 #include <Rendering/Renderer/Geometry/LightingVAO.hpp>
+#include <Utility/DenseIDMap.hpp>
 
 
 // Forward declarations.
@@ -29,14 +33,26 @@ class Materials;
 
 /// <summary>
 /// Contains every piece of geometry in the scene. Static batching is supported with static instances having their
-/// transforms permanently stored in the transforms buffer.
+/// transforms permanently stored in the transforms buffer. The instances of each static batch are contiguous so their
+/// draw commands can be built each frame with a level of detail selected for every instance.
 /// </summary>
 class Geometry final
 {
     public:
 
+        /// <summary> Static instances of a mesh which are stored contiguously in the static instancing buffers. </summary>
+        struct StaticBatch final
+        {
+            const MeshLevels*   mesh            { nullptr };    //!< The mesh every instance in the batch draws.
+            GLuint              baseInstance    { 0 };          //!< The first instance of the batch.
+            GLuint              instanceCount   { 0 };          //!< How many instances the batch contains.
+        };
+
         // Aliases.
-        using DrawCommands = MultiDrawCommands<Buffer>;
+        using MeshParts     = MeshLevels::Parts;
+        using Meshes        = DenseIDMap<scene::MeshId, MeshLevels>;
+        using StaticBatches = std::vector<StaticBatch>;
+        using StaticBounds  = std::vector<InstanceBounds>;
 
     public:
 
@@ -49,15 +65,20 @@ class Geometry final
         Geometry& operator= (const Geometry&)       = delete;
 
 
-        /// <summary> Maps the given mesh ID to a stored mesh. </summary>
+        /// <summary> 
+        /// Maps the given mesh ID to the levels of detail of a stored mesh, dense meshes have simplified levels. Each 
+        /// level has parts, most have a single part but those with too many vertices for 16-bit elements are split 
+        /// into a part for each range of vertices a 16-bit element can reach. Every part shares the vertex 
+        /// dequantisation of the mesh.
+        /// </summary>
         /// <param name="id"> The scene ID of the mesh to retrieve data for. </param>
-        const Mesh& operator[] (const scene::MeshId id) const noexcept;
+        const MeshLevels& operator[] (const scene::MeshId id) const noexcept;
 
         /// <summary> Checks whether the object is initialised or not. </summary>
         bool isInitialised() const noexcept;
 
         /// <summary> Retrieves a map, containing every constructed mesh with an associated ID. </summary>
-        const std::unordered_map<scene::MeshId, Mesh>& getMeshes() const noexcept;
+        const Meshes& getMeshes() const noexcept;
         
         /// <summary> Gets the vertex array object containing scene geometric data. </summary>
         inline const SceneVAO& getSceneVAO() const noexcept                     { return m_scene; }
@@ -65,6 +86,12 @@ class Geometry final
         /// <summary> Gets the vertex array object containing scene geometric data. </summary>
         inline SceneVAO& getSceneVAO() noexcept                                 { return m_scene; }
 
+        /// <summary> Gets the vertex array object containing scene positions for depth-only passes. </summary>
+        inline const DepthVAO& getDepthVAO() const noexcept                     { return m_depth; }
+        
+        /// <summary> Gets the vertex array object containing scene positions for depth-only passes. </summary>
+        inline DepthVAO& getDepthVAO() noexcept                                 { return m_depth; }
+
         /// <summary> Gets the vertex array object containing light volume data. </summary>
         inline const FullScreenTriangleVAO& getTriangleVAO() const noexcept     { return m_triangle; }
 
@@ -74,8 +101,11 @@ class Geometry final
         /// <summary> Gets the vertex array object containing light volume data. </summary>
         inline LightingVAO& getLightingVAO() noexcept                           { return m_lighting; }
 
-        /// <summary> Retrieves the command buffer filled with commands to draw static geometry. </summary>
-        inline const DrawCommands& getStaticGeometryCommands() const noexcept   { return m_drawCommands; }
+        /// <summary> Gets every static batch, in the order their instances are stored. </summary>
+        inline const StaticBatches& getStaticBatches() const noexcept           { return m_staticBatches; }
+
+        /// <summary> Gets the world-space bounds of every static instance, in the order they're stored. </summary>
+        inline const StaticBounds& getStaticBounds() const noexcept             { return m_staticBounds; }
 
         /// <summary> Gets the mesh data required to draw a quad. </summary>
         inline const Mesh& getQuad() const noexcept                             { return m_quad; }
@@ -87,12 +117,22 @@ class Geometry final
         inline const Mesh& getCone() const noexcept                             { return m_cone; }
 
 
+        /// <summary>
+        /// Maps the baked scene geometry, baking it from scene::GeometryBuilder if the pack doesn't exist or is out of
+        /// date. No OpenGL calls are made so this may be called on a worker thread.
+        /// </summary>
+        /// <returns> The pack to pass to initialise(), this will be uninitialised on failure. </returns>
+        static GeometryPack loadPack() noexcept;
+
         /// <summary> 
-        /// Constructs geometry from scene::GeometryBuilder class as well and building the required shapes to perform
+        /// Constructs geometry from a GeometryPack as well as building the required shapes to perform
         /// deferred lighting. Along with this, VAOs within the scene are built and static object optimisation is
-        /// performed by creating instancing buffers for static objects and by creating draw calls for indirect
-        /// rendering. Successive calls will not change the object unless initialisation is successful.
+        /// performed by creating instancing buffers for static objects and batching instances which share a mesh.
+        /// Successive calls will not change the object unless initialisation is successful.
         /// </summary>
+        /// <param name="pack"> The scene geometry to upload, as returned by loadPack(). </param>
+        /// <param name="uploads"> The queue to stage scene geometry through, it's uploaded directly if uninitialised. </param>
+        /// <param name="compactVertices"> Whether scene vertices should be quantised into CompactVertex. </param>
         /// <param name="materials"> The object containing material information. </param>
         /// <param name="staticInstances"> Contains every static instance which will be loaded into memory. </param> 
         /// <param name="dynamicMaterialIDs"> The buffer to use for the material IDs of dynamic objects. </param>
@@ -100,7 +140,8 @@ class Geometry final
         /// <param name="lightingTransforms"> The buffer to use for the model transforms of light volumes. </param>
         /// <returns> Whether initialisation was successful or not. </returns>
         template <size_t MaterialIDPartitions, size_t TransformPartitions, size_t LightingPartitions>
-        bool initialise (const Materials& materials, 
+        bool initialise (const GeometryPack& pack, UploadQueue& uploads, const bool compactVertices, 
+            const Materials& materials, 
             const std::map<scene::MeshId, std::vector<scene::Instance>>& staticInstances,
             const PersistentMappedBuffer<MaterialIDPartitions>& dynamicMaterialIDs, 
             const PersistentMappedBuffer<TransformPartitions>& dynamicTransforms,
@@ -115,7 +156,9 @@ class Geometry final
         using Pimpl = std::unique_ptr<Internals>;
 
         SceneVAO                m_scene         { };    //!< Used for drawing all scene geometry.
-        DrawCommands            m_drawCommands  { };    //!< Contains the drawing commands to indirectly render every static object in the scene.
+        DepthVAO                m_depth         { };    //!< Used for drawing the positions of scene geometry in depth-only passes.
+        StaticBatches           m_staticBatches { };    //!< The batches of static instances which share a mesh.
+        StaticBounds            m_staticBounds  { };    //!< The world-space bounds of every static instance.
 
         FullScreenTriangleVAO   m_triangle      { };    //!< An oversized triangle vertex array which can be used to apply post-processing.
         
@@ -129,7 +172,9 @@ class Geometry final
     private:
 
         /// <summary> Configures the given vertex array objects for storing scene and lighting geometry. </summary>
+        /// <param name="compactVertices"> Whether the scene vertex buffer contains CompactVertex. </param>
         /// <param name="scene"> The VAO to use for scene geometry. </param>
+        /// <param name="depth"> The VAO to use for depth-only scene geometry. </param>
         /// <param name="triangle"> The VAO to use for oversized triangles. </param>
         /// <param name="lighting"> The VAO to use for lighting. </param>
         /// <param name="internals"> The object containing static buffers that need to be attached. </param>
@@ -137,16 +182,36 @@ class Geometry final
         /// <param name="dynamicTransforms"> The PMB containing model transforms for dynamic object instances. </param>
         /// <param name="lightingTransforms"> The PMB containing transforms for all lighting instances. </param>
         template <typename MaterialIDPMB, typename TransformPMB, typename LightingPMB>
-        void configureVAOs (SceneVAO& scene, FullScreenTriangleVAO& triangle, LightingVAO& lighting, 
+        void configureVAOs (const bool compactVertices, SceneVAO& scene, DepthVAO& depth, 
+            FullScreenTriangleVAO& triangle, LightingVAO& lighting, 
             const Internals& internals, const MaterialIDPMB& dynamicMaterialIDs, const TransformPMB& dynamicTransforms, 
             const LightingPMB& lightingTransforms) const noexcept;
 
         /// <summary> 
-        /// Fills the mesh vertex and elements data in the given Internals object with data retrieved contained by
-        /// scene::GeometryBuilder. Data will be stored by the GPU in scene::MeshId order.
+        /// Fills the mesh vertex and elements data in the given Internals object with data from a baked GeometryPack.
+        /// Data will be stored by the GPU in scene::MeshId order. Compact vertices are quantised across the bounds of
+        /// their mesh and the encoding error is reported. Positions are also copied into their own stream in the same
+        /// order for depth-only passes. Elements are narrowed to 16 bits, splitting meshes into parts where necessary,
+        /// with any 32-bit elements stored after every 16-bit element. Each level of detail is narrowed separately.
         /// </summary>
         /// <param name="internals"> Where the data should be stored. </param>
-        void buildMeshData (Internals& internals) const noexcept;
+        /// <param name="pack"> The initialised pack containing every mesh. </param>
+        /// <param name="uploads"> The queue to copy the vertices and elements through. </param>
+        /// <param name="compactVertices"> Whether the vertices should be quantised into CompactVertex. </param>
+        /// <returns> Whether every buffer was filled, their storage can't be filled again if staging fails. </returns>
+        bool buildMeshData (Internals& internals, const GeometryPack& pack, UploadQueue& uploads, 
+            const bool compactVertices) const noexcept;
+
+        /// <summary> 
+        /// Narrows the elements of every mesh to 16 bits, splitting meshes whose vertices can't all be reached from a 
+        /// single base vertex into multiple parts. Triangles which can't be narrowed keep 32-bit elements.
+        /// </summary>
+        /// <param name="pack"> The pack containing the original 32-bit elements. </param>
+        /// <param name="meshes"> The meshes to narrow, each part will be a copy of its mesh. </param>
+        /// <param name="parts"> Outputs the parts of each mesh, in the same order as the meshes. </param>
+        /// <returns> The element buffer, every 16-bit element followed by 32-bit elements aligned to four bytes. </returns>
+        std::vector<GLushort> narrowElements (const GeometryPack& pack, const std::vector<Mesh>& meshes, 
+            std::vector<MeshParts>& parts) const noexcept;
 
         /// <summary> Constructs an oversized full-screen triangle, useful for full-screen shading. </summary>
         void buildFullScreenTriangle (Internals& internals) const noexcept;
@@ -162,13 +227,17 @@ class Geometry final
         void buildLighting (Internals& internals, Mesh& quad, Mesh& sphere, Mesh& cone) const noexcept;
 
         /// <summary> 
-        /// Fills the static instancing and draw command buffers with data to draw every static object in the scene.
+        /// Fills the static instancing buffers with data to draw every static object in the scene. Instances of 
+        /// duplicate meshes which alias the same geometry are merged into a single batch so they can share draw
+        /// commands. The bounds of each instance are calculated for selecting its level of detail.
         /// </summary>
         /// <param name="internals"> Where the static buffers are stored. </param>
-        /// <param name="drawCommands"> Where the list of indirect draw commands should be stored. </param>
+        /// <param name="batches"> Where the batches of static instances should be stored. </param>
+        /// <param name="bounds"> Where the world-space bounds of every static instance should be stored. </param>
         /// <param name="materials"> Material information for the material ID buffer. </param>
         /// <param name="instances"> Each instance that will be added to the static buffers. </param>
-        void fillStaticBuffers (Internals& internals, DrawCommands& drawCommands, const Materials& materials,
+        void fillStaticBuffers (Internals& internals, StaticBatches& batches, StaticBounds& bounds, 
+            const Materials& materials, 
             const std::map<scene::MeshId, std::vector<scene::Instance>>& instances) const noexcept;
 };
 
@@ -178,7 +247,8 @@ class Geometry final
 
 
 template <size_t MaterialIDPartitions, size_t TransformPartitions, size_t LightingPartitions>
-bool Geometry::initialise (const Materials& materials, 
+bool Geometry::initialise (const GeometryPack& pack, UploadQueue& uploads, const bool compactVertices, 
+    const Materials& materials, 
     const std::map<scene::MeshId, std::vector<scene::Instance>>& staticInstances,
     const PersistentMappedBuffer<MaterialIDPartitions>& dynamicMaterialIDs,
     const PersistentMappedBuffer<TransformPartitions>& dynamicTransforms,
@@ -186,7 +256,9 @@ bool Geometry::initialise (const Materials& materials,
 {
     // We need to create replacement objects to initialise.
     auto scene          = SceneVAO { };
-    auto drawCommands   = DrawCommands { };
+    auto depth          = DepthVAO { };
+    auto staticBatches  = StaticBatches { };
+    auto staticBounds   = StaticBounds { };
     auto triangle       = FullScreenTriangleVAO { };
     auto lighting       = LightingVAO { };
     auto quad           = Mesh { };
@@ -194,27 +266,40 @@ bool Geometry::initialise (const Materials& materials,
     auto cone           = Mesh { };
     auto internals      = std::make_unique<Internals>();
 
+    // We can't do anything without the scene geometry.
+    if (!pack.isInitialised())
+    {
+        return false;
+    }
+
     // Initialise each object.
-    if (!(scene.vao.initialise() && drawCommands.buffer.initialise() && triangle.vao.initialise() && 
+    if (!(scene.vao.initialise() && depth.vao.initialise() && triangle.vao.initialise() && 
         lighting.vao.initialise() && internals->initialise()))
     {
         return false;
     }
 
     // Start by configuring the VAOs.
-    configureVAOs (scene, triangle, lighting, *internals, dynamicMaterialIDs, dynamicTransforms, lightingTransforms);
+    configureVAOs (compactVertices, scene, depth, triangle, lighting, *internals, dynamicMaterialIDs, 
+        dynamicTransforms, lightingTransforms);
 
     // Construct the required geometry.
-    buildMeshData (*internals);
+    if (!buildMeshData (*internals, pack, uploads, compactVertices))
+    {
+        return false;
+    }
+
     buildFullScreenTriangle (*internals);
     buildLighting (*internals, quad, sphere, cone);
 
-    // Allow for static batching by filling the static buffers with instance information and draw commands.
-    fillStaticBuffers (*internals, drawCommands, materials, staticInstances);
+    // Allow for static batching by filling the static buffers with instance information.
+    fillStaticBuffers (*internals, staticBatches, staticBounds, materials, staticInstances);
 
     // Finally we can make use of the successfully created data.
     m_scene         = std::move (scene);
-    m_drawCommands  = std::move (drawCommands);
+    m_depth         = std::move (depth);
+    m_staticBatches = std::move (staticBatches);
+    m_staticBounds  = std::move (staticBounds);
     m_triangle      = std::move (triangle);
     m_lighting      = std::move (lighting);
     m_quad          = std::move (quad);
@@ -227,11 +312,13 @@ bool Geometry::initialise (const Materials& materials,
 
 
 template <typename MaterialIDPMB, typename TransformPMB, typename LightingPMB>
-void Geometry::configureVAOs (SceneVAO& scene, FullScreenTriangleVAO& triangle, LightingVAO& lighting, 
+void Geometry::configureVAOs (const bool compactVertices, SceneVAO& scene, DepthVAO& depth, 
+    FullScreenTriangleVAO& triangle, LightingVAO& lighting, 
     const Internals& internals, const MaterialIDPMB& dynamicMaterialIDs, const TransformPMB& dynamicTransforms, 
     const LightingPMB& lightingTransforms) const noexcept
 {
     scene.attachVertexBuffers (
+        compactVertices,
         internals.buffers[Internals::sceneVerticesIndex],
         internals.buffers[Internals::sceneElementsIndex],
         internals.buffers[Internals::transformsIndex],
@@ -240,6 +327,14 @@ void Geometry::configureVAOs (SceneVAO& scene, FullScreenTriangleVAO& triangle,
         dynamicTransforms
     );
 
+    depth.attachVertexBuffers (
+        compactVertices,
+        internals.buffers[Internals::scenePositionsIndex],
+        internals.buffers[Internals::sceneElementsIndex],
+        internals.buffers[Internals::transformsIndex],
+        dynamicTransforms
+    );
+
     triangle.attachVertexBuffers (
         internals.buffers[Internals::triangleVerticesIndex]
     );
@@ -250,7 +345,8 @@ void Geometry::configureVAOs (SceneVAO& scene, FullScreenTriangleVAO& triangle,
         lightingTransforms
     );
 
-    scene.configureAttributes();
+    scene.configureAttributes (compactVertices);
+    depth.configureAttributes (compactVertices);
     triangle.configureAttributes();
     lighting.configureAttributes();
 }
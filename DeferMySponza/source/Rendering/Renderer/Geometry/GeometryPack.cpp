@@ -0,0 +1,498 @@
+#include "GeometryPack.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+
+// Engine headers.
+#include <glm/common.hpp>
+#include <scene/scene.hpp>
+
+
+// Personal headers.
+#include <Utility/Algorithm.hpp>
+#include <Utility/MeshOptimisation.hpp>
+#include <Utility/MeshSimplification.hpp>
+#include <Utility/Scene.hpp>
+
+
+// Namespaces.
+using namespace types;
+
+
+namespace
+{
+    constexpr auto magic        = std::array<char, 4> { 'D', 'M', 'G', 'P' };   //!< The identifier at the start of each pack.
+    constexpr auto alignment    = size_t { 16 };                                //!< Every region of the pack is aligned to this.
+    constexpr auto minTriangles = size_t { 4096 };                              //!< Meshes with fewer triangles don't have levels of detail.
+    constexpr auto maxLODError  = 0.05f;                                        //!< The largest level of detail error, relative to the bounding box diagonal.
+
+    static_assert (std::is_trivially_copyable<GeometryPack::Header>::value, "Pack headers must be trivially copyable.");
+    static_assert (std::is_trivially_copyable<GeometryPack::MeshRecord>::value, "Mesh records must be trivially copyable.");
+    static_assert (std::is_trivially_copyable<Vertex>::value, "Vertices must be trivially copyable.");
+
+
+    /// <summary> Rounds the given offset up to the alignment of each pack region. </summary>
+    inline size_t align (const size_t offset) noexcept
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+
+    /// <summary> 
+    /// Retrieves the size and a 64-bit FNV-1a hash of the file at the given location. Both will be zero if the file
+    /// can't be read. Edits which don't change the size of the file still change the hash.
+    /// </summary>
+    void identifySource (const std::string& fileLocation, std::uint64_t& size, std::uint64_t& hash) noexcept
+    {
+        size = hash = 0;
+
+        auto file = MappedFile { };
+        if (!file.initialise (fileLocation))
+        {
+            return;
+        }
+
+        const auto bytes    = reinterpret_cast<const std::uint8_t*> (file.getData());
+        size                = file.getSize();
+        hash                = 14695981039346656037ULL;
+
+        for (size_t i { 0 }; i < file.getSize(); ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    }
+}
+
+
+const GeometryPack::MeshRecord* GeometryPack::getMeshes() const noexcept
+{
+    return reinterpret_cast<const MeshRecord*> (reinterpret_cast<const std::uint8_t*> (m_header) + m_header->meshesOffset);
+}
+
+
+const Vertex* GeometryPack::getVertices() const noexcept
+{
+    return reinterpret_cast<const Vertex*> (reinterpret_cast<const std::uint8_t*> (m_header) + m_header->verticesOffset);
+}
+
+
+const Element* GeometryPack::getElements() const noexcept
+{
+    return reinterpret_cast<const Element*> (reinterpret_cast<const std::uint8_t*> (m_header) + m_header->elementsOffset);
+}
+
+
+bool GeometryPack::initialise (const std::string& packLocation, const std::string& sourceLocation) noexcept
+{
+    // Attempt to map the file.
+    auto file = MappedFile { };
+    if (!file.initialise (packLocation))
+    {
+        return false;
+    }
+
+    // Ensure the pack is usable and was baked from the current scene before replacing our data.
+    auto sourceSize = std::uint64_t { 0 };
+    auto sourceHash = std::uint64_t { 0 };
+    identifySource (sourceLocation, sourceSize, sourceHash);
+
+    const auto header = validate (file.getData(), file.getSize(), sourceSize, sourceHash);
+    if (!header)
+    {
+        return false;
+    }
+
+    clean();
+    m_file      = std::move (file);
+    m_header    = header;
+
+    return true;
+}
+
+
+bool GeometryPack::bake (const std::vector<const scene::Mesh*>& meshes, const std::string& packLocation, 
+    const std::string& sourceLocation) noexcept
+{
+    try
+    {
+        // Exported scenes often contain identical meshes under different IDs. Only the first of each set of duplicates
+        // will be stored, the rest will alias its region of the pack.
+        auto sources        = std::vector<size_t> { };
+        auto uniqueMeshes   = std::vector<const scene::Mesh*> { };
+        findDuplicates (meshes, sources, uniqueMeshes);
+
+        // Start by calculating where each mesh will be stored, this allows each mesh to be written in parallel.
+        auto vertexOffsets  = std::vector<size_t> { };
+        auto elementOffsets = std::vector<size_t> { };
+        util::calculateSceneSize (uniqueMeshes, vertexOffsets, elementOffsets);
+
+        // Now we can calculate the size of each region.
+        auto header = Header { };
+        header.magic        = magic;
+        header.version      = version;
+        header.vertexSize   = static_cast<std::uint32_t> (sizeof (Vertex));
+        header.elementSize  = static_cast<std::uint32_t> (sizeof (Element));
+        identifySource (sourceLocation, header.sourceSize, header.sourceHash);
+        header.meshCount    = meshes.size();
+        header.vertexCount  = vertexOffsets.back();
+        header.elementCount = elementOffsets.back();
+
+        header.meshesOffset     = align (sizeof (Header));
+        header.verticesOffset   = align (header.meshesOffset + header.meshCount * sizeof (MeshRecord));
+        header.elementsOffset   = align (header.verticesOffset + header.vertexCount * sizeof (Vertex));
+
+        // The size of the levels of detail is only known once every mesh has been simplified, so meshes are
+        // assembled into their own arrays and the pack is allocated once its final size is known.
+        auto vertexData     = std::vector<Vertex> (header.vertexCount);
+        auto elementData    = std::vector<Element> (header.elementCount);
+        const auto vertices = vertexData.data();
+        const auto elements = elementData.data();
+
+        // Each unique mesh owns a unique region of the pack so they can be assembled and optimised on any thread.
+        auto uniqueRecords  = std::vector<MeshRecord> (uniqueMeshes.size());
+        auto reports        = std::vector<util::MeshOptimisationReport> (uniqueMeshes.size());
+        auto levels         = std::vector<std::vector<util::SimplifiedLevel>> (uniqueMeshes.size());
+        util::parallelFor (uniqueMeshes.size(), [&] (const size_t i)
+        {
+            const auto& sceneMesh       = *uniqueMeshes[i];
+            const auto& meshElements    = sceneMesh.getElementArray();
+            const auto meshVertices     = vertices + vertexOffsets[i];
+            const auto meshElementsOut  = elements + elementOffsets[i];
+            const auto vertexCount      = vertexOffsets[i + 1] - vertexOffsets[i];
+
+            // Elements outside the mesh would be rejected when the pack is loaded, so the pack can't be baked.
+            const auto outside = [=] (const Element element) { return element >= vertexCount; };
+            if (std::any_of (std::begin (meshElements), std::end (meshElements), outside))
+            {
+                const auto id = std::to_string (sceneMesh.getId());
+                throw std::runtime_error { "Mesh " + id + " indexes past its vertices." };
+            }
+
+            util::assembleVertices (sceneMesh, meshVertices);
+            std::copy (std::begin (meshElements), std::end (meshElements), meshElementsOut);
+
+            // Reorder triangles and vertices so the geometry and shadow passes shade as few vertices as possible.
+            reports[i] = util::optimiseMesh (meshElementsOut, meshElements.size(), meshVertices, vertexCount);
+
+            auto& record = uniqueRecords[i];
+            record.verticesIndex        = static_cast<std::uint32_t> (vertexOffsets[i]);
+            record.vertexCount          = static_cast<std::uint32_t> (vertexCount);
+            record.elementsIndex        = static_cast<std::uint32_t> (elementOffsets[i]);
+            record.elementCount         = static_cast<std::uint32_t> (meshElements.size());
+            record.elementType          = GL_UNSIGNED_INT;
+
+            if (vertexCount > 0)
+            {
+                record.min = record.max = meshVertices[0].position;
+
+                for (size_t v { 1 }; v < vertexCount; ++v)
+                {
+                    record.min = glm::min (record.min, meshVertices[v].position);
+                    record.max = glm::max (record.max, meshVertices[v].position);
+                }
+            }
+
+            // Dense meshes are also simplified so they can be drawn with fewer triangles when they appear small.
+            levels[i] = generateLevelsOfDetail (meshElementsOut, meshElements.size(), meshVertices, vertexCount,
+                record.min, record.max);
+        });
+
+        reportOptimisation (uniqueMeshes, reports);
+        reportLevelsOfDetail (uniqueMeshes, levels);
+
+        // Levels of detail are stored after every full resolution element, they index the vertices of their mesh.
+        auto levelElements = size_t { 0 };
+        for (size_t i { 0 }; i < levels.size(); ++i)
+        {
+            auto& record        = uniqueRecords[i];
+            record.levelCount   = static_cast<std::uint32_t> (levels[i].size());
+
+            for (size_t l { 0 }; l < levels[i].size(); ++l)
+            {
+                record.levels[l].elementsIndex  = static_cast<std::uint32_t> (header.elementCount + levelElements);
+                record.levels[l].elementCount   = static_cast<std::uint32_t> (levels[i][l].elements.size());
+                record.levels[l].error          = levels[i][l].error;
+                levelElements                   += levels[i][l].elements.size();
+            }
+        }
+
+        // Now the pack can be allocated in a single block and each region written in place.
+        header.elementCount += levelElements;
+        auto memory = std::vector<std::uint8_t> (header.elementsOffset + header.elementCount * sizeof (Element));
+        std::memcpy (memory.data(), &header, sizeof (Header));
+
+        const auto records      = reinterpret_cast<MeshRecord*> (memory.data() + header.meshesOffset);
+        const auto allVertices  = reinterpret_cast<Vertex*> (memory.data() + header.verticesOffset);
+        const auto allElements  = reinterpret_cast<Element*> (memory.data() + header.elementsOffset);
+        std::copy (std::begin (vertexData), std::end (vertexData), allVertices);
+        std::copy (std::begin (elementData), std::end (elementData), allElements);
+
+        for (size_t i { 0 }; i < levels.size(); ++i)
+        {
+            for (size_t l { 0 }; l < levels[i].size(); ++l)
+            {
+                const auto& simplified = levels[i][l].elements;
+                std::copy (std::begin (simplified), std::end (simplified), 
+                    allElements + uniqueRecords[i].levels[l].elementsIndex);
+            }
+        }
+
+        // Every mesh, including duplicates, needs a record.
+        for (size_t i { 0 }; i < meshes.size(); ++i)
+        {
+            auto record = uniqueRecords[sources[i]];
+            record.id   = meshes[i]->getId();
+            std::memcpy (records + i, &record, sizeof (MeshRecord));
+        }
+
+        // Save the pack so future runs can map it instead, failing to do so isn't fatal.
+        auto file = std::ofstream { packLocation, std::ios::binary | std::ios::trunc };
+        file.write (reinterpret_cast<const char*> (memory.data()), static_cast<std::streamsize> (memory.size()));
+
+        if (!file.good())
+        {
+            std::cerr << "GeometryPack::bake(): Unable to save \"" << packLocation << "\"." << std::endl;
+        }
+
+        // Finally use the baked data.
+        clean();
+        m_memory = std::move (memory);
+        m_header = reinterpret_cast<const Header*> (m_memory.data());
+
+        return true;
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "GeometryPack::bake(): " << e.what() << std::endl;
+        return false;
+    }
+}
+
+
+void GeometryPack::findDuplicates (const std::vector<const scene::Mesh*>& meshes, std::vector<size_t>& sources,
+    std::vector<const scene::Mesh*>& uniqueMeshes)
+{
+    // Hashing is the expensive part so it can be done in parallel.
+    auto hashes = std::vector<std::uint64_t> (meshes.size());
+    util::parallelFor (meshes.size(), [&] (const size_t i) { hashes[i] = util::hashMeshData (*meshes[i]); });
+
+    // Meshes with the same hash are compared in full before being aliased, collisions are unlikely but possible.
+    auto candidates = std::unordered_map<std::uint64_t, std::vector<size_t>> { };
+    sources.resize (meshes.size());
+    uniqueMeshes.clear();
+
+    for (size_t i { 0 }; i < meshes.size(); ++i)
+    {
+        auto& matches   = candidates[hashes[i]];
+        const auto it   = std::find_if (std::begin (matches), std::end (matches), [&] (const size_t unique)
+        {
+            return util::meshDataEquals (*uniqueMeshes[unique], *meshes[i]);
+        });
+
+        if (it != std::end (matches))
+        {
+            sources[i] = *it;
+        }
+
+        else
+        {
+            sources[i] = uniqueMeshes.size();
+            matches.push_back (uniqueMeshes.size());
+            uniqueMeshes.push_back (meshes[i]);
+        }
+    }
+}
+
+
+void GeometryPack::reportOptimisation (const std::vector<const scene::Mesh*>& uniqueMeshes,
+    const std::vector<util::MeshOptimisationReport>& reports)
+{
+    // Totals are weighted by the size of each mesh so they reflect the cost of drawing the whole scene.
+    auto before = util::VertexCacheStatistics { };
+    auto after  = util::VertexCacheStatistics { };
+    auto output = std::ostringstream { };
+    output << std::fixed << std::setprecision (3);
+
+    for (size_t i { 0 }; i < reports.size(); ++i)
+    {
+        const auto& report  = reports[i];
+        const auto id       = uniqueMeshes[i]->getId();
+
+        if (!report.optimised)
+        {
+            output << "GeometryPack::bake(): Mesh " << id << " isn't a valid triangle list so wasn't optimised.\n";
+            continue;
+        }
+
+        output  << "GeometryPack::bake(): Mesh " << id << ", " << report.before.triangles << " triangles, "
+                << report.clusters << " clusters. ACMR " << report.before.acmr() << " -> " << report.after.acmr() 
+                << ", ATVR " << report.before.atvr() << " -> " << report.after.atvr() << "\n";
+
+        before.transformed  += report.before.transformed;
+        before.triangles    += report.before.triangles;
+        before.vertices     += report.before.vertices;
+        after.transformed   += report.after.transformed;
+        after.triangles     += report.after.triangles;
+        after.vertices      += report.after.vertices;
+    }
+
+    output  << "GeometryPack::bake(): Scene ACMR " << before.acmr() << " -> " << after.acmr() 
+            << ", ATVR " << before.atvr() << " -> " << after.atvr() << ", " << util::defaultVertexCacheSize 
+            << " entry FIFO cache.\n";
+
+    std::cout << output.str();
+}
+
+
+std::vector<util::SimplifiedLevel> GeometryPack::generateLevelsOfDetail (const Element* elements, 
+    const size_t elementCount, const Vertex* vertices, const size_t vertexCount, const glm::vec3& min, 
+    const glm::vec3& max)
+{
+    // Most of the architecture is made of large, sparse meshes which gain little from simplification.
+    const auto triangles = elementCount / 3;
+    if (triangles < minTriangles)
+    {
+        return { };
+    }
+
+    auto targets = std::vector<size_t> { };
+    for (size_t level { 1 }; level <= maxLevels; ++level)
+    {
+        targets.push_back (triangles >> level);
+    }
+
+    // Limiting the error stops the coarsest levels losing the shape of the mesh, even from a distance.
+    const auto maxError = glm::length (max - min) * maxLODError;
+    auto levels         = util::simplifyMesh (elements, elementCount, vertices, vertexCount, targets, maxError);
+
+    // The vertices are shared so only the triangles of each level can be reordered.
+    for (auto& level : levels)
+    {
+        const auto clusters = util::optimiseVertexCache (level.elements.data(), level.elements.size(), vertexCount);
+        util::optimiseOverdraw (level.elements.data(), level.elements.size(), vertices, clusters);
+    }
+
+    return levels;
+}
+
+
+void GeometryPack::reportLevelsOfDetail (const std::vector<const scene::Mesh*>& uniqueMeshes,
+    const std::vector<std::vector<util::SimplifiedLevel>>& levels)
+{
+    auto meshCount  = size_t { 0 };
+    auto triangles  = size_t { 0 };
+    auto output     = std::ostringstream { };
+    output << std::setprecision (3);
+
+    for (size_t i { 0 }; i < levels.size(); ++i)
+    {
+        if (levels[i].empty())
+        {
+            continue;
+        }
+
+        output  << "GeometryPack::bake(): Mesh " << uniqueMeshes[i]->getId() << " levels of detail, " 
+                << uniqueMeshes[i]->getElementArray().size() / 3 << " triangles";
+
+        for (const auto& level : levels[i])
+        {
+            output << " -> " << level.elements.size() / 3 << " (error " << level.error << ")";
+            triangles += level.elements.size() / 3;
+        }
+
+        output << "\n";
+        ++meshCount;
+    }
+
+    output  << "GeometryPack::bake(): " << meshCount << " meshes have levels of detail, storing an extra " 
+            << triangles << " triangles.\n";
+
+    std::cout << output.str();
+}
+
+
+void GeometryPack::clean() noexcept
+{
+    m_file.clean();
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+    m_header = nullptr;
+}
+
+
+const GeometryPack::Header* GeometryPack::validate (const void* data, const size_t size, 
+    const std::uint64_t sourceSize, const std::uint64_t sourceHash) noexcept
+{
+    // The header must exist and match our current layout.
+    if (size < sizeof (Header))
+    {
+        return nullptr;
+    }
+
+    const auto header = reinterpret_cast<const Header*> (data);
+    if (header->magic != magic || header->version != version || header->vertexSize != sizeof (Vertex) ||
+        header->elementSize != sizeof (Element) || header->sourceSize != sourceSize || 
+        header->sourceHash != sourceHash)
+    {
+        return nullptr;
+    }
+
+    // Every region must fit inside the file.
+    const auto fits = [=] (const std::uint64_t offset, const std::uint64_t count, const size_t stride)
+    {
+        return offset % alignment == 0 && offset <= size && count <= (size - offset) / stride;
+    };
+
+    if (!fits (header->meshesOffset, header->meshCount, sizeof (MeshRecord)) ||
+        !fits (header->verticesOffset, header->vertexCount, sizeof (Vertex)) ||
+        !fits (header->elementsOffset, header->elementCount, sizeof (Element)))
+    {
+        return nullptr;
+    }
+
+    // Every mesh and level of detail must only draw elements which are stored in the pack, and each element must
+    // index a vertex of its own mesh or the GPU would read past it.
+    const auto start    = static_cast<const std::uint8_t*> (data);
+    const auto records  = reinterpret_cast<const MeshRecord*> (start + header->meshesOffset);
+    const auto elements = reinterpret_cast<const Element*> (start + header->elementsOffset);
+
+    const auto within = [=] (const std::uint64_t index, const std::uint64_t count, const std::uint32_t vertexCount)
+    {
+        return index <= header->elementCount && count <= header->elementCount - index &&
+            std::all_of (elements + index, elements + index + count, 
+                [=] (const Element element) { return element < vertexCount; });
+    };
+
+    for (size_t i { 0 }; i < header->meshCount; ++i)
+    {
+        const auto& record = records[i];
+        if (record.levelCount > maxLevels || record.elementType != GL_UNSIGNED_INT ||
+            record.verticesIndex > header->vertexCount || 
+            record.vertexCount > header->vertexCount - record.verticesIndex ||
+            !within (record.elementsIndex, record.elementCount, record.vertexCount))
+        {
+            return nullptr;
+        }
+
+        for (size_t l { 0 }; l < record.levelCount; ++l)
+        {
+            if (!within (record.levels[l].elementsIndex, record.levels[l].elementCount, record.vertexCount))
+            {
+                return nullptr;
+            }
+        }
+    }
+
+    return header;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#if !defined    _RENDERING_RENDERER_GEOMETRY_GEOMETRY_PACK_
+#define         _RENDERING_RENDERER_GEOMETRY_GEOMETRY_PACK_
+
+// STL headers.
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Engine headers.
+#include <glm/vec3.hpp>
+#include <scene/scene_fwd.hpp>
+
+
+// Personal headers.
+#include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
+#include <Rendering/Renderer/Geometry/Mesh.hpp>
+#include <Rendering/Renderer/Types.hpp>
+#include <Utility/MappedFile.hpp>
+#include <Utility/MeshOptimisation.hpp>
+#include <Utility/MeshSimplification.hpp>
+
+
+/// <summary>
+/// A versioned binary pack of scene geometry in its final GPU layout. The pack contains a header, a table of meshes
+/// with their draw parameters and bounds, the interleaved vertices of every mesh and finally every element. Packs are
+/// memory-mapped so the vertex and element regions can be uploaded straight from the mapping. Meshes with identical
+/// data are only stored once, the records of duplicate meshes will alias the same region of the pack. Simplified
+/// levels of detail of each mesh are stored after every full resolution element, indexing the same vertices.
+/// </summary>
+class GeometryPack final
+{
+    public:
+
+        constexpr static auto version   = std::uint32_t { 8 };  //!< Packs of any other version must be rebaked.
+        constexpr static auto maxLevels = size_t { 3 };         //!< How many simplified levels of detail a mesh can have.
+
+        /// <summary> The header found at the start of every pack. All offsets are in bytes from the file start. </summary>
+        struct Header final
+        {
+            std::array<char, 4> magic           { };    //!< Identifies the file as a geometry pack.
+            std::uint32_t       version         { 0 };  //!< The version of the pack layout.
+            std::uint32_t       vertexSize      { 0 };  //!< The size of each vertex, used to detect layout changes.
+            std::uint32_t       elementSize     { 0 };  //!< The size of each element, used to detect layout changes.
+            std::uint64_t       sourceSize      { 0 };  //!< The size of the scene file the pack was baked from.
+            std::uint64_t       sourceHash      { 0 };  //!< A 64-bit FNV-1a hash of the scene file the pack was baked from.
+            std::uint64_t       meshCount       { 0 };  //!< How many mesh records are stored.
+            std::uint64_t       vertexCount     { 0 };  //!< How many vertices are stored.
+            std::uint64_t       elementCount    { 0 };  //!< How many elements are stored.
+            std::uint64_t       meshesOffset    { 0 };  //!< Where the mesh table starts.
+            std::uint64_t       verticesOffset  { 0 };  //!< Where the vertex data starts.
+            std::uint64_t       elementsOffset  { 0 };  //!< Where the element data starts.
+        };
+
+        /// <summary> A simplified version of a mesh, drawn with the vertices of the full resolution mesh. </summary>
+        struct LevelOfDetail final
+        {
+            std::uint32_t   elementsIndex   { 0 };      //!< Where the elements of the level start.
+            std::uint32_t   elementCount    { 0 };      //!< How many elements the level has.
+            float           error           { 0.f };    //!< How far the surface may deviate from the original, in object space.
+        };
+
+        using LevelsOfDetail = std::array<LevelOfDetail, maxLevels>;
+
+        /// <summary> 
+        /// An entry in the mesh table, mapping a scene mesh to its region of the pack. The layout is independent of
+        /// Mesh so the draw parameters used at run time can change without changing the pack format.
+        /// </summary>
+        struct MeshRecord final
+        {
+            scene::MeshId   id              { 0 };                  //!< The scene ID of the mesh.
+            std::uint32_t   verticesIndex   { 0 };                  //!< The first vertex of the mesh.
+            std::uint32_t   vertexCount     { 0 };                  //!< How many vertices the mesh has.
+            std::uint32_t   elementsIndex   { 0 };                  //!< The first element of the mesh.
+            std::uint32_t   elementCount    { 0 };                  //!< How many elements the mesh has.
+            std::uint32_t   elementType     { GL_UNSIGNED_INT };    //!< The type of each element, always 32-bit.
+            glm::vec3       min             { 0 };                  //!< The minimum corner of the object-space bounds.
+            glm::vec3       max             { 0 };                  //!< The maximum corner of the object-space bounds.
+            LevelsOfDetail  levels          { };                    //!< Simplified versions of the mesh, finest first.
+            std::uint32_t   levelCount      { 0 };                  //!< How many of the levels are used.
+
+            /// <summary> Creates the mesh used to draw the full resolution version of the record. </summary>
+            inline Mesh toMesh() const noexcept
+            {
+                auto mesh           = Mesh { };
+                mesh.verticesIndex  = verticesIndex;
+                mesh.elementsIndex  = elementsIndex;
+                mesh.elementCount   = elementCount;
+                mesh.elementType    = elementType;
+                return mesh;
+            }
+        };
+
+    public:
+
+        GeometryPack() noexcept                         = default;
+        GeometryPack (GeometryPack&&) noexcept          = default;
+        GeometryPack& operator= (GeometryPack&&)        = default;
+        ~GeometryPack()                                 = default;
+
+        GeometryPack (const GeometryPack&)              = delete;
+        GeometryPack& operator= (const GeometryPack&)   = delete;
+
+
+        /// <summary> Check if the pack contains valid data. </summary>
+        inline bool isInitialised() const noexcept                  { return m_header != nullptr; }
+
+        /// <summary> Gets the header of the pack. </summary>
+        inline const Header& getHeader() const noexcept             { return *m_header; }
+
+        /// <summary> Gets the start of the mesh table, this contains getHeader().meshCount records. </summary>
+        const MeshRecord* getMeshes() const noexcept;
+
+        /// <summary> Gets the start of the vertex data, this contains getHeader().vertexCount vertices. </summary>
+        const Vertex* getVertices() const noexcept;
+
+        /// <summary> Gets the start of the element data, this contains getHeader().elementCount elements. </summary>
+        const types::Element* getElements() const noexcept;
+
+
+        /// <summary>
+        /// Maps the pack at the given location and validates it against the given scene file. Packs with a different
+        /// version or vertex layout, or which were baked from a scene file with different contents, are rejected so
+        /// that they can be rebaked.
+        /// </summary>
+        /// <param name="packLocation"> The location of the pack file. </param>
+        /// <param name="sourceLocation"> The location of the scene file the pack should've been baked from. </param>
+        /// <returns> Whether the pack was mapped and is valid for use. </returns>
+        bool initialise (const std::string& packLocation, const std::string& sourceLocation) noexcept;
+
+        /// <summary>
+        /// Bakes a new pack from the given meshes and attempts to save it at the given location for future runs. The
+        /// object will contain the baked data even if the pack can't be saved. Each mesh is reordered for vertex cache
+        /// efficiency, overdraw and vertex fetch locality and its cache efficiency before and after is reported.
+        /// Dense meshes are then simplified into levels of detail which are also ordered for the vertex cache.
+        /// </summary>
+        /// <param name="meshes"> Every mesh to be stored, in the order they should be stored. </param>
+        /// <param name="packLocation"> Where the pack should be saved. </param>
+        /// <param name="sourceLocation"> The location of the scene file the meshes came from. </param>
+        /// <returns> Whether the pack was successfully baked. </returns>
+        bool bake (const std::vector<const scene::Mesh*>& meshes, const std::string& packLocation, 
+            const std::string& sourceLocation) noexcept;
+
+        /// <summary> Unmaps and releases any stored data. </summary>
+        void clean() noexcept;
+
+    private:
+
+        MappedFile                  m_file      { };        //!< The mapped pack file, if the pack was loaded from disk.
+        std::vector<std::uint8_t>   m_memory    { };        //!< The baked pack, if the pack couldn't be mapped.
+        const Header*               m_header    { nullptr };//!< Points to the start of the pack.
+
+    private:
+
+        /// <summary> 
+        /// Finds meshes with identical vertex and element data by hashing the data of each mesh.
+        /// </summary>
+        /// <param name="meshes"> Every mesh which will be stored in the pack. </param>
+        /// <param name="sources"> Outputs the index into uniqueMeshes which each mesh should alias. </param>
+        /// <param name="uniqueMeshes"> Outputs the first occurrence of each unique mesh, in the order given. </param>
+        static void findDuplicates (const std::vector<const scene::Mesh*>& meshes, std::vector<size_t>& sources,
+            std::vector<const scene::Mesh*>& uniqueMeshes);
+
+        /// <summary> Prints the vertex cache efficiency of each optimised mesh and of the meshes as a whole. </summary>
+        /// <param name="uniqueMeshes"> The meshes which were optimised. </param>
+        /// <param name="reports"> The result of optimising each unique mesh. </param>
+        static void reportOptimisation (const std::vector<const scene::Mesh*>& uniqueMeshes,
+            const std::vector<util::MeshOptimisationReport>& reports);
+
+        /// <summary>
+        /// Simplifies the given mesh into levels of detail, halving the triangle count of each level. Meshes with too
+        /// few triangles aren't simplified. The elements of each level are reordered for the vertex cache.
+        /// </summary>
+        /// <param name="elements"> The optimised elements of the mesh. </param>
+        /// <param name="elementCount"> How many elements the mesh has. </param>
+        /// <param name="vertices"> The optimised vertices of the mesh. </param>
+        /// <param name="vertexCount"> How many vertices the mesh has. </param>
+        /// <param name="min"> The minimum corner of the bounding box of the mesh. </param>
+        /// <param name="max"> The maximum corner of the bounding box of the mesh. </param>
+        static std::vector<util::SimplifiedLevel> generateLevelsOfDetail (const types::Element* elements, 
+            const size_t elementCount, const Vertex* vertices, const size_t vertexCount, const glm::vec3& min, 
+            const glm::vec3& max);
+
+        /// <summary> Prints the triangle count and error of each level of detail which was generated. </summary>
+        /// <param name="uniqueMeshes"> The meshes which were simplified. </param>
+        /// <param name="levels"> The levels of detail of each unique mesh. </param>
+        static void reportLevelsOfDetail (const std::vector<const scene::Mesh*>& uniqueMeshes,
+            const std::vector<std::vector<util::SimplifiedLevel>>& levels);
+
+        /// <summary>
+        /// Checks that the given memory contains a valid pack for the given source file, including that every mesh
+        /// and level of detail only draws elements stored in the pack and that each element indexes its own vertices.
+        /// </summary>
+        /// <returns> The header of the pack if valid, otherwise nullptr. </returns>
+        static const Header* validate (const void* data, const size_t size, const std::uint64_t sourceSize, 
+            const std::uint64_t sourceHash) noexcept;
+};
+
+#endif // _RENDERING_RENDERER_GEOMETRY_GEOMETRY_PACK_
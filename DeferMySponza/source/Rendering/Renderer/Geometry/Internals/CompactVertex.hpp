@@ -0,0 +1,42 @@
+#pragma once
+
+#if !defined    _RENDERING_RENDERER_GEOMETRY_INTERNALS_COMPACT_VERTEX_
+#define         _RENDERING_RENDERER_GEOMETRY_INTERNALS_COMPACT_VERTEX_
+
+// STL headers.
+#include <array>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+/// <summary> 
+/// A quantised Vertex which occupies half the memory. The position is stored as 16-bit unsigned normalised values
+/// across the bounds of its mesh, the mesh dequantises it as part of the model transform. The normal is octahedral 
+/// encoded as two 16-bit signed normalised values and the texture co-ordinate is stored as half floats.
+/// </summary>
+struct CompactVertex final
+{
+    std::array<GLushort, 3> position        { };    //!< The position relative to the bounds of the mesh.
+    GLushort                padding         { 0 };  //!< Keeps the normal aligned to four bytes.
+    std::array<GLshort, 2>  normal          { };    //!< The octahedral encoded normal, skewed by the mesh bounds.
+    std::array<GLushort, 2> texturePoint    { };    //!< The texture co-ordinate of the vertex as half floats.
+};
+
+static_assert (sizeof (CompactVertex) == 16, "Compact vertices should be exactly half the size of a Vertex.");
+
+
+/// <summary> 
+/// The quantised position of a CompactVertex on its own, used by position-only vertex streams. It keeps the padding
+/// so that each position starts on an eight byte boundary.
+/// </summary>
+struct CompactPosition final
+{
+    std::array<GLushort, 3> position        { };    //!< The position relative to the bounds of the mesh.
+    GLushort                padding         { 0 };  //!< Keeps each position aligned to eight bytes.
+};
+
+static_assert (sizeof (CompactPosition) == 8, "Compact positions should be a quarter of the size of a Vertex.");
+
+#endif // _RENDERING_RENDERER_GEOMETRY_INTERNALS_COMPACT_VERTEX_
@@ -3,10 +3,6 @@
 #if !defined    _RENDERING_GEOMETRY_INTERNALS_
 #define         _RENDERING_GEOMETRY_INTERNALS_
 
-// STL headers.
-#include <unordered_map>
-
-
 // Personal headers.
 #include <Rendering/Renderer/Geometry/Geometry.hpp>
 
@@ -18,14 +14,14 @@ struct Geometry::Internals final
 {
     constexpr static auto   sceneVerticesIndex      = size_t { 0 },                 //!< The index of the scene vertices buffer.
                             sceneElementsIndex      = sceneVerticesIndex + 1,       //!< The index of the scene elements buffer.
-                            transformsIndex         = sceneElementsIndex + 1,       //!< The index of the transforms buffer.
+                            scenePositionsIndex     = sceneElementsIndex + 1,       //!< The index of the position-only scene vertex stream.
+                            transformsIndex         = scenePositionsIndex + 1,      //!< The index of the transforms buffer.
                             materialIDsIndex        = transformsIndex + 1,          //!< The index of the material IDs buffer.
                             lightVerticesIndex      = materialIDsIndex + 1,         //!< The index of the light vertices buffer.
                             lightElementsIndex      = lightVerticesIndex + 1,       //!< The index of the light elements buffer.
                             triangleVerticesIndex   = lightElementsIndex + 1,       //!< The index of the full screen triangle vertices.
                             bufferCount             = triangleVerticesIndex + 1;    //!< The total number of stored buffers.
 
-    using Meshes    = std::unordered_map<scene::MeshId, Mesh>;
     using Buffers   = std::array<Buffer, bufferCount>;
     
     Meshes  sceneMeshes { };    //!< A list of mesh data for buffered scene meshes.
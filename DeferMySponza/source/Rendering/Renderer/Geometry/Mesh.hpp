@@ -4,6 +4,8 @@
 #define         _RENDERING_RENDERER_GEOMETRY_MESH_
 
 // Engine headers.
+#include <glm/mat4x3.hpp>
+#include <glm/vec3.hpp>
 #include <tgl/tgl.h>
 
 
@@ -12,9 +14,12 @@
 /// </summary>
 struct Mesh final
 {
-    GLuint  verticesIndex   { 0 };  //!< The index of a VBO where the vertices for the mesh begin.
-    GLuint  elementsIndex   { 0 };  //!< The index of a VBO where the elements for the mesh start.
-    GLuint  elementCount    { 0 };  //!< Indicates how many elements there are.
+    GLuint      verticesIndex   { 0 };                //!< The index of a VBO where the vertices for the mesh begin.
+    GLuint      elementsIndex   { 0 };                //!< The index of a VBO where the elements for the mesh start, counted in elementType.
+    GLuint      elementCount    { 0 };                //!< Indicates how many elements there are.
+    GLenum      elementType     { GL_UNSIGNED_INT };  //!< The type of each element, either GL_UNSIGNED_SHORT or GL_UNSIGNED_INT.
+    glm::vec3   positionOffset  { 0 };                //!< Added to quantised positions after scaling, zero if not quantised.
+    glm::vec3   positionScale   { 1 };                //!< Scales quantised positions into object space, one if not quantised.
     
     Mesh() noexcept                         = default;
     Mesh (Mesh&&) noexcept                  = default;
@@ -22,6 +27,19 @@ struct Mesh final
     Mesh& operator= (const Mesh&) noexcept  = default;
     Mesh& operator= (Mesh&&) noexcept       = default;
     ~Mesh()                                 = default;
+
+    /// <summary> 
+    /// Folds the dequantisation of the vertex positions into a model transform so shaders can use it unchanged.
+    /// </summary>
+    inline glm::mat4x3 dequantise (const glm::mat4x3& model) const noexcept
+    {
+        auto result = glm::mat4x3 { model };
+        result[0]   = model[0] * positionScale.x;
+        result[1]   = model[1] * positionScale.y;
+        result[2]   = model[2] * positionScale.z;
+        result[3]   = model[3] + model[0] * positionOffset.x + model[1] * positionOffset.y + model[2] * positionOffset.z;
+        return result;
+    }
 };
 
 #endif // _RENDERING_RENDERER_GEOMETRY_MESH_
\ No newline at end of file
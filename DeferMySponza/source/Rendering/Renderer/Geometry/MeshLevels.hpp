@@ -0,0 +1,83 @@
+#pragma once
+
+#if !defined    _RENDERING_RENDERER_GEOMETRY_MESH_LEVELS_
+#define         _RENDERING_RENDERER_GEOMETRY_MESH_LEVELS_
+
+// STL headers.
+#include <algorithm>
+#include <vector>
+
+
+// Engine headers.
+#include <glm/geometric.hpp>
+#include <glm/mat4x3.hpp>
+#include <glm/vec3.hpp>
+
+
+// Personal headers.
+#include <Rendering/Renderer/Geometry/Mesh.hpp>
+
+
+/// <summary> The world-space bounding sphere of an instance, used to select which level of detail to draw. </summary>
+struct InstanceBounds final
+{
+    glm::vec3   centre  { 0.f };    //!< The centre of the sphere.
+    float       radius  { 0.f };    //!< The radius of the sphere.
+    float       scale   { 1.f };    //!< The largest scale of the instance transform, object-space errors grow by this.
+};
+
+
+/// <summary>
+/// Every level of detail of a scene mesh, the first being the full resolution mesh. Each level has its own parts but
+/// they all use the vertices of the full resolution mesh so every part shares the same vertex dequantisation.
+/// </summary>
+struct MeshLevels final
+{
+    using Parts = std::vector<Mesh>;
+
+    std::vector<Parts>  levels  { };        //!< The parts of each level, from finest to coarsest.
+    std::vector<float>  errors  { };        //!< How far each level may deviate from the full mesh, in object space.
+    glm::vec3           centre  { 0.f };    //!< The centre of the object-space bounding box.
+    float               radius  { 0.f };    //!< The radius of a sphere containing the object-space bounding box.
+
+    /// <summary> Checks whether the mesh has anything to draw. </summary>
+    inline bool empty() const noexcept              { return levels.empty() || levels.front().empty(); }
+
+    /// <summary> Gets the first part of the full resolution mesh, every part of every level shares its dequantisation. </summary>
+    inline const Mesh& front() const noexcept       { return levels.front().front(); }
+
+    /// <summary> Gets the largest number of parts any level has, each part needs its own draw command. </summary>
+    inline size_t maxParts() const noexcept
+    {
+        auto parts = size_t { 0 };
+        for (const auto& level : levels)
+        {
+            parts = std::max (parts, level.size());
+        }
+
+        return parts;
+    }
+
+    /// <summary> Transforms the bounding sphere of the mesh by the given instance transform. </summary>
+    inline InstanceBounds bounds (const glm::mat4x3& model) const noexcept
+    {
+        const auto scale = std::max ({ glm::length (model[0]), glm::length (model[1]), glm::length (model[2]) });
+        return { model[0] * centre.x + model[1] * centre.y + model[2] * centre.z + model[3], radius * scale, scale };
+    }
+
+    /// <summary> Selects the coarsest level whose error covers no more than the given number of pixels. </summary>
+    /// <param name="pixelsPerUnit"> How many pixels an object-space unit of the instance covers on screen. </param>
+    /// <param name="maxPixelError"> How many pixels the error of the selected level may cover. </param>
+    inline size_t selectLevel (const float pixelsPerUnit, const float maxPixelError) const noexcept
+    {
+        auto level = size_t { 0 };
+        while (level + 1 < levels.size() && errors[level + 1] * pixelsPerUnit <= maxPixelError)
+        {
+            ++level;
+        }
+
+        return level;
+    }
+};
+
+#endif // _RENDERING_RENDERER_GEOMETRY_MESH_LEVELS_
@@ -1,11 +1,15 @@
 #include "SceneVAO.hpp"
 
 
+// STL headers.
+#include <cstddef>
+
+
 // Namespaces
 using namespace types;
 
 
-void SceneVAO::configureAttributes() noexcept
+void SceneVAO::configureAttributes (const bool compactVertices) noexcept
 {
     // Enable each attribute.
     vao.setAttributeStatus (positionAttributeIndex, true);
@@ -22,13 +26,27 @@ void SceneVAO::configureAttributes() noexcept
     // Use static buffers by default for instance data.
     useStaticBuffers();
 
-    // We must interleave the vertex information.
-    vao.setAttributeFormat (positionAttributeIndex, VertexArray::AttributeLayout::Float32,
-                            3, GL_FLOAT, 0);
-    vao.setAttributeFormat (normalAttributeIndex, VertexArray::AttributeLayout::Float32,
-                            3, GL_FLOAT, sizeof (glm::vec3));
-    vao.setAttributeFormat (texturePointAttributeIndex, VertexArray::AttributeLayout::Float32,
-                            2, GL_FLOAT, sizeof (glm::vec3) * 2);
+    // We must interleave the vertex information. Compact positions and normals are normalised integers which are
+    // decoded by the model transform and the geometry shader respectively.
+    if (compactVertices)
+    {
+        vao.setAttributeFormat (positionAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                3, GL_UNSIGNED_SHORT, offsetof (CompactVertex, position), GL_TRUE);
+        vao.setAttributeFormat (normalAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                2, GL_SHORT, offsetof (CompactVertex, normal), GL_TRUE);
+        vao.setAttributeFormat (texturePointAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                2, GL_HALF_FLOAT, offsetof (CompactVertex, texturePoint));
+    }
+
+    else
+    {
+        vao.setAttributeFormat (positionAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                3, GL_FLOAT, 0);
+        vao.setAttributeFormat (normalAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                3, GL_FLOAT, sizeof (glm::vec3));
+        vao.setAttributeFormat (texturePointAttributeIndex, VertexArray::AttributeLayout::Float32,
+                                2, GL_FLOAT, sizeof (glm::vec3) * 2);
+    }
 
     // The material ID should be stored as an integer.
     vao.setAttributeFormat (materialIDAttributeIndex, VertexArray::AttributeLayout::Integer,
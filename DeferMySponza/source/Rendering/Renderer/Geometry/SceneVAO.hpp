@@ -9,6 +9,7 @@
 
 // Personal headers.
 #include <Rendering/Objects/VertexArray.hpp>
+#include <Rendering/Renderer/Geometry/Internals/CompactVertex.hpp>
 #include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
 #include <Rendering/Renderer/Materials/Materials.hpp>
 #include <Rendering/Renderer/Types.hpp>
@@ -45,14 +46,16 @@ struct SceneVAO final
 
 
     /// <summary> Attachs the given buffers to the VAO based on the compile-time indices in the class. </summary>
+    /// <param name="compactVertices"> Whether the mesh buffer contains CompactVertex rather than Vertex. </param>
     template <size_t MultiBuffering>
-    void attachVertexBuffers (const Buffer& meshes, const Buffer& elements, 
+    void attachVertexBuffers (const bool compactVertices, const Buffer& meshes, const Buffer& elements, 
         const Buffer& staticTransforms, const Buffer& staticMaterialIDs,
         const PersistentMappedBuffer<MultiBuffering>& dynamicMaterialIDs, 
         const PersistentMappedBuffer<MultiBuffering>& dynamicTransforms) noexcept;
 
     /// <summary> Sets the binding points and formatting of attributes in the VAO. </summary>
-    void configureAttributes() noexcept;
+    /// <param name="compactVertices"> Whether vertex attributes are quantised like CompactVertex. </param>
+    void configureAttributes (const bool compactVertices) noexcept;
 
     /// <summary> Configures the instanced attributes to retrieve data from the static buffers. </summary>
     void useStaticBuffers() noexcept;
@@ -72,13 +75,13 @@ struct SceneVAO final
 
 
 template <size_t MultiBuffering>
-void SceneVAO::attachVertexBuffers (const Buffer& meshes, const Buffer& elements, 
+void SceneVAO::attachVertexBuffers (const bool compactVertices, const Buffer& meshes, const Buffer& elements, 
     const Buffer& staticTransforms, const Buffer& staticMaterialIDs,
     const PersistentMappedBuffer<MultiBuffering>& dynamicMaterialIDs, 
     const PersistentMappedBuffer<MultiBuffering>& dynamicTransforms) noexcept
 {
     // We need to calculate our strides.
-    constexpr auto meshesStride     = GLuint { sizeof (Vertex) };
+    const auto meshesStride         = static_cast<GLuint> (compactVertices ? sizeof (CompactVertex) : sizeof (Vertex));
     constexpr auto materialIDStride = GLuint { sizeof (types::MaterialID) };
     constexpr auto modelStride      = GLuint { sizeof (types::ModelTransform) };
 
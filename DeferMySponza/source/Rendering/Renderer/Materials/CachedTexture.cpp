@@ -0,0 +1,515 @@
+#include "CachedTexture.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <type_traits>
+
+
+// Engine headers.
+#include <tygra/Image.hpp>
+
+#if defined _WIN32
+    #if !defined WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #if !defined NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+#else
+    #include <sys/stat.h>
+#endif
+
+
+// Personal headers.
+#include <Utility/BlockCompression.hpp>
+#include <Utility/FileService.hpp>
+#include <Utility/MipMaps.hpp>
+#include <Utility/OpenGL/Textures.hpp>
+
+
+namespace
+{
+    constexpr auto magic        = std::array<char, 4> { 'D', 'M', 'T', 'C' };   //!< Identifies each entry.
+    constexpr auto alignment    = size_t { 16 };                                //!< Every region is aligned to this.
+    constexpr auto directory    = "texture_cache";                              //!< Where every entry is stored.
+    constexpr auto contentURI   = "content:///";                                //!< The scheme used by scene textures.
+    constexpr auto contentPath  = "content/";                                   //!< Where content URIs resolve to.
+
+    static_assert (std::is_trivially_copyable<CachedTexture::Header>::value, "Headers must be trivially copyable.");
+    static_assert (std::is_trivially_copyable<CachedTexture::Level>::value, "Levels must be trivially copyable.");
+
+
+    /// <summary> Rounds the given offset up to the alignment of each entry region. </summary>
+    inline size_t align (const size_t offset) noexcept
+    {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+
+
+    /// <summary> Converts a URI accepted by tygra into a path which can be opened directly. </summary>
+    std::string localPath (const std::string& uri)
+    {
+        const auto length = std::strlen (contentURI);
+        return uri.compare (0, length, contentURI) == 0 ? contentPath + uri.substr (length) : uri;
+    }
+
+
+    /// <summary> Creates the cache directory if it doesn't already exist. </summary>
+    void createDirectory() noexcept
+    {
+        #if defined _WIN32
+            CreateDirectoryA (directory, nullptr);
+        #else
+            mkdir (directory, 0755);
+        #endif
+    }
+
+
+    /// <summary> Gets the filter which should be used to generate mipmap levels for the given role. </summary>
+    util::MipFilter mipFilter (const CachedTexture::Role role) noexcept
+    {
+        switch (role)
+        {
+            case CachedTexture::Role::Albedo:
+                return util::MipFilter::SRGB;
+
+            case CachedTexture::Role::Normal:
+                return util::MipFilter::NormalMap;
+
+            default:
+                return util::MipFilter::Linear;
+        }
+    }
+
+
+    /// <summary> Chooses the block format a texture should be compressed with based on how it is used. </summary>
+    util::BlockFormat blockFormat (const CachedTexture::Role role, const size_t components, 
+        const bool useS3TC) noexcept
+    {
+        // Normals only need X and Y as Z is reconstructed when sampled, BC5 keeps far more detail than BC1.
+        if (role == CachedTexture::Role::Normal || components == 2)
+        {
+            return util::BlockFormat::BC5;
+        }
+
+        if (components == 1)
+        {
+            return util::BlockFormat::BC4;
+        }
+
+        // Colour suits BC1 but each property channel is unrelated so they need the independent precision of BC7. BC1
+        // is only available through S3TC whereas BC7 is core, so colour falls back to BC7 without the extension.
+        return role == CachedTexture::Role::Albedo && components == 3 && useS3TC ? util::BlockFormat::BC1 : 
+                                                                                   util::BlockFormat::BC7;
+    }
+
+
+    /// <summary> Gets the internal format of textures compressed with the given block format. </summary>
+    GLenum compressedFormat (const util::BlockFormat format) noexcept
+    {
+        switch (format)
+        {
+            case util::BlockFormat::BC1:
+                return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+
+            case util::BlockFormat::BC4:
+                return GL_COMPRESSED_RED_RGTC1;
+
+            case util::BlockFormat::BC5:
+                return GL_COMPRESSED_RG_RGTC2;
+
+            default:
+                return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+    }
+
+
+    /// <summary> Calculates how many bytes a level occupies, compressed levels are padded to whole blocks. </summary>
+    inline std::uint64_t levelSize (const std::uint32_t width, const std::uint32_t height, const size_t texelSize,
+        const std::uint32_t blockSize) noexcept
+    {
+        return blockSize == 0 ? std::uint64_t { width } * height * texelSize :
+                                std::uint64_t { (width + 3) / 4 } * ((height + 3) / 4) * blockSize;
+    }
+}
+
+
+const CachedTexture::Level* CachedTexture::getLevels() const noexcept
+{
+    return reinterpret_cast<const Level*> (reinterpret_cast<const std::uint8_t*> (m_header) + m_header->levelsOffset);
+}
+
+
+const GLvoid* CachedTexture::getTexels (const size_t level) const noexcept
+{
+    return reinterpret_cast<const std::uint8_t*> (m_header) + getLevels()[level].offset;
+}
+
+
+GLenum CachedTexture::getPixelFormat() const noexcept
+{
+    // Maps components to pixel formats.
+    constexpr GLenum pixelFormats[] = { 0, GL_RED, GL_RG, GL_RGB, GL_RGBA };
+    return pixelFormats[m_header->components];
+}
+
+
+GLenum CachedTexture::getPixelType() const noexcept
+{
+    return m_header->bytesPerComponent == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+}
+
+
+GLsizei CachedTexture::mipmapLevels (const size_t width, const size_t height) noexcept
+{
+    auto levels = GLsizei { 1 };
+    for (auto size = std::max (width, height); size > 1; size /= 2)
+    {
+        ++levels;
+    }
+
+    return levels;
+}
+
+
+CachedTexture::Key CachedTexture::identify (const std::string& sourceLocation) noexcept
+{
+    try
+    {
+        const auto file = FileService::instance().readFile (localPath (sourceLocation)).get();
+        if (!file.isInitialised())
+        {
+            return Key { };
+        }
+
+        // Hashing the compressed file is far cheaper than decoding it.
+        const auto bytes    = reinterpret_cast<const std::uint8_t*> (file.getData());
+        auto key            = Key { };
+        key.hash            = 14695981039346656037ULL;
+        key.size            = file.getSize();
+
+        for (size_t i { 0 }; i < file.getSize(); ++i)
+        {
+            key.hash = (key.hash ^ bytes[i]) * 1099511628211ULL;
+        }
+
+        return key;
+    }
+
+    catch (...)
+    {
+        return Key { };
+    }
+}
+
+
+void CachedTexture::prefetchSource (const std::string& sourceLocation) noexcept
+{
+    try
+    {
+        FileService::instance().prefetchFile (localPath (sourceLocation), FileService::Priority::Normal);
+    }
+
+    catch (...)
+    {
+        // identify() will read the file itself.
+    }
+}
+
+
+void CachedTexture::prefetchEntry (const Key& source, const Role role) noexcept
+{
+    if (source.size == 0)
+    {
+        return;
+    }
+
+    try
+    {
+        FileService::instance().prefetchFile (entryLocation (source, role), FileService::Priority::Normal);
+    }
+
+    catch (...)
+    {
+        // initialise() will read the entry itself.
+    }
+}
+
+
+bool CachedTexture::initialise (const Key& source, const Role role, const bool useS3TC) noexcept
+{
+    if (source.size == 0)
+    {
+        return false;
+    }
+
+    try
+    {
+        // Attempt to map the entry, it won't exist the first time a texture is used.
+        auto file = FileService::instance().readFile (entryLocation (source, role)).get();
+        if (!file.isInitialised())
+        {
+            return false;
+        }
+
+        // Ensure the entry is usable before replacing our data.
+        const auto header = validate (file.getData(), file.getSize(), source, role, useS3TC);
+        if (!header)
+        {
+            return false;
+        }
+
+        clean();
+        m_file      = std::move (file);
+        m_header    = header;
+
+        return true;
+    }
+
+    catch (...)
+    {
+        return false;
+    }
+}
+
+
+bool CachedTexture::bake (const tygra::Image& image, const Key& source, const Role role, 
+    const bool useS3TC) noexcept
+{
+    if (!image.doesContainData())
+    {
+        return false;
+    }
+
+    return bake (image.pixelData(), image.width(), image.height(), image.componentsPerPixel(), 
+        image.bytesPerComponent(), source, role, useS3TC);
+}
+
+
+bool CachedTexture::bake (const void* texels, const size_t width, const size_t height, const size_t components,
+    const size_t bytesPerComponent, const Key& source, const Role role, const bool useS3TC) noexcept
+{
+    if (!texels || width == 0 || height == 0 || components < 1 || components > 4 ||
+        (bytesPerComponent != 1 && bytesPerComponent != 2))
+    {
+        return false;
+    }
+
+    try
+    {
+        // Blocks cover 4x4 texels so only the smallest levels need padding.
+        const auto compress = width % 4 == 0 && height % 4 == 0;
+        const auto format   = blockFormat (role, components, useS3TC);
+
+        auto header                 = Header { };
+        header.magic                = magic;
+        header.version              = version;
+        header.source               = source;
+        header.width                = static_cast<std::uint32_t> (width);
+        header.height               = static_cast<std::uint32_t> (height);
+        header.components           = static_cast<std::uint32_t> (components);
+        header.bytesPerComponent    = static_cast<std::uint32_t> (bytesPerComponent);
+        header.role                 = role;
+        header.internalFormat       = compress ? compressedFormat (format) : util::internalFormat (header.components);
+        header.blockSize            = compress ? static_cast<std::uint32_t> (util::blockSize (format)) : 0;
+        header.levelCount           = static_cast<std::uint32_t> (mipmapLevels (width, height));
+        header.levelsOffset         = align (sizeof (Header));
+
+        // Calculate where each level will be stored.
+        const auto texelSize    = size_t { header.components * header.bytesPerComponent };
+        auto levels             = std::vector<Level> (header.levelCount);
+        auto offset             = align (header.levelsOffset + header.levelCount * sizeof (Level));
+
+        for (size_t i { 0 }; i < levels.size(); ++i)
+        {
+            auto& level     = levels[i];
+            level.width     = std::max (header.width >> i, 1U);
+            level.height    = std::max (header.height >> i, 1U);
+            level.offset    = offset;
+            level.size      = levelSize (level.width, level.height, texelSize, header.blockSize);
+            offset          = align (offset + level.size);
+        }
+
+        // Allocate the entry in a single block so each level can be written in place.
+        auto memory = std::vector<std::uint8_t> (offset);
+        std::memcpy (memory.data(), &header, sizeof (Header));
+        std::memcpy (memory.data() + header.levelsOffset, levels.data(), levels.size() * sizeof (Level));
+
+        // Compressed levels can't be filtered so the previous level is kept uncompressed in a scratch buffer.
+        auto scratch    = std::array<std::vector<std::uint8_t>, 2> { };
+        auto above      = static_cast<const std::uint8_t*> (texels);
+
+        for (size_t i { 0 }; i < levels.size(); ++i)
+        {
+            const auto& level   = levels[i];
+            auto current        = above;
+
+            // Each level is generated from the one above it.
+            if (i > 0)
+            {
+                auto& buffer = scratch[i % 2];
+                buffer.resize (compress ? size_t { level.width } * level.height * texelSize : 0);
+
+                const auto& previous    = levels[i - 1];
+                const auto destination  = compress ? buffer.data() : memory.data() + level.offset;
+                util::generateMipLevel (above, previous.width, previous.height, header.components, 
+                    header.bytesPerComponent, mipFilter (role), destination);
+
+                current = destination;
+            }
+
+            if (compress)
+            {
+                util::compressImage (current, level.width, level.height, header.components, header.bytesPerComponent,
+                    format, memory.data() + level.offset);
+            }
+
+            else if (i == 0)
+            {
+                std::memcpy (memory.data() + level.offset, current, level.size);
+            }
+
+            above = current;
+        }
+
+        // Save the entry so future runs can map it instead, failing to do so isn't fatal.
+        if (source.size != 0)
+        {
+            createDirectory();
+
+            const auto location = entryLocation (source, role);
+            auto file           = std::ofstream { location, std::ios::binary | std::ios::trunc };
+            file.write (reinterpret_cast<const char*> (memory.data()), static_cast<std::streamsize> (memory.size()));
+
+            if (!file.good())
+            {
+                std::cerr << "CachedTexture::bake(): Unable to save \"" << location << "\"." << std::endl;
+            }
+        }
+
+        // Finally use the built data.
+        clean();
+        m_memory = std::move (memory);
+        m_header = reinterpret_cast<const Header*> (m_memory.data());
+
+        return true;
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "CachedTexture::bake(): " << e.what() << std::endl;
+        return false;
+    }
+}
+
+
+bool CachedTexture::releaseMemory() noexcept
+{
+    if (m_memory.empty())
+    {
+        return isInitialised();
+    }
+
+    try
+    {
+        auto file = MappedFile { };
+        if (!file.initialise (entryLocation (m_header->source, m_header->role)))
+        {
+            return false;
+        }
+
+        // The saved entry may have been replaced since so it must still match the built one.
+        const auto useS3TC  = m_header->internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        const auto header   = validate (file.getData(), file.getSize(), m_header->source, m_header->role, useS3TC);
+        if (!header || header->internalFormat != m_header->internalFormat || file.getSize() != m_memory.size())
+        {
+            return false;
+        }
+
+        clean();
+        m_file      = std::move (file);
+        m_header    = header;
+
+        return true;
+    }
+
+    catch (...)
+    {
+        return false;
+    }
+}
+
+
+void CachedTexture::clean() noexcept
+{
+    m_file.clean();
+    m_memory.clear();
+    m_memory.shrink_to_fit();
+    m_header = nullptr;
+}
+
+
+std::string CachedTexture::entryLocation (const Key& source, const Role role)
+{
+    auto stream = std::ostringstream { };
+    stream << directory << "/" << std::hex << std::setfill ('0') << std::setw (16) << source.hash 
+           << "-" << static_cast<std::uint32_t> (role) << ".dmtc";
+    return stream.str();
+}
+
+
+const CachedTexture::Header* CachedTexture::validate (const void* data, const size_t size, const Key& source, 
+    const Role role, const bool useS3TC) noexcept
+{
+    // The header must exist, match our current layout and have been built from the same file for the same role. The
+    // format must also be one the context can sample.
+    if (size < sizeof (Header))
+    {
+        return nullptr;
+    }
+
+    const auto header = reinterpret_cast<const Header*> (data);
+    if (header->magic != magic || header->version != version ||
+        header->source.hash != source.hash || header->source.size != source.size || header->role != role ||
+        header->components < 1 || header->components > 4 ||
+        (header->bytesPerComponent != 1 && header->bytesPerComponent != 2) ||
+        (header->blockSize != 0 && header->blockSize != 8 && header->blockSize != 16) ||
+        (!useS3TC && header->internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ||
+        header->levelCount != static_cast<std::uint32_t> (mipmapLevels (header->width, header->height)))
+    {
+        return nullptr;
+    }
+
+    // The level table must fit inside the file.
+    const auto tableOffset = header->levelsOffset;
+    if (tableOffset % alignment != 0 || tableOffset > size || 
+        header->levelCount > (size - tableOffset) / sizeof (Level))
+    {
+        return nullptr;
+    }
+
+    // Every level must have the expected dimensions and fit inside the file.
+    const auto start        = reinterpret_cast<const std::uint8_t*> (data);
+    const auto levels       = reinterpret_cast<const Level*> (start + tableOffset);
+    const auto texelSize    = size_t { header->components * header->bytesPerComponent };
+
+    for (size_t i { 0 }; i < header->levelCount; ++i)
+    {
+        const auto& level = levels[i];
+        if (level.width != std::max (header->width >> i, 1U) || level.height != std::max (header->height >> i, 1U) ||
+            level.size != levelSize (level.width, level.height, texelSize, header->blockSize) ||
+            level.offset % alignment != 0 || level.offset > size || level.size > size - level.offset)
+        {
+            return nullptr;
+        }
+    }
+
+    return header;
+}
@@ -0,0 +1,202 @@
+#pragma once
+
+#if !defined    _RENDERING_RENDERER_MATERIALS_CACHED_TEXTURE_
+#define         _RENDERING_RENDERER_MATERIALS_CACHED_TEXTURE_
+
+// STL headers.
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+// Personal headers.
+#include <Utility/MappedFile.hpp>
+
+
+// Forward declarations.
+namespace tygra { class Image; }
+
+
+/// <summary>
+/// A texture stored in the on-disk texture cache. Each entry is named after a hash of the PNG it was decoded from and
+/// contains a header, a table of mipmap levels and then the texels of every level from the base image down to 1x1.
+/// Textures are block compressed in a format chosen by their role when their dimensions allow, otherwise texels are
+/// tightly packed. Either way levels are stored in the exact layout expected by Texture::placeAt() or
+/// Texture::placeCompressedAt() so entries are memory-mapped and each level is uploaded straight from the mapping.
+/// Entries which are missing or stale are rebuilt from the PNG.
+/// </summary>
+class CachedTexture final
+{
+    public:
+
+        constexpr static auto version = std::uint32_t { 3 }; //!< Entries of any other version must be rebuilt.
+
+        /// <summary> How the texture is used by materials, this determines how it is filtered and stored. </summary>
+        enum class Role : std::uint32_t
+        {
+            Properties  = 0,    //!< Linear material properties such as roughness, filtered as stored.
+            Albedo      = 1,    //!< sRGB colour data, filtered in linear space.
+            Normal      = 2     //!< Tangent-space normals, averaged vectors are renormalised.
+        };
+
+        /// <summary> Identifies the contents of a source file, this determines which entry should be loaded. </summary>
+        struct Key final
+        {
+            std::uint64_t   hash    { 0 };  //!< A 64-bit FNV-1a hash of the source file.
+            std::uint64_t   size    { 0 };  //!< The size of the source file in bytes, zero if it couldn't be read.
+        };
+
+        /// <summary> The header at the start of every entry. All offsets are in bytes from the file start. </summary>
+        struct Header final
+        {
+            std::array<char, 4> magic               { };    //!< Identifies the file as a cached texture.
+            std::uint32_t       version             { 0 };  //!< The version of the entry layout.
+            Key                 source              { };    //!< The source file the entry was built from.
+            std::uint32_t       width               { 0 };  //!< The width of the base level in texels.
+            std::uint32_t       height              { 0 };  //!< The height of the base level in texels.
+            std::uint32_t       components          { 0 };  //!< How many components each texel has, 1 to 4.
+            std::uint32_t       bytesPerComponent   { 0 };  //!< The size of each component, 1 or 2.
+            Role                role                { };    //!< How the mipmap levels were filtered.
+            std::uint32_t       internalFormat      { 0 };  //!< The format of the stored texels, e.g. GL_RGB8.
+            std::uint32_t       blockSize           { 0 };  //!< The bytes in each 4x4 block, zero if uncompressed.
+            std::uint32_t       levelCount          { 0 };  //!< How many mipmap levels are stored.
+            std::uint64_t       levelsOffset        { 0 };  //!< Where the level table starts.
+        };
+
+        /// <summary> An entry in the level table, describing where the texels of a single mipmap level are. </summary>
+        struct Level final
+        {
+            std::uint32_t   width   { 0 };  //!< The width of the level in texels.
+            std::uint32_t   height  { 0 };  //!< The height of the level in texels.
+            std::uint64_t   offset  { 0 };  //!< Where the texels or blocks of the level start.
+            std::uint64_t   size    { 0 };  //!< How many bytes of texel or block data the level contains.
+        };
+
+    public:
+
+        CachedTexture() noexcept                            = default;
+        CachedTexture (CachedTexture&&) noexcept            = default;
+        CachedTexture& operator= (CachedTexture&&)          = default;
+        ~CachedTexture()                                    = default;
+
+        CachedTexture (const CachedTexture&)                = delete;
+        CachedTexture& operator= (const CachedTexture&)     = delete;
+
+
+        /// <summary> Check if the entry contains valid data. </summary>
+        inline bool isInitialised() const noexcept                  { return m_header != nullptr; }
+
+        /// <summary> Gets the header of the entry. </summary>
+        inline const Header& getHeader() const noexcept             { return *m_header; }
+
+        /// <summary> Gets the start of the level table, this contains getHeader().levelCount levels. </summary>
+        const Level* getLevels() const noexcept;
+
+        /// <summary> Check if the levels are stored as compressed blocks rather than texels. </summary>
+        inline bool isCompressed() const noexcept                   { return m_header->blockSize != 0; }
+
+        /// <summary> Gets the format the texture array must be allocated with, e.g. GL_RGB8. </summary>
+        inline GLenum getInternalFormat() const noexcept            { return m_header->internalFormat; }
+
+        /// <summary> Gets the texels of the given level, this must be less than getHeader().levelCount. </summary>
+        const GLvoid* getTexels (const size_t level) const noexcept;
+
+        /// <summary> Gets the pixel format to pass to Texture::placeAt(), e.g. GL_RGB. </summary>
+        GLenum getPixelFormat() const noexcept;
+
+        /// <summary> Gets the pixel type to pass to Texture::placeAt(), e.g. GL_UNSIGNED_BYTE. </summary>
+        GLenum getPixelType() const noexcept;
+
+
+        /// <summary> Calculates how many levels a full mipmap chain has for the given dimensions. </summary>
+        static GLsizei mipmapLevels (const size_t width, const size_t height) noexcept;
+
+        /// <summary>
+        /// Hashes the contents of the given source file, claiming any prefetch. Only "content:///" URIs and local file
+        /// paths can be hashed.
+        /// </summary>
+        /// <param name="sourceLocation"> The URI given to tygra::createImageFromPngFile(). </param>
+        /// <returns> The key of the source file, the size will be zero if it couldn't be read. </returns>
+        static Key identify (const std::string& sourceLocation) noexcept;
+
+        /// <summary>
+        /// Queues the given source file with the FileService so that identify() and any decoding don't stall on the
+        /// disk. Only "content:///" URIs and local file paths can be prefetched.
+        /// </summary>
+        static void prefetchSource (const std::string& sourceLocation) noexcept;
+
+        /// <summary> Queues the cache entry for the given source key and role with the FileService. </summary>
+        static void prefetchEntry (const Key& source, const Role role) noexcept;
+
+
+        /// <summary>
+        /// Maps the cache entry for the given source key and role through the FileService, claiming any prefetch.
+        /// Entries with a different version, source or role are rejected so that they can be rebuilt, as are S3TC
+        /// entries when the context can't sample them.
+        /// Successive calls will only modify the object if successful.
+        /// </summary>
+        /// <param name="source"> The key of the source file, obtained from identify(). </param>
+        /// <param name="role"> How the texture is used, each role has a separate entry. </param>
+        /// <param name="useS3TC"> Whether the context supports GL_EXT_texture_compression_s3tc. </param>
+        /// <returns> Whether a valid entry was found and mapped. </returns>
+        bool initialise (const Key& source, const Role role, const bool useS3TC) noexcept;
+
+        /// <summary>
+        /// Builds a new entry from the given image by generating every mipmap level on the CPU and compressing each
+        /// level if the dimensions are a multiple of four, then attempts to save it to the cache for future runs. The
+        /// object will contain the built data even if the entry can't be saved.
+        /// </summary>
+        /// <param name="image"> The decoded source image. </param>
+        /// <param name="source"> The key of the source file, the entry won't be saved if the size is zero. </param>
+        /// <param name="role"> How the texture is used, this determines how levels are filtered and stored. </param>
+        /// <param name="useS3TC"> Whether BC1 may be used, otherwise colour is stored as BC7 which is core. </param>
+        /// <returns> Whether the entry was successfully built. </returns>
+        bool bake (const tygra::Image& image, const Key& source, const Role role, const bool useS3TC) noexcept;
+
+        /// <summary> Builds a new entry from tightly packed texels, see the tygra::Image overload. </summary>
+        /// <param name="texels"> The texels of the base level. </param>
+        /// <param name="width"> How many texels wide the base level is. </param>
+        /// <param name="height"> How many texels tall the base level is. </param>
+        /// <param name="components"> How many components each texel has, 1 to 4. </param>
+        /// <param name="bytesPerComponent"> The size of each component, 1 or 2. </param>
+        /// <param name="source"> The key of the source data, the entry won't be saved if the size is zero. </param>
+        /// <param name="role"> How the texture is used, this determines how levels are filtered and stored. </param>
+        /// <param name="useS3TC"> Whether BC1 may be used, otherwise colour is stored as BC7 which is core. </param>
+        /// <returns> Whether the entry was successfully built. </returns>
+        bool bake (const void* texels, const size_t width, const size_t height, const size_t components,
+            const size_t bytesPerComponent, const Key& source, const Role role, const bool useS3TC) noexcept;
+
+        /// <summary>
+        /// Replaces an entry which bake() built in memory with a mapping of the entry it saved, so the memory can be
+        /// freed once the texels are on the GPU. Mapped entries are left untouched, as are built entries whose saved
+        /// copy can't be mapped.
+        /// </summary>
+        /// <returns> Whether the entry is now mapped rather than held in memory. </returns>
+        bool releaseMemory() noexcept;
+
+        /// <summary> Unmaps and releases any stored data. </summary>
+        void clean() noexcept;
+
+    private:
+
+        MappedFile                  m_file      { };        //!< The mapped entry, if it was loaded from the cache.
+        std::vector<std::uint8_t>   m_memory    { };        //!< The built entry, if it couldn't be mapped.
+        const Header*               m_header    { nullptr };//!< Points to the start of the entry.
+
+    private:
+
+        /// <summary> Gets the location of the cache entry for the given source key and role. </summary>
+        static std::string entryLocation (const Key& source, const Role role);
+
+        /// <summary> Checks that the given memory contains a valid entry for the given source file and role. </summary>
+        /// <returns> The header of the entry if valid, otherwise nullptr. </returns>
+        static const Header* validate (const void* data, const size_t size, const Key& source, 
+            const Role role, const bool useS3TC) noexcept;
+};
+
+#endif // _RENDERING_RENDERER_MATERIALS_CACHED_TEXTURE_
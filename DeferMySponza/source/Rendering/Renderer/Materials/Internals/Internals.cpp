@@ -1,6 +1,14 @@
 #include "Internals.hpp"
 
 
+// STL headers.
+#include <algorithm>
+
+
+// Personal headers.
+#include <Utility/OpenGL/Bindless.hpp>
+
+
 GLuint Materials::Internals::maxTexture = 0;
 GLuint Materials::Internals::maxArrayDepth = 0;
 
@@ -18,15 +26,15 @@ bool Materials::Internals::isInitialised() const noexcept
         return false;
     }
 
-    for (size_t i { 0 }; i < supportedResolutionCount; ++i)
+    for (const auto& array : arrays)
     {
-        if (!rgb[i].isInitialised() || !rgba[i].isInitialised())
+        if (!array.isInitialised())
         {
             return false;
         }
     }
 
-    return true;
+    return !bindless || handleTable.isInitialised();
 }
 
 
@@ -39,13 +47,26 @@ bool Materials::Internals::initialise (const GLuint startingIndex) noexcept
 
     const auto start = startingIndex + 1;
 
-    for (GLuint i { 0 }; i < supportedResolutionCount; ++i)
+    for (GLuint i { 0 }; i < arrayCount; ++i)
+    {
+        if (!arrays[i].initialise (start + i))
+        {
+            return false;
+        }
+    }
+
+    // Arrays aren't bound when they're bindless so the handle table can take the unit of the first array.
+    bindless = util::loadBindlessTextures();
+    if (bindless)
     {
-        if (!(rgb[i].initialise (start + i ) &&
-             rgba[i].initialise (start + supportedResolutionCount + i)))
+        if (!handleTable.initialise (start))
         {
             return false;
         }
+
+        handles.fill (0);
+        handleTable.buffer.immutablyFillWith (GLsizeiptr { sizeof (handles) }, handles.data(), GL_DYNAMIC_STORAGE_BIT);
+        handleTable.specifyBufferFormat (GL_RG32UI);
     }
 
     auto integer = GLint { };
@@ -60,13 +81,27 @@ bool Materials::Internals::initialise (const GLuint startingIndex) noexcept
 
 void Materials::Internals::clean() noexcept
 {
+    waitForCopies();
     materials.clean();
 
-    for (GLuint i { 0 }; i < supportedResolutionCount; ++i)
+    for (GLuint i { 0 }; i < arrayCount; ++i)
     {
-        rgb[i].clean();
-        rgba[i].clean();
+        makeNonResident (i);
+        arrays[i].clean();
+        formats[i]  = Format { };
+        counts[i]   = 0;
+
+        auto& streaming = residency[i];
+        streaming.sources.clear();
+        streaming.pending.clean();
+        streaming.topLevel      = 0;
+        streaming.initialLevel  = 0;
+        streaming.pendingLayers = 0;
+        streaming.staged.clear();
     }
+
+    handleTable.clean();
+    bindless = false;
 }
 
 
@@ -74,27 +109,50 @@ void Materials::Internals::bind() const noexcept
 {
     glBindTextureUnit (materials.texture.getDesiredTextureUnit(), materials.texture.getID());
 
-    for (size_t i { 0 }; i < supportedResolutionCount; ++i)
+    // Resident arrays don't need binding, only the table of their handles does.
+    if (bindless)
     {
-        const auto& rgbTexture = rgb[i];
-        glBindTextureUnit (rgbTexture.getDesiredTextureUnit(), rgbTexture.getID());
-                
-        const auto& rgbaTexture = rgba[i];
-        glBindTextureUnit (rgbaTexture.getDesiredTextureUnit(), rgbaTexture.getID());
+        glBindTextureUnit (handleTable.texture.getDesiredTextureUnit(), handleTable.texture.getID());
+        return;
+    }
+
+    for (size_t i { 0 }; i < boundArrayCount; ++i)
+    {
+        glBindTextureUnit (arrays[i].getDesiredTextureUnit(), arrays[i].getID());
     }
 }
 
 
 void Materials::Internals::unbind() const noexcept
 {
-    constexpr auto arrays   = GLsizei { supportedResolutionCount * 2 };
-    constexpr auto extra    = GLsizei { 1 };
-    constexpr auto count    = arrays + extra;
+    const auto textures = static_cast<GLsizei> (bindless ? size_t { 1 } : size_t { boundArrayCount });
+    const auto extra    = GLsizei { 1 };
+    const auto count    = textures + extra;
 
     glBindTextures (materials.texture.getDesiredTextureUnit(), count, nullptr);
 }
 
 
+void Materials::Internals::waitForCopies() noexcept
+{
+    for (auto& copy : copies)
+    {
+        copy.wait();
+    }
+
+    copies.clear();
+}
+
+
+bool Materials::Internals::areStagedLayersIssued (const size_t index, const UploadQueue& uploads) const noexcept
+{
+    const auto& staged = residency[index].staged;
+    
+    return std::all_of (std::begin (staged), std::end (staged), 
+        [&] (const UploadQueue::Staging& staging) { return uploads.isIssued (staging); });
+}
+
+
 bool Materials::Internals::contains (const std::string& file) const noexcept
 {
     return ids.find (file) != std::end (ids);
@@ -103,34 +161,117 @@ bool Materials::Internals::contains (const std::string& file) const noexcept
 
 bool Materials::Internals::areDimensionsSupported (const size_t width, const size_t height) noexcept
 {
-    // Ensure more than zero, width is equal to height, is power of two and is supported range.
+    // Ensure more than zero, width is equal to height, is power of two and is supported range. This is called before
+    // the OpenGL limits are queried but OpenGL 4.5 guarantees textures of at least 16384x16384 are supported.
     return  width > 0 &&
             width == height &&
             (width & (width - 1)) == 0 &&
-            (width == 1 || (width >= minimumDimensions && width <= maximumDimensions && width <= maxTexture));
+            (width == 1 || (width >= minimumDimensions && width <= maximumDimensions));
 }
 
 
-std::pair<GLuint, Texture2DArray*> Materials::Internals::get (const size_t components, const size_t dimensions) noexcept
+std::pair<GLuint, Texture2DArray*> Materials::Internals::get (const GLenum internalFormat, 
+    const size_t dimensions) noexcept
 {
-    auto index  = size_t { 0 };
-    auto size   = minimumDimensions;
+    for (size_t i { 0 }; i < usableArrays(); ++i)
+    {
+        if (formats[i].internalFormat == internalFormat && formats[i].dimensions == dimensions)
+        {
+            return { static_cast<GLuint> (i), &arrays[i] };
+        }
+    }
+
+    return { 0, nullptr };
+}
+
 
-    // Determine the index of the array based on it's dimensions.
-    while (size <= dimensions)
+std::pair<GLuint, Texture2DArray*> Materials::Internals::allocate (const GLenum internalFormat, 
+    const size_t dimensions, const GLsizei depth, const GLsizei levels, const GLsizei topLevel) noexcept
+{
+    // Arrays are assigned in order so the first unused one is the next available.
+    const auto unused = get (0, 0);
+    const auto index  = unused.first;
+    auto array        = unused.second;
+
+    if (array)
     {
-        size *= 2;
-        ++index;
+        allocateStorage (*array, internalFormat, dimensions, depth, levels, topLevel);
+
+        formats[index].internalFormat   = internalFormat;
+        formats[index].dimensions       = dimensions;
+        residency[index].topLevel       = topLevel;
+        residency[index].initialLevel   = topLevel;
+        makeResident (index);
     }
 
-    switch (components)
+    return { index, array };
+}
+
+
+void Materials::Internals::allocateStorage (Texture2DArray& array, const GLenum internalFormat, 
+    const size_t dimensions, const GLsizei depth, const GLsizei levels, const GLsizei topLevel) noexcept
+{
+    const auto size = static_cast<GLsizei> (std::max (dimensions >> topLevel, size_t { 1 }));
+
+    array.allocateImmutableStorage (internalFormat, size, size, depth, levels - topLevel);
+    array.setParameter (GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    array.setParameter (GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    array.setParameter (GL_TEXTURE_WRAP_S, GL_REPEAT);
+    array.setParameter (GL_TEXTURE_WRAP_T, GL_REPEAT);
+}
+
+
+size_t Materials::Internals::residentSize (const size_t index, const GLsizei topLevel) const noexcept
+{
+    const auto& sources = residency[index].sources;
+    if (sources.empty())
     {
-        case 3:
-            return { static_cast<GLuint> (index), &rgb[index] };
+        return 0;
+    }
+
+    // Every layer shares the same format and dimensions so the first describes them all.
+    const auto& header  = sources.front().getHeader();
+    const auto levels   = sources.front().getLevels();
+    auto size           = size_t { 0 };
 
-        case 4:
-            return { static_cast<GLuint> (supportedResolutionCount + index), &rgba[index] };
+    for (auto level = static_cast<size_t> (topLevel); level < header.levelCount; ++level)
+    {
+        size += static_cast<size_t> (levels[level].size);
     }
 
-    return { 0, nullptr };
+    return size * sources.size();
+}
+
+
+void Materials::Internals::replace (const size_t index, Texture2DArray&& array) noexcept
+{
+    // The old handle must be released before its texture is deleted.
+    makeNonResident (index);
+    arrays[index] = std::move (array);
+    makeResident (index);
+}
+
+
+void Materials::Internals::makeResident (const size_t index) noexcept
+{
+    if (bindless)
+    {
+        handles[index] = util::makeTextureResident (arrays[index].getID());
+        handleTable.buffer.placeAt (static_cast<GLintptr> (index * sizeof (GLuint64)), handles[index]);
+    }
+}
+
+
+void Materials::Internals::makeNonResident (const size_t index) noexcept
+{
+    if (handles[index] != 0)
+    {
+        util::makeTextureNonResident (handles[index]);
+        handles[index] = 0;
+
+        if (handleTable.isInitialised())
+        {
+            handleTable.buffer.placeAt (static_cast<GLintptr> (index * sizeof (GLuint64)), handles[index]);
+        }
+    }
 }
\ No newline at end of file
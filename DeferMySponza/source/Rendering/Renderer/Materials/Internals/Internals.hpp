@@ -5,21 +5,26 @@
 
 // STL headers.
 #include <array>
+#include <future>
 #include <string>
+#include <vector>
 
 
 // Engine headers.
-#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+#include <tgl/tgl.h>
 
 
 // Personal headers.
 #include <Rendering/Composites/SamplerBuffer.hpp>
+#include <Rendering/Composites/UploadQueue.hpp>
 #include <Rendering/Renderer/Materials/Materials.hpp>
 
 
 /// <summary>
 /// Contains internal data which isn't required at run time such as the buffer containing materials and every texture
-/// array.
+/// array. When ARB_bindless_texture is available each array is made resident and shaders find it through a table of
+/// handles, otherwise the arrays are bound to consecutive texture units which limits how many can be used.
 /// </summary>
 class Materials::Internals final
 {
@@ -27,13 +32,34 @@ class Materials::Internals final
 
         constexpr static auto minimumDimensions = size_t { 64 };    //!< The minimum supported texture dimensions.
         constexpr static auto maximumDimensions = size_t { 2048 };  //!< The maximum supported texture dimensions.
-        
-        // Compile-time computation with constexpr support in VS2015 is laughable so we can't create a constexpr function to calculate this value.
-        constexpr static auto supportedResolutionCount = size_t { 8 };  //!< We store an initial texture array for 1x1 textures and 7 for dimensions between 64x64 and 2048x2048.
-
-        using Textures      = std::array<Texture2DArray, supportedResolutionCount>;
-        using TextureIDs    = std::unordered_map<std::string, glm::uvec2>;
-        using Counts        = std::unordered_map<size_t, std::unordered_map<size_t, size_t>>;
+        constexpr static auto boundArrayCount   = size_t { 16 };    //!< Must match the sampler array in the shaders.
+        constexpr static auto arrayCount        = size_t { 64 };    //!< The limit when arrays are accessed bindlessly.
+
+        /// <summary> Describes the layers stored in a texture array. </summary>
+        struct Format final
+        {
+            GLenum  internalFormat  { 0 };  //!< The format of each layer, e.g. GL_COMPRESSED_RG_RGTC2. Zero if unused.
+            size_t  dimensions      { 0 };  //!< The width and height of each layer.
+        };
+
+        /// <summary> Tracks which levels of a texture array are resident and the next level being streamed. </summary>
+        struct Residency final
+        {
+            std::vector<CachedTexture>          sources         { };    //!< The cache entry of each layer, empty if unstreamed.
+            GLsizei                             topLevel        { 0 };  //!< The most detailed resident level of the chain.
+            GLsizei                             initialLevel    { 0 };  //!< The level the array started at, the demotion limit.
+            Texture2DArray                      pending         { };    //!< Holds one more level whilst it is being uploaded.
+            size_t                              pendingLayers   { 0 };  //!< How many layers of the pending level are uploaded.
+            std::vector<UploadQueue::Staging>   staged          { };    //!< Pending layers copied through the upload queue.
+        };
+
+        using Textures      = std::array<Texture2DArray, arrayCount>;
+        using Formats       = std::array<Format, arrayCount>;
+        using Residencies   = std::array<Residency, arrayCount>;
+        using TextureIDs    = std::unordered_map<std::string, glm::uvec4>;
+        using Counts        = std::array<size_t, arrayCount>;
+        using Handles       = std::array<GLuint64, arrayCount>;
+        using Copies        = std::vector<std::future<void>>;
 
         static GLuint maxTexture;       //!< Tracks the maximum size a texture can be on the current GPU.
         static GLuint maxArrayDepth;    //!< Tracks the maximum depth of 2D texture arrays on the current GPU.
@@ -41,10 +67,15 @@ class Materials::Internals final
     public:
     
         SamplerBuffer   materials   { };    //!< The texture buffer which provides access to materials in shaders.
-        Textures        rgb         { };    //!< Contains a 2D texture array for each supported texture resolution in the RGB format.
-        Textures        rgba        { };    //!< Contains a 2D texture array for each supported texture resolution in the RGBA format.
-        TextureIDs      ids         { };    //!< Maps: File location -> texture unit index & array index.
-        Counts          counts      { };    //!< Maps: Dimensions -> Components -> number of textures.
+        Textures        arrays      { };    //!< Texture arrays which are assigned a format and dimensions on demand.
+        Formats         formats     { };    //!< The format and dimensions each texture array has been allocated with.
+        TextureIDs      ids         { };    //!< Maps: File location -> texture unit index, array index & region.
+        Counts          counts      { };    //!< How many layers of each texture array have been filled.
+        Residencies     residency   { };    //!< The mipmap levels of each texture array which are on the GPU.
+        SamplerBuffer   handleTable { };    //!< The bindless handle of each texture array, indexed like the arrays.
+        Handles         handles     { };    //!< The resident handle of each texture array, zero if not resident.
+        bool            bindless    { };    //!< Whether the arrays are accessed through handles rather than units.
+        Copies          copies      { };    //!< Workers staging pending layers, declared last so they finish first.
 
 
         Internals() noexcept { }
@@ -64,12 +95,70 @@ class Materials::Internals final
         void unbind() const noexcept;
         bool contains (const std::string& file) const noexcept;
 
+        /// <summary> Gets how many texture arrays can be used, this depends on whether they're bindless. </summary>
+        size_t usableArrays() const noexcept { return bindless ? size_t { arrayCount } : size_t { boundArrayCount }; }
+
+        /// <summary> Gets how many texture arrays the shaders expect to be bound when handles aren't used. </summary>
+        constexpr static size_t getBoundArrayCount() noexcept { return boundArrayCount; }
+
+        /// <summary> Checks whether a texture can fill an array layer by itself, others must be packed in an atlas. </summary>
         static bool areDimensionsSupported (const size_t width, const size_t height) noexcept;
 
         /// <summary> 
-        /// Retrieves the texture unit index and texture array for the given component and dimension count. 
+        /// Retrieves the texture unit index and texture array for the given internal format and dimensions. 
+        /// </summary>
+        /// <returns> The index and array, the array will be nullptr if the format hasn't been allocated. </returns>
+        std::pair<GLuint, Texture2DArray*> get (const GLenum internalFormat, const size_t dimensions) noexcept;
+
+        /// <summary>
+        /// Assigns the given format to the next unused texture array and allocates immutable storage for it. Only
+        /// the levels from the given top level down are allocated, see allocateStorage().
+        /// </summary>
+        /// <returns> The index and array, the array will be nullptr if every array is in use. </returns>
+        std::pair<GLuint, Texture2DArray*> allocate (const GLenum internalFormat, const size_t dimensions, 
+            const GLsizei depth, const GLsizei levels, const GLsizei topLevel = 0) noexcept;
+
+        /// <summary>
+        /// Allocates immutable storage for part of a mipmap chain, the given top level of the chain becomes level
+        /// zero of the array so sampling can never reach levels which aren't resident. Arrays are sampled 
+        /// trilinearly and repeat.
+        /// </summary>
+        /// <param name="array"> An initialised array without storage. </param>
+        /// <param name="internalFormat"> The format of each layer. </param>
+        /// <param name="dimensions"> The width and height of the full chain. </param>
+        /// <param name="depth"> How many layers the array has. </param>
+        /// <param name="levels"> How many levels the full chain has. </param>
+        /// <param name="topLevel"> The most detailed level of the chain to allocate. </param>
+        static void allocateStorage (Texture2DArray& array, const GLenum internalFormat, const size_t dimensions, 
+            const GLsizei depth, const GLsizei levels, const GLsizei topLevel) noexcept;
+
+        /// <summary> 
+        /// Calculates how many bytes a streamed array occupies with the given top level, zero if it isn't streamed.
         /// </summary>
-        std::pair<GLuint, Texture2DArray*> get (const size_t components, const size_t dimensions) noexcept;
+        size_t residentSize (const size_t index, const GLsizei topLevel) const noexcept;
+
+        /// <summary>
+        /// Replaces a texture array, making the new array resident and updating the handle table when bindless
+        /// textures are in use. The new array must have storage.
+        /// </summary>
+        void replace (const size_t index, Texture2DArray&& array) noexcept;
+
+        /// <summary> Waits for every worker which is staging layers, their copies may still need issuing. </summary>
+        void waitForCopies() noexcept;
+
+        /// <summary> 
+        /// Checks whether the queue has issued every staged layer of an array, its pending level can't be swapped
+        /// in or abandoned until they have been.
+        /// </summary>
+        bool areStagedLayersIssued (const size_t index, const UploadQueue& uploads) const noexcept;
+
+    private:
+
+        /// <summary> Makes an array resident and stores its handle in the table if handles are used. </summary>
+        void makeResident (const size_t index) noexcept;
+
+        /// <summary> Makes an array non-resident and clears its handle in the table. </summary>
+        void makeNonResident (const size_t index) noexcept;
 };
 
 #endif
\ No newline at end of file
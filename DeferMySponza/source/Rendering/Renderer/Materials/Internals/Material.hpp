@@ -4,19 +4,24 @@
 #define         _RENDERING_RENDERER_MATERIALS_INTERNAL_MATERIAL_
 
 // Engine headers.
-#include <glm/vec2.hpp>
+#include <glm/vec4.hpp>
 
 
 /// <summary>
-/// Contains the sampler index and physics properties, albedo and normal map of a material. The default material
-/// properties should link to default texture maps.
+/// Contains the sampler index and physics properties, albedo and normal map of a material. Each property is the sampler
+/// index, the depth and then the offset and scale of the region to sample, packed as two 16-bit normalised values each
+/// so that textures stored in an atlas only sample their own region. Properties without a texture map use 
+/// constantComponent as their sampler index and store their value as packed RGBA8 in place of the depth.
 /// </summary>
 struct Material final
 {
-    glm::uvec2  properties  { 0 };  //!< The sampler index and depth to use when looking up the physical properties of the material.
-    glm::uvec2  albedo      { 0 };  //!< The sampler index and depth to use when looking up the albedo of the material.
-    glm::uvec2  normal      { 0 };  //!< The sampler index and depth to use when looking up the normal map of the material.
-    glm::uvec2  unused      { 0 };  //!< Currently unused.
+    constexpr static auto constantComponent = glm::uvec4::value_type { 0xFFFFFFFF }; //!< Marks a constant property.
+    constexpr static auto noOffset          = glm::uvec4::value_type { 0 };          //!< Regions starting at 0, 0.
+    constexpr static auto fullScale         = glm::uvec4::value_type { 0xFFFFFFFF }; //!< Regions covering the layer.
+
+    glm::uvec4  properties  { 0 };  //!< The sampler index, depth and region to use when looking up the physical properties of the material.
+    glm::uvec4  albedo      { 0 };  //!< The sampler index, depth and region to use when looking up the albedo of the material.
+    glm::uvec4  normal      { 0 };  //!< The sampler index, depth and region to use when looking up the normal map of the material.
     
     Material() noexcept                             = default;
     Material (Material&&) noexcept                  = default;
@@ -2,22 +2,32 @@
 
 
 // STL headers.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iostream>
+#include <tuple>
 #include <utility>
 
 
 // Engine headers.
+#include <glm/packing.hpp>
+#include <glm/vec4.hpp>
 #include <tygra/FileHelper.hpp>
 
 
 // Personal headers.
 #include <Rendering/Renderer/Materials/Internals/Internals.hpp>
-#include <Utility/OpenGL/Textures.hpp>
 #include <Utility/Algorithm.hpp>
+#include <Utility/OpenGL/Textures.hpp>
 #include <Utility/Scene.hpp>
+#include <Utility/StartupTimeline.hpp>
+#include <Utility/TextureAtlas.hpp>
 
 
 // Namespaces.
-using namespace std::string_literals;
 using namespace types;
 
 
@@ -40,9 +50,7 @@ Materials::~Materials()
 
 MaterialID Materials::operator[] (const scene::MaterialId sceneID) const noexcept
 {
-    const auto result = m_materialIDs.find (sceneID);
-
-    return result != std::end (m_materialIDs) ? result->second : std::numeric_limits<MaterialID>::max();
+    return m_materialIDs.get (sceneID, std::numeric_limits<MaterialID>::max());
 }
 
 
@@ -54,17 +62,46 @@ GLint Materials::getMaterialTextureUnit() const noexcept
 
 GLint Materials::getTextureArrayStartingUnit() const noexcept
 {
-    return m_internals->rgb.front().getDesiredTextureUnit();
+    return m_internals->arrays.front().getDesiredTextureUnit();
 }
 
 
 GLint Materials::getTextureArrayCount() const noexcept
 {
-    return static_cast<GLint> (m_internals->rgb.size() + m_internals->rgba.size());
+    return static_cast<GLint> (Internals::getBoundArrayCount());
+}
+
+
+GLint Materials::getTextureHandleUnit() const noexcept
+{
+    return m_internals->handleTable.texture.getDesiredTextureUnit();
+}
+
+
+Materials::Prepared Materials::prepare (const scene::Context& scene, const bool useS3TC) const noexcept
+{
+    auto prepared = Prepared { };
+
+    // First we must obtain every material available in the scene.
+    prepared.materials = util::getAllMaterials (scene);
+
+    // Now we can read every unique texture and sort them by format.
+    const auto files    = collectFileLocations (prepared.materials);
+    prepared.textures   = openTextures (files, useS3TC, prepared.atlasPlacements);
+
+    return prepared;
 }
 
 
 bool Materials::initialise (const scene::Context& scene, const GLuint startingTextureUnit) noexcept
+{
+    // We're on the OpenGL thread so the context can be queried directly.
+    const auto useS3TC = util::isExtensionSupported ("GL_EXT_texture_compression_s3tc");
+    return initialise (prepare (scene, useS3TC), startingTextureUnit);
+}
+
+
+bool Materials::initialise (Prepared&& prepared, const GLuint startingTextureUnit) noexcept
 {
     // Create new objects.
     auto ids        = MaterialIDs { };
@@ -76,8 +113,15 @@ bool Materials::initialise (const scene::Context& scene, const GLuint startingTe
         return false;
     }
 
-    // We need to determine how much memory to allocate for the texture arrays.
-    if (!generateMaterials (ids, *internals, scene))
+    // The textures must be loaded into the GPU before the materials can reference them.
+    if (!bufferTextures (*internals, prepared.textures))
+    {
+        return false;
+    }
+
+    mapAtlasPlacements (*internals, prepared.atlasPlacements);
+
+    if (!generateMaterials (ids, *internals, prepared.materials))
     {
         return false;
     }
@@ -97,6 +141,212 @@ void Materials::clean() noexcept
 }
 
 
+void Materials::setStreamingBudget (const size_t uploadBytesPerFrame, const size_t residentBytes) noexcept
+{
+    m_uploadBudget      = uploadBytesPerFrame;
+    m_residentBudget    = residentBytes;
+}
+
+
+void Materials::streamTextures (UploadQueue& uploads) noexcept
+{
+    auto& internals = *m_internals;
+    auto& residency = internals.residency;
+    auto& copies    = internals.copies;
+    const auto none = residency.size();
+
+    // Forget about workers which have finished staging their layer.
+    copies.erase (std::remove_if (std::begin (copies), std::end (copies), [] (const std::future<void>& copy)
+    {
+        return copy.wait_for (std::chrono::seconds { 0 }) == std::future_status::ready;
+    }), std::end (copies));
+
+    // Only streamed arrays count towards the budget. A pending level is held in a complete copy of its array so
+    // both copies are resident until it is swapped in.
+    const auto pendingSize = [&] (const size_t index)
+    {
+        const auto& streaming = residency[index];
+        return streaming.pending.isInitialised() ? internals.residentSize (index, streaming.topLevel - 1) : 0;
+    };
+
+    auto resident = size_t { 0 };
+    for (size_t i { 0 }; i < residency.size(); ++i)
+    {
+        resident += internals.residentSize (i, residency[i].topLevel) + pendingSize (i);
+    }
+
+    // Compares the size of the most detailed resident level of two arrays.
+    const auto residentDimensions = [&] (const size_t index)
+    {
+        return internals.formats[index].dimensions >> residency[index].topLevel;
+    };
+
+    // Abandoning a level being streamed in, or demoting the most detailed arrays, brings us back within budget. Arrays
+    // with layers still waiting in the upload queue are left alone as the copies would target a deleted texture.
+    const auto abandon = [&] (const size_t index)
+    {
+        auto& streaming = residency[index];
+        resident -= pendingSize (index);
+
+        streaming.pending.clean();
+        streaming.pendingLayers = 0;
+        streaming.staged.clear();
+    };
+
+    while (resident > m_residentBudget)
+    {
+        auto pending = none;
+        for (size_t i { 0 }; i < residency.size() && pending == none; ++i)
+        {
+            pending = residency[i].pending.isInitialised() && internals.areStagedLayersIssued (i, uploads) ? i : none;
+        }
+
+        if (pending != none)
+        {
+            abandon (pending);
+            continue;
+        }
+
+        auto demote = none;
+        for (size_t i { 0 }; i < residency.size(); ++i)
+        {
+            const auto& streaming = residency[i];
+            if (!streaming.sources.empty() && streaming.topLevel < streaming.initialLevel &&
+                internals.areStagedLayersIssued (i, uploads) &&
+                (demote == none || residentDimensions (i) > residentDimensions (demote)))
+            {
+                demote = i;
+            }
+        }
+
+        if (demote == none)
+        {
+            break;
+        }
+
+        auto& streaming     = residency[demote];
+        auto replacement    = createResidentArray (internals, demote, streaming.topLevel + 1);
+
+        if (!replacement.isInitialised())
+        {
+            break;
+        }
+
+        abandon (demote);
+        resident -= internals.residentSize (demote, streaming.topLevel);
+        resident += internals.residentSize (demote, streaming.topLevel + 1);
+
+        internals.replace (demote, std::move (replacement));
+        ++streaming.topLevel;
+    }
+
+    // Now add detail, one layer at a time, until the upload budget has been used.
+    auto uploaded = size_t { 0 };
+
+    while (uploaded < m_uploadBudget)
+    {
+        // Continue with the level currently being streamed.
+        auto index = none;
+        for (size_t i { 0 }; i < residency.size() && index == none; ++i)
+        {
+            index = residency[i].pending.isInitialised() ? i : none;
+        }
+
+        // The new level can be sampled once every layer has been issued, until then nothing else is started.
+        if (index != none && residency[index].pendingLayers == residency[index].sources.size())
+        {
+            auto& streaming = residency[index];
+            if (!internals.areStagedLayersIssued (index, uploads))
+            {
+                break;
+            }
+
+            // The pending array is already counted so only the array it replaces is released.
+            resident -= internals.residentSize (index, streaming.topLevel);
+
+            internals.replace (index, std::move (streaming.pending));
+            streaming.pendingLayers = 0;
+            streaming.staged.clear();
+            --streaming.topLevel;
+
+            // Every level is on the GPU now, demoting copies levels between arrays so only promoting again would
+            // read the sources. Entries built in memory are swapped for their saved copies to free the memory.
+            if (streaming.topLevel == 0)
+            {
+                for (auto& source : streaming.sources)
+                {
+                    source.releaseMemory();
+                }
+            }
+
+            continue;
+        }
+
+        // Otherwise start on the least detailed array whose pending copy fits alongside it within the resident budget.
+        if (index == none)
+        {
+            for (size_t i { 0 }; i < residency.size(); ++i)
+            {
+                const auto& streaming = residency[i];
+                if (streaming.sources.empty() || streaming.topLevel == 0)
+                {
+                    continue;
+                }
+
+                const auto growth = internals.residentSize (i, streaming.topLevel - 1);
+
+                if (resident + growth <= m_residentBudget && 
+                    (index == none || residentDimensions (i) < residentDimensions (index)))
+                {
+                    index = i;
+                }
+            }
+
+            if (index == none)
+            {
+                break;
+            }
+
+            auto& streaming         = residency[index];
+            streaming.pending       = createResidentArray (internals, index, streaming.topLevel - 1);
+            streaming.pendingLayers = 0;
+            streaming.staged.clear();
+
+            if (!streaming.pending.isInitialised())
+            {
+                break;
+            }
+
+            resident += pendingSize (index);
+        }
+
+        // A full ring means the queue is behind so we'll try again next frame.
+        const auto& streaming   = residency[index];
+        const auto level        = static_cast<size_t> (streaming.topLevel - 1);
+        const auto size         = streaming.sources[streaming.pendingLayers].getLevels()[level].size;
+
+        if (!streamLayer (internals, uploads, index))
+        {
+            break;
+        }
+
+        uploaded += static_cast<size_t> (size);
+    }
+}
+
+
+void Materials::finishStreaming (UploadQueue& uploads) noexcept
+{
+    // Workers submit their copies as they finish so the queue must be processed after waiting for them.
+    m_internals->waitForCopies();
+
+    if (uploads.isInitialised())
+    {
+        uploads.process();
+    }
+}
+
+
 void Materials::bindTextures() const noexcept
 {
     m_internals->bind();
@@ -110,17 +360,8 @@ void Materials::unbindTextures() const noexcept
 
 
 bool Materials::generateMaterials (MaterialIDs& materialIDs, Internals& internals, 
-            const scene::Context& scene) const noexcept
+            const std::vector<PBSMaterial>& sceneMaterials) const noexcept
 {
-    // First we must obtain every material available in the scene.
-    const auto sceneMaterials = util::getAllMaterials (scene);
-
-    // Ensure textures load successfully before constructing the materials.
-    if (!loadTextures (internals, sceneMaterials))
-    {
-        return false;
-    }
-
     // We need to collect every generated material to load it into the GPU.
     auto materials = std::vector<Material> { };
 
@@ -136,7 +377,7 @@ bool Materials::generateMaterials (MaterialIDs& materialIDs, Internals& internal
             return false;
         }
 
-        materialIDs[sceneMaterial.id] = static_cast<MaterialID> (materials.size());
+        materialIDs.set (sceneMaterial.id, static_cast<MaterialID> (materials.size()));
         materials.emplace_back (std::move (successAndMaterial.second));
     }
 
@@ -149,194 +390,510 @@ bool Materials::generateMaterials (MaterialIDs& materialIDs, Internals& internal
 }
 
 
-bool Materials::loadTextures (Internals& internals, const std::vector<PBSMaterial>& materials) const noexcept
+Materials::FileLocations Materials::collectFileLocations (const std::vector<PBSMaterial>& materials) const noexcept
 {
-    // Firstly we need to parse the materials to retrieve unique file locations.
-    auto files = collectFileLocations (materials);
+    // We'll need a set to load strings into.
+    auto files = FileLocations { };
 
-    // Using these files we can attempt to open them and sort them by format.
-    auto textureResult = openTextures (files);
+    // Avoid duplication of code.
+    const auto addIfNotEmpty = [&] (const auto& file, const CachedTexture::Role role) 
+    { 
+        if (!file.empty()) files.emplace (file, role); 
+    };
 
-    // Ensure all textures loaded successfully.
-    if (textureResult.first)
+    // Simply interate through each material retrieving texture maps.
+    for (const auto& material : materials)
     {
-        // Now we can load the textures into the GPU.
-        return bufferTextures (internals, textureResult.second);
+        addIfNotEmpty (material.physicsMap, CachedTexture::Role::Properties);
+        addIfNotEmpty (material.albedoMap, CachedTexture::Role::Albedo);
+        addIfNotEmpty (material.normalMap, CachedTexture::Role::Normal);
     }
 
-    return false;
+    return files;
 }
 
 
-Materials::FileLocations Materials::collectFileLocations (const std::vector<PBSMaterial>& materials) const noexcept
+Materials::TexturesToBuffer Materials::openTextures (const FileLocations& files, const bool useS3TC,
+    AtlasPlacements& placements) const noexcept
 {
-    // We'll need a set to load strings into.
-    auto files = FileLocations { };
+    // Sort the files so that textures are always stored in the same order.
+    auto sortedFiles = std::vector<std::pair<std::string, CachedTexture::Role>> (std::begin (files), std::end (files));
+    std::sort (std::begin (sortedFiles), std::end (sortedFiles));
 
-    // Avoid duplication of code.
-    const auto addIfNotEmpty = [&] (const auto& file) { if (!file.empty()) files.emplace (file); };
+    // Issue every source read up front so the disk is busy whilst earlier files are hashed. Each cache entry is
+    // requested as soon as its source has been identified, before any texture is decoded.
+    for (const auto& file : sortedFiles)
+    {
+        CachedTexture::prefetchSource (file.first);
+    }
 
-    // Simply interate through each material retrieving texture maps.
-    for (const auto& material : materials)
+    auto keys = std::vector<CachedTexture::Key> (sortedFiles.size());
+    util::parallelFor (sortedFiles.size(), [&] (const size_t i)
+    {
+        keys[i] = CachedTexture::identify (sortedFiles[i].first);
+        CachedTexture::prefetchEntry (keys[i], sortedFiles[i].second);
+    });
+
+    // Mapping and especially decoding are CPU-heavy so load every texture in parallel.
+    auto textures   = std::vector<CachedTexture> (sortedFiles.size());
+    auto decoded    = AtlasCandidates (sortedFiles.size());
+    
+    util::parallelFor (sortedFiles.size(), [&] (const size_t i)
     {
-        addIfNotEmpty (material.physicsMap);
-        addIfNotEmpty (material.albedoMap);
-        addIfNotEmpty (material.normalMap);
+        // Only decode the PNG if the cache doesn't contain an up-to-date entry. Textures which can't fill a layer
+        // are only cached as part of an atlas page so they're always decoded.
+        const auto& file    = sortedFiles[i].first;
+        const auto role     = sortedFiles[i].second;
+        const auto& key     = keys[i];
+        auto& texture       = textures[i];
+
+        if (texture.initialise (key, role, useS3TC) && 
+            Internals::areDimensionsSupported (texture.getHeader().width, texture.getHeader().height))
+        {
+            return;
+        }
+
+        texture.clean();
+
+        try
+        {
+            // The source was paged in when it was identified so tygra reads it from the OS cache.
+            const auto image = tygra::createImageFromPngFile (file);
+            if (!image.doesContainData())
+            {
+                return;
+            }
+
+            if (Internals::areDimensionsSupported (image.width(), image.height()))
+            {
+                texture.bake (image, key, role, useS3TC);
+                return;
+            }
+
+            // Keep the texels so the atlas page can be built without decoding the file again.
+            auto& candidate             = decoded[i];
+            const auto texels           = static_cast<const std::uint8_t*> (image.pixelData());
+            candidate.source            = key;
+            candidate.role              = role;
+            candidate.width             = image.width();
+            candidate.height            = image.height();
+            candidate.components        = image.componentsPerPixel();
+            candidate.bytesPerComponent = image.bytesPerComponent();
+            candidate.texels.assign (texels, 
+                texels + candidate.width * candidate.height * candidate.components * candidate.bytesPerComponent);
+        }
+
+        catch (...)
+        {
+            // The texture will be reported as unreadable.
+        }
+    });
+
+    // Now sort them by dimensions and format, skipping any which can't be used.
+    auto result     = TexturesToBuffer { };
+    auto candidates = AtlasCandidates { };
+
+    for (size_t i { 0 }; i < sortedFiles.size(); ++i)
+    {
+        const auto& file    = sortedFiles[i].first;
+        auto& texture       = textures[i];
+        auto& candidate     = decoded[i];
+
+        // Textures which can't fill a layer by themselves share atlas pages instead.
+        if (!candidate.texels.empty())
+        {
+            if (!util::fitsInAtlas (candidate.width, candidate.height, atlasDimensions, atlasGutter, atlasAlignment))
+            {
+                std::cerr << "Materials::openTextures(): \"" << file << "\" has unsupported dimensions (" 
+                          << candidate.width << "x" << candidate.height << ")." << std::endl;
+                continue;
+            }
+
+            candidate.file = file;
+            candidates.emplace_back (std::move (candidate));
+            continue;
+        }
+
+        if (!texture.isInitialised())
+        {
+            std::cerr << "Materials::openTextures(): Unable to read \"" << file << "\"." << std::endl;
+            continue;
+        }
+
+        // Cache the format of the image.
+        const auto& header      = texture.getHeader();
+        const auto width        = static_cast<size_t> (header.width);
+        const auto format       = texture.getInternalFormat();
+
+        // Map it based on it's dimensions and then format.
+        auto pair = std::make_pair (file, std::move (texture));
+        result[width][format].vector.emplace_back (std::move (pair));
     }
 
-    return files;
+    packAtlases (candidates, useS3TC, result, placements);
+    return result;
 }
 
 
-std::pair<bool, Materials::TexturesToBuffer> Materials::openTextures (FileLocations& files) const noexcept
+void Materials::packAtlases (const AtlasCandidates& candidates, const bool useS3TC, TexturesToBuffer& textures, 
+    AtlasPlacements& placements) const noexcept
 {
-    // We'll need to store and modify the result.
-    auto result = std::pair<bool, TexturesToBuffer> { };
+    /// <summary> The textures sharing a page and the entry it is loaded or baked into. </summary>
+    struct Page final
+    {
+        std::vector<size_t>             members     { };    //!< The candidate index of each texture on the page.
+        std::vector<util::AtlasRegion>  regions     { };    //!< Where each member has been placed.
+        CachedTexture                   texture     { };    //!< The page itself.
+    };
 
-    // Default the result to represent failure.
-    result.first = false;
+    // Textures can only share a page if they're filtered the same way and have the same texel layout.
+    using Layout    = std::tuple<CachedTexture::Role, size_t, size_t>;
+    auto groups     = std::map<Layout, std::vector<size_t>> { };
 
-    // We need to interate through each file.
-    for (auto& file : files)
+    for (size_t i { 0 }; i < candidates.size(); ++i)
     {
-        // Attempt to load it.
-        auto image = tygra::createImageFromPngFile (file);
+        const auto& candidate = candidates[i];
+        groups[Layout { candidate.role, candidate.components, candidate.bytesPerComponent }].push_back (i);
+    }
 
-        // Cache the format of the image.
-        const auto width        = image.width();
-        const auto height       = image.height();
-        const auto components   = image.componentsPerPixel();
+    // Pack each group, every page of a group is independent.
+    auto pages = std::vector<Page> { };
 
-        // Ensure the image loaded properly and is a valid resolution.
-        if (!(image.doesContainData() && Internals::areDimensionsSupported (width, height)))
+    for (const auto& group : groups)
+    {
+        const auto& members = group.second;
+        auto sizes          = std::vector<std::pair<size_t, size_t>> { };
+
+        for (const auto member : members)
         {
-            return result;
+            sizes.emplace_back (candidates[member].width, candidates[member].height);
         }
 
-        // Map it based on it's dimensions and then component count.
-        auto pair = std::make_pair (file, std::move (image));
-        result.second[width][components].vector.emplace_back (std::move (pair));
+        auto pageCount      = size_t { 0 };
+        const auto regions  = util::packAtlas (sizes, atlasDimensions, atlasGutter, atlasAlignment, pageCount);
+        const auto first    = pages.size();
+        pages.resize (first + pageCount);
+
+        for (size_t i { 0 }; i < regions.size(); ++i)
+        {
+            auto& page = pages[first + regions[i].page];
+            page.members.push_back (members[i]);
+            page.regions.push_back (regions[i]);
+        }
     }
 
-    // We've succeeded.
-    result.first = true;
-    return result;
+    // Pages are identified by their contents so an unchanged page can be loaded from the cache without decoding.
+    const auto identify = [&] (const Page& page)
+    {
+        auto key = CachedTexture::Key { 14695981039346656037ULL, 0 };
+        const auto combine = [&] (const std::uint64_t value)
+        {
+            for (size_t i { 0 }; i < sizeof (value); ++i)
+            {
+                key.hash = (key.hash ^ ((value >> (i * 8)) & 0xFF)) * 1099511628211ULL;
+            }
+        };
+
+        combine (atlasDimensions);
+        for (size_t i { 0 }; i < page.members.size(); ++i)
+        {
+            const auto& source = candidates[page.members[i]].source;
+            const auto& region = page.regions[i];
+            combine (source.hash);
+            combine (source.size);
+            combine (region.cellX);
+            combine (region.cellY);
+            combine (region.cellWidth);
+            combine (region.cellHeight);
+            combine (region.x);
+            combine (region.y);
+
+            // Pages containing textures which couldn't be identified can't be saved.
+            key.size = source.size == 0 || (i > 0 && key.size == 0) ? 0 : key.size + source.size;
+        }
+
+        return key;
+    };
+
+    util::parallelFor (pages.size(), [&] (const size_t i)
+    {
+        auto& page          = pages[i];
+        const auto& first   = candidates[page.members.front()];
+        const auto key      = identify (page);
+
+        if (page.texture.initialise (key, first.role, useS3TC))
+        {
+            return;
+        }
+
+        try
+        {
+            // Every member of a page shares the same texel layout.
+            const auto texelSize    = first.components * first.bytesPerComponent;
+            auto texels             = std::vector<std::uint8_t> (atlasDimensions * atlasDimensions * texelSize);
+
+            for (size_t j { 0 }; j < page.members.size(); ++j)
+            {
+                const auto& member = candidates[page.members[j]];
+                util::placeInAtlas (member.texels.data(), texelSize, page.regions[j], texels.data(), atlasDimensions);
+            }
+
+            page.texture.bake (texels.data(), atlasDimensions, atlasDimensions, first.components, 
+                first.bytesPerComponent, key, first.role, useS3TC);
+        }
+
+        catch (...)
+        {
+            // Every member will be reported as unusable.
+        }
+    });
+
+    // Finally pages can be treated like any other texture.
+    for (auto& page : pages)
+    {
+        const auto name = "atlas:" + std::to_string (identify (page).hash);
+
+        for (size_t i { 0 }; i < page.members.size(); ++i)
+        {
+            const auto& file    = candidates[page.members[i]].file;
+            const auto& region  = page.regions[i];
+
+            if (!page.texture.isInitialised())
+            {
+                std::cerr << "Materials::packAtlases(): Unable to place \"" << file << "\" in an atlas." << std::endl;
+                continue;
+            }
+
+            const auto dimensions   = static_cast<float> (atlasDimensions);
+            auto& placement         = placements[file];
+            placement.page          = name;
+            placement.offset        = glm::vec2 { region.x, region.y } / dimensions;
+            placement.scale         = glm::vec2 { region.width, region.height } / dimensions;
+        }
+
+        if (page.texture.isInitialised())
+        {
+            const auto format = page.texture.getInternalFormat();
+            textures[atlasDimensions][format].vector.emplace_back (name, std::move (page.texture));
+        }
+    }
 }
 
 
 bool Materials::bufferTextures (Internals& internals, TexturesToBuffer& textures) const noexcept
 {
-    // Start by ensuring we allocate the maximum amount 1x1 textures that we can.
-    prepare1x1TextureArrays (internals);
+    const StartupTimeline::Scope step { "Materials::bufferTextures" };
 
-    // We only support 3 and 4 channels right now so other images have to converted.
-    auto extra = Images { };
+    // Uncompressed mipmap levels are tightly packed so rows smaller than 4 bytes must not be padded.
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
 
     for (auto& dimensionMap : textures)
     {
         const auto dimensions = dimensionMap.first;
 
-        for (size_t components { 1 }; components <= 4; ++components)
+        for (auto& formatMap : dimensionMap.second)
         {
             // Cache the image array.
-            auto& images            = dimensionMap.second[components];
-            const auto imageCount   = extra.vector.size() + images.vector.size();
+            const auto format   = formatMap.first;
+            auto& images        = formatMap.second;
 
-            if (imageCount == 0)
+            if (images.vector.empty())
             {
                 continue;
             }
 
-            // Check whether the current configuration has a dedicated texture unit.
-            const auto indexAndArray    = internals.get (components, dimensions);
-            const auto index            = indexAndArray.first;
-            const auto textureArray     = indexAndArray.second;
-            const auto format           = util::internalFormat (components);
-            const auto levels           = static_cast<GLsizei> (5);
+            // Each combination of format and dimensions needs its own array.
+            auto indexAndArray = internals.get (format, dimensions);
+
+            if (!indexAndArray.second)
+            {
+                // Only the smallest levels are uploaded now, streamTextures() will add the rest over time.
+                const auto count    = static_cast<GLsizei> (images.vector.size());
+                const auto levels   = CachedTexture::mipmapLevels (dimensions, dimensions);
+                const auto start    = std::min (dimensions, streamingStart);
+                const auto topLevel = levels - CachedTexture::mipmapLevels (start, start);
+                indexAndArray       = internals.allocate (format, dimensions, count, levels, topLevel);
+            }
 
-            if (textureArray)
+            // There are a fixed number of arrays, more with bindless textures, so materials will have to use their
+            // uniform values.
+            if (!indexAndArray.second)
             {
-                // Allocate enough data if the textures aren't 1x1.
-                if (dimensions != 1)
+                for (const auto& image : images.vector)
                 {
-                    const auto dim      = static_cast<GLsizei> (dimensions);
-                    const auto count    = static_cast<GLsizei> (imageCount); 
-                    textureArray->allocateImmutableStorage (format, dim, dim, count, levels);
-                    textureArray->setParameter (GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                    textureArray->setParameter (GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-                    textureArray->setParameter (GL_TEXTURE_WRAP_S, GL_REPEAT);
-                    textureArray->setParameter (GL_TEXTURE_WRAP_T, GL_REPEAT);
+                    std::cerr << "Materials::bufferTextures(): No texture arrays are available for \"" 
+                              << image.first << "\"." << std::endl;
                 }
-                    
-                addTexturesToArray (internals, *textureArray, index, dimensions, components, images);
-                addTexturesToArray (internals, *textureArray, index, dimensions, components, extra);
-                extra.vector.clear();
 
-                // Now generate mipmaps.
-                textureArray->generateMipmap();
+                continue;
             }
 
-            // If we don't have a texture array for this configuration then use the next.
-            else
-            {
-                extra.vector.reserve (imageCount);
-                std::for_each (images.vector, [&] (auto& a) { extra.vector.emplace_back (std::move (a)); });
-                images.vector.clear();
-            }
+            addTexturesToArray (internals, *indexAndArray.second, indexAndArray.first, images);
         }
+    }
+
+    glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+    return true;
+}
+
 
-        // Some unsupported images slipped through the cracks, this should never happen.
-        if (extra.vector.size() > 0)
+void Materials::addTexturesToArray (Internals& internals, Texture2DArray& array, const GLuint arrayIndex, 
+            Images& images) const noexcept
+{
+    // We need to increment the count once we've uploaded the images.
+    auto& count     = internals.counts[arrayIndex];
+    auto& streaming = internals.residency[arrayIndex];
+    const auto top  = static_cast<size_t> (streaming.topLevel);
+
+    for (auto& loadedImage : images.vector)
+    {
+        // Cache useful values.
+        const auto& fileLocation    = loadedImage.first;
+        auto& texture               = loadedImage.second;
+        const auto layer            = static_cast<GLint> (count);
+
+        // Upload every resident mipmap level straight from the cache.
+        for (auto level = top; level < texture.getHeader().levelCount; ++level)
         {
-            return false;
+            uploadLevel (array, layer, texture, level, static_cast<GLsizei> (level - top));
+        }
+
+        // Set the index of the image.
+        internals.ids[fileLocation] = { arrayIndex, static_cast<GLuint> (count++), GLuint { Material::noOffset }, 
+                                        GLuint { Material::fullScale } };
+
+        // Finally keep the texture if more levels will be streamed in.
+        if (streaming.initialLevel > 0)
+        {
+            streaming.sources.emplace_back (std::move (texture));
         }
     }
+}
 
-    return true;
+
+void Materials::mapAtlasPlacements (Internals& internals, const AtlasPlacements& placements) const noexcept
+{
+    for (const auto& filePlacement : placements)
+    {
+        const auto& placement = filePlacement.second;
+
+        // Pages which didn't fit in the available arrays have already been reported.
+        if (internals.contains (placement.page))
+        {
+            auto id = internals.ids[placement.page];
+            id.z    = glm::packUnorm2x16 (placement.offset);
+            id.w    = glm::packUnorm2x16 (placement.scale);
+
+            internals.ids[filePlacement.first] = id;
+        }
+    }
 }
 
 
-void Materials::prepare1x1TextureArrays (Internals& internals) const noexcept
+void Materials::uploadLevel (Texture2DArray& array, const GLint layer, const CachedTexture& texture, 
+    const size_t sourceLevel, const GLsizei level) const noexcept
 {
-    // Firstly, we need to find out how many items we can store.
-    const auto depth = Internals::getMaxArrayDepth();
+    const auto& source  = texture.getLevels()[sourceLevel];
+    const auto width    = static_cast<GLsizei> (source.width);
+    const auto height   = static_cast<GLsizei> (source.height);
+    const auto depth    = GLsizei { 1 };
+    const auto texels   = texture.getTexels (sourceLevel);
+
+    if (texture.isCompressed())
+    {
+        const auto size = static_cast<GLsizei> (source.size);
+        array.placeCompressedAt (0, 0, layer, width, height, depth, texture.getInternalFormat(), size, texels, level);
+    }
 
-    // Now allocate memory.
-    internals.rgb.front().allocateImmutableStorage (util::internalFormat (3), 1, 1, depth, 1);
-    internals.rgba.front().allocateImmutableStorage (util::internalFormat (4), 1, 1, depth, 1);
+    else
+    {
+        array.placeAt (0, 0, layer, width, height, depth, texture.getPixelFormat(), texture.getPixelType(), texels, 
+            level);
+    }
 }
 
 
-void Materials::addTexturesToArray (Internals& internals, Texture2DArray& array, const GLuint arrayIndex, 
-            const size_t dimensions, const size_t components, const Images& images) const noexcept
+bool Materials::streamLayer (Internals& internals, UploadQueue& uploads, const size_t index) const noexcept
 {
-    // We need to increment the count once we've uploaded the images.
-    auto& count = internals.counts[dimensions][components];
+    auto& streaming     = internals.residency[index];
+    const auto layer    = static_cast<GLint> (streaming.pendingLayers);
+    const auto level    = static_cast<size_t> (streaming.topLevel - 1);
+    const auto& texture = streaming.sources[streaming.pendingLayers];
+    const auto& source  = texture.getLevels()[level];
+    const auto size     = static_cast<GLsizeiptr> (source.size);
+
+    // Without a ring large enough to stage the layer we have to upload it directly. Cached levels are tightly packed
+    // so rows smaller than 4 bytes must not be padded.
+    if (!uploads.isInitialised() || size > uploads.getCapacity())
+    {
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+        uploadLevel (streaming.pending, layer, texture, level, 0);
+        glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
 
-    for (const auto& loadedImage : images.vector)
+        ++streaming.pendingLayers;
+        return true;
+    }
+
+    const auto staging = uploads.reserve (size);
+    if (!staging.isValid())
     {
-        // Cache useful values.
-        const auto& fileLocation    = loadedImage.first;
-        const auto& image           = loadedImage.second;
+        return false;
+    }
 
-        // Maps components to pixel formats.
-        constexpr GLenum pixelFormats[] = { 0, GL_RED, GL_RG, GL_RGB, GL_RGBA };
+    auto region     = UploadQueue::TextureRegion { };
+    region.texture  = streaming.pending.getID();
+    region.z        = layer;
+    region.width    = static_cast<GLsizei> (source.width);
+    region.height   = static_cast<GLsizei> (source.height);
+    region.format   = texture.isCompressed() ? texture.getInternalFormat() : texture.getPixelFormat();
+    region.type     = texture.isCompressed() ? GLenum { 0 } : texture.getPixelType();
+
+    // Reading the texels may fault in pages of the cache file so the copy happens on a worker. The cache entry stays
+    // alive until the workers have been waited on.
+    const auto texels = texture.getTexels (level);
+    internals.copies.push_back (std::async (std::launch::async, [&uploads, staging, region, texels]
+    {
+        std::memcpy (staging.pointer, texels, static_cast<size_t> (staging.size));
+        uploads.copyToTexture (staging, region);
+    }));
 
-        // Each image should take up an entire layer.
-        const auto x        = GLint { 0 };
-        const auto y        = GLint { 0 };
-        const auto z        = static_cast<GLint> (count);
-        const auto size     = static_cast<GLsizei> (dimensions);
-        const auto depth    = GLsizei { 1 };
-        const auto format   = pixelFormats[image.componentsPerPixel()];
-        const auto type     = image.bytesPerComponent() == 1 ? GL_UNSIGNED_BYTE : GL_UNSIGNED_SHORT;
+    streaming.staged.push_back (staging);
+    ++streaming.pendingLayers;
+    return true;
+}
 
-        // Upload the image data.
-        array.placeAt (x, y, z, size, size, depth, format, type, image.pixelData());
 
-        // Finally set the index of the image.
-        internals.ids[fileLocation] = { arrayIndex, static_cast<GLuint> (count++) };
+Texture2DArray Materials::createResidentArray (Internals& internals, const size_t index, 
+    const GLsizei topLevel) const noexcept
+{
+    const auto& current     = internals.arrays[index];
+    const auto& format      = internals.formats[index];
+    const auto& streaming   = internals.residency[index];
+    const auto& source      = streaming.sources.front();
+    const auto levels       = static_cast<GLsizei> (source.getHeader().levelCount);
+    const auto depth        = static_cast<GLsizei> (streaming.sources.size());
+
+    auto array = Texture2DArray { };
+    if (!array.initialise (current.getDesiredTextureUnit()))
+    {
+        return array;
     }
+
+    Internals::allocateStorage (array, format.internalFormat, format.dimensions, depth, levels, topLevel);
+
+    // Levels are numbered from the top level of each array.
+    for (auto level = std::max (topLevel, streaming.topLevel); level < levels; ++level)
+    {
+        const auto& dimensions  = source.getLevels()[level];
+        const auto width        = static_cast<GLsizei> (dimensions.width);
+        const auto height       = static_cast<GLsizei> (dimensions.height);
+
+        glCopyImageSubData (current.getID(), GL_TEXTURE_2D_ARRAY, level - streaming.topLevel, 0, 0, 0,
+                            array.getID(), GL_TEXTURE_2D_ARRAY, level - topLevel, 0, 0, 0,
+                            width, height, depth);
+    }
+
+    return array;
 }
 
 
@@ -348,67 +905,30 @@ std::pair<bool, Material> Materials::generateMaterial (Internals& internals, con
     // This is how properties will be set.
     const auto setProperty = [&] (auto& set, const auto& map, const auto& uniform)
     {
-        // Use the map if one has been provided. If the map doesn't exist we wouldn't have made it to this point.
-        if (!map.empty())
+        // Use the map if one has been provided and it loaded successfully.
+        if (!map.empty() && internals.contains (map))
         {
             set = internals.ids[map];
+            return;
         }
 
-        // We'll need to construct an ID for the uniform and potentially buffer the uniform.
-        else
+        // Otherwise the uniform value is packed into the material itself, missing components are opaque like an
+        // RGB texture would be.
+        auto packed = GLuint { 0xFF000000 };
+        for (size_t i { 0 }; i < uniform.size(); ++i)
         {
-            // The ID should be each component with a space between.
-            auto id = ""s;
-            for (const auto component : uniform)
-            {
-                id += std::to_string (component) + " ";
-            }
-
-            // It's already been generated so use that index.
-            if (internals.contains (id))
-            {
-                set = internals.ids[id];
-            }
-
-            // Add the uniform value manually.
-            else
-            {
-                // Maps components to pixel formats.
-                constexpr GLenum pixelFormats[] = { 0, GL_RED, GL_RG, GL_RGB, GL_RGBA };
-
-                // Retrieve the array.
-                const auto indexAndArray    = internals.get (uniform.size(), 1);
-                const auto index            = indexAndArray.first;
-                auto& array                 = *indexAndArray.second;
-
-                // Ensure we aren't going over the maximum depth.
-                auto& count = internals.counts[1][uniform.size()];
-
-                if (count == Internals::getMaxArrayDepth())
-                {
-                    return false;
-                }
-
-                // Place the uniform values at the end.
-                array.placeAt (0, 0, static_cast<GLint> (count), 1, 1, 1, 
-                    pixelFormats[uniform.size()], GL_UNSIGNED_BYTE, uniform.data());
-
-                // Finally add the ID.
-                set                 = { index, static_cast<GLuint> (count++) };
-                internals.ids[id]   = set;
-            }
+            const auto shift = static_cast<GLuint> (i * 8);
+            packed = (packed & ~(GLuint { 0xFF } << shift)) | (static_cast<GLuint> (uniform[i]) << shift);
         }
 
-        return true;
+        set = { GLuint { Material::constantComponent }, packed, GLuint { Material::noOffset }, 
+                GLuint { Material::fullScale } };
     };
 
     // Set each property.
-    if (setProperty (material.properties, sceneMaterial.physicsMap, sceneMaterial.physics) &&
-        setProperty (material.albedo, sceneMaterial.albedoMap, sceneMaterial.albedo) &&
-        setProperty (material.normal, sceneMaterial.normalMap, sceneMaterial.normal))
-    {
-        return { true, material };
-    }
+    setProperty (material.properties, sceneMaterial.physicsMap, sceneMaterial.physics);
+    setProperty (material.albedo, sceneMaterial.albedoMap, sceneMaterial.albedo);
+    setProperty (material.normal, sceneMaterial.normalMap, sceneMaterial.normal);
 
-    return { false, Material { } };
+    return { true, material };
 }
\ No newline at end of file
@@ -4,26 +4,28 @@
 #define         _RENDERING_RENDERER_MATERIALS_
 
 // STL headers.
+#include <cstdint>
+#include <map>
 #include <memory>
+#include <string>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 
 // Engine headers.
 #include <tgl/tgl.h>
+#include <glm/vec2.hpp>
 #include <scene/scene_fwd.hpp>
-#include <tygra/Image.hpp>
 
 
 // Personal headers.
+#include <Rendering/Composites/UploadQueue.hpp>
+#include <Rendering/Renderer/Materials/CachedTexture.hpp>
 #include <Rendering/Renderer/Materials/Internals/Material.hpp>
 #include <Rendering/Renderer/Types.hpp>
 #include <Rendering/Objects/Texture.hpp>
-
-
-// Forward declarations.
-struct PBSMaterial;
+#include <Utility/DenseIDMap.hpp>
+#include <Utility/Scene.hpp>
 
 
 /// <summary>
@@ -32,6 +34,11 @@ struct PBSMaterial;
 /// </summary>
 class Materials final
 {
+    public:
+
+        /// <summary> The CPU-side data required to initialise the materials. </summary>
+        struct Prepared;
+
     public:
 
         Materials() noexcept;
@@ -54,9 +61,23 @@ class Materials final
         /// <summary> Retrieves the texture unit of the first texture array. </summary>
         GLint getTextureArrayStartingUnit() const noexcept;
 
-        /// <summary> Retrieves the total number of texture arrays. </summary>
+        /// <summary> Retrieves how many texture arrays are bound when bindless textures aren't in use. </summary>
         GLint getTextureArrayCount() const noexcept;
 
+        /// <summary> Retrieves the texture unit of the buffer containing the handle of each texture array. </summary>
+        GLint getTextureHandleUnit() const noexcept;
+
+
+        /// <summary>
+        /// Performs the CPU-only part of initialisation; interpreting every scene material, reading each texture and
+        /// sorting them by format. No OpenGL calls are made so this may be called on a worker thread.
+        /// </summary>
+        /// <param name="scene"> Contains every material in the scene. </param>
+        /// <param name="useS3TC"> 
+        /// Whether the context supports S3TC, query util::isExtensionSupported() on the OpenGL thread beforehand.
+        /// </param>
+        /// <returns> The data required by initialise(). </returns>
+        Prepared prepare (const scene::Context& scene, const bool useS3TC) const noexcept;
 
         /// <summary> 
         /// Constructs every material in the scene, including loading every texture and mapping scene::MaterialId 
@@ -67,71 +88,197 @@ class Materials final
         /// <returns> Whether initialisation was successful or not. </returns>
         bool initialise (const scene::Context& scene, const GLuint startingTextureUnit) noexcept;
 
+        /// <summary> 
+        /// Constructs every material using data from prepare(), uploading each texture and material to the GPU.
+        /// Successive calls will not change the object unless initialisation is successful.
+        /// </summary>
+        /// <param name="prepared"> The result of calling prepare(), the textures will be moved from it. </param>
+        /// <param name="startingTextureUnit"> The initial index to apply to stored textures. </param>
+        /// <returns> Whether initialisation was successful or not. </returns>
+        bool initialise (Prepared&& prepared, const GLuint startingTextureUnit) noexcept;
+
         /// <summary> Destroys every stored object and returns to a clean state. </summary>
         void clean() noexcept;
 
 
-        /// <summary> Binds every texture unit with its associated texture. </summary>
+        /// <summary> 
+        /// Binds every texture unit with its associated texture. Bindless texture arrays are already resident so only
+        /// the material buffer and handle table are bound.
+        /// </summary>
         void bindTextures() const noexcept;
 
         /// <summary> Unbind every texture, leaving their associated texture units in a clean state. </summary>
         void unbindTextures() const noexcept;
 
+
+        /// <summary>
+        /// Sets how much texture data may be streamed each frame and how much memory streamed textures may occupy.
+        /// Textures will be demoted by streamTextures() if they occupy more than the given resident budget. Whilst a
+        /// level is being streamed in, its array and the copy holding the extra level both count towards the budget.
+        /// </summary>
+        /// <param name="uploadBytesPerFrame"> The upload limit, a single layer may exceed it. Zero pauses. </param>
+        /// <param name="residentBytes"> How many bytes every streamed texture array may occupy in total. </param>
+        void setStreamingBudget (const size_t uploadBytesPerFrame, const size_t residentBytes) noexcept;
+
+        /// <summary>
+        /// Texture arrays start with only their smallest levels resident. Each call uploads more detail within the
+        /// upload budget, one level of one array at a time starting with the least detailed array, and demotes the
+        /// most detailed arrays if the resident budget is exceeded. Arrays may be replaced so this must be called
+        /// before bindTextures().
+        /// </summary>
+        /// <param name="uploads"> 
+        /// Layers are copied into the queue by workers, a level is swapped in once the queue has issued every layer.
+        /// Layers are uploaded directly if the queue isn't initialised or a layer is larger than the ring.
+        /// </param>
+        void streamTextures (UploadQueue& uploads) noexcept;
+
+        /// <summary>
+        /// Waits for workers staging texture layers and issues their copies so the arrays can be safely replaced or
+        /// deleted. This must be called before clean() when textures have been streamed through the given queue.
+        /// </summary>
+        void finishStreaming (UploadQueue& uploads) noexcept;
+
     private:
 
         class Internals;
 
-        using MaterialIDs   = std::unordered_map<scene::MaterialId, types::MaterialID>;
+        using MaterialIDs   = DenseIDMap<scene::MaterialId, types::MaterialID>;
         using Pimpl         = std::unique_ptr<Internals>;
 
-        MaterialIDs     m_materialIDs   { };    //!< Maps scene material IDs to stored GPU material IDs.
-        Pimpl           m_internals     { };    //!< A pointer to internal managed data.
+        constexpr static auto streamingStart        = size_t { 64 };                //!< Initially resident level size.
+        constexpr static auto defaultUploadBudget   = size_t { 4 * 1024 * 1024 };   //!< Streamed bytes per frame.
+        constexpr static auto defaultResidentBudget = size_t { 256 * 1024 * 1024 }; //!< Streamed bytes in total.
+        constexpr static auto atlasDimensions       = size_t { 2048 };              //!< The size of atlas pages.
+        constexpr static auto atlasGutter           = size_t { 8 };                 //!< The minimum atlas gutter.
+        constexpr static auto atlasAlignment        = size_t { 64 };                //!< Atlas cells align to this.
+
+        MaterialIDs     m_materialIDs       { };                        //!< Maps scene IDs to GPU material IDs.
+        Pimpl           m_internals         { };                        //!< A pointer to internal managed data.
+        size_t          m_uploadBudget      { defaultUploadBudget };    //!< How many bytes may be streamed per frame.
+        size_t          m_residentBudget    { defaultResidentBudget };  //!< How many bytes may be resident.
 
     private:
 
         /// <summary> This can't be an alias because Visual Studio truncates long symbol names. </summary>
         struct Images final
         {
-            using ImageWithID = std::pair<std::string, tygra::Image>;
+            using ImageWithID = std::pair<std::string, CachedTexture>;
             std::vector<ImageWithID> vector { };
         };
         
-        using FileLocations     = std::unordered_set<std::string>;
+        /// <summary> Where a texture has been placed in an atlas page, as a fraction of the page dimensions. </summary>
+        struct AtlasPlacement final
+        {
+            std::string page    { };    //!< The location used for the page in the texture IDs.
+            glm::vec2   offset  { 0 };  //!< Where the texture starts.
+            glm::vec2   scale   { 1 };  //!< How much of the page the texture covers.
+        };
+
+        /// <summary> A decoded texture which must share an atlas page as it can't fill a layer. </summary>
+        struct AtlasCandidate final
+        {
+            std::string                 file                { };    //!< The location of the source file.
+            CachedTexture::Key          source              { };    //!< Identifies the contents of the source file.
+            CachedTexture::Role         role                { };    //!< How the texture is used.
+            size_t                      width               { 0 };  //!< How many texels wide the texture is.
+            size_t                      height              { 0 };  //!< How many texels tall the texture is.
+            size_t                      components          { 0 };  //!< How many components each texel has.
+            size_t                      bytesPerComponent   { 0 };  //!< The size of each component.
+            std::vector<std::uint8_t>   texels              { };    //!< The tightly packed texels, empty if unused.
+        };
+
+        using FileLocations     = std::unordered_map<std::string, CachedTexture::Role>;
         using Dimensions        = size_t;
-        using Components        = size_t;
-        using TexturesToBuffer  = std::unordered_map<Dimensions, std::unordered_map<Components, Images>>;
+        using InternalFormat    = GLenum;
+        using TexturesToBuffer  = std::map<Dimensions, std::map<InternalFormat, Images>>;
+        using AtlasPlacements   = std::unordered_map<std::string, AtlasPlacement>;
+        using AtlasCandidates   = std::vector<AtlasCandidate>;
 
-        /// <summary> Generates the material data in the scene. </summary>
+        /// <summary> Generates the GPU data for each given material, textures must have been buffered. </summary>
         bool generateMaterials (MaterialIDs& materialIDs, Internals& internals, 
-            const scene::Context& scene) const noexcept;
+            const std::vector<PBSMaterial>& sceneMaterials) const noexcept;
 
         /// <summary> 
-        /// Performs a pass through the given materials list, loading all textures in the scene, allocating enough
-        /// memory in the texture arrays and finally loading the images into their respective arrays.
+        /// Iterates through the list of materials, collecting every texture map file location and how it is used. If
+        /// a file is used in multiple ways then the first use is kept.
         /// </summary>
-        bool loadTextures (Internals& internals, const std::vector<PBSMaterial>& materials) const noexcept;
-
-        /// <summary> Iterates through the list of materials, collecting every texture map file location. </summary>
         FileLocations collectFileLocations (const std::vector<PBSMaterial>& materials) const noexcept;
 
         /// <summary> 
-        /// Goes through the given set of file locations, loading each into a tygra::Image and mapping it based on its
-        /// components and dimensions. 
+        /// Goes through the given set of file locations in parallel, loading each from the texture cache and mapping
+        /// it based on its dimensions and internal format. Textures without a valid cache entry are decoded and added
+        /// to the cache, unless they can't fill a layer by themselves; those are kept decoded and packed into atlas
+        /// pages instead. Files which can't be used are reported and skipped, within each format images are stored
+        /// in file location order.
+        /// </summary>
+        /// <param name="files"> Every texture to be opened. </param>
+        /// <param name="useS3TC"> Whether textures may be stored in the formats of the S3TC extension. </param>
+        /// <param name="placements"> Textures which have been packed into an atlas page are added here. </param>
+        /// <returns> Every usable texture and atlas page, sorted by dimensions and then internal format. </returns>
+        TexturesToBuffer openTextures (const FileLocations& files, const bool useS3TC, 
+            AtlasPlacements& placements) const noexcept;
+
+        /// <summary>
+        /// Packs textures which can't fill an array layer by themselves into atlas pages, grouped by how they're used
+        /// and their texel layout. Pages are loaded from the texture cache when possible, otherwise the decoded
+        /// textures are placed with gutters which wrap around their edges and the page is baked like any other texture.
         /// </summary>
-        std::pair<bool, TexturesToBuffer> openTextures (FileLocations& files) const noexcept;
+        /// <param name="candidates"> The decoded textures to be packed. </param>
+        /// <param name="useS3TC"> Whether pages may be stored in the formats of the S3TC extension. </param>
+        /// <param name="textures"> Each page is added here like a texture of the page dimensions. </param>
+        /// <param name="placements"> The page and region of each packed texture is added here. </param>
+        void packAtlases (const AtlasCandidates& candidates, const bool useS3TC, TexturesToBuffer& textures, 
+            AtlasPlacements& placements) const noexcept;
 
-        /// <summary> Loads the given textures into texture arrays stored on the GPU. </summary>
+        /// <summary> 
+        /// Loads the given textures into texture arrays stored on the GPU, allocating an array for each combination of
+        /// dimensions and internal format. Textures which don't fit in the available arrays are reported and skipped.
+        /// </summary>
         bool bufferTextures (Internals& internals, TexturesToBuffer& textures) const noexcept;
 
-        /// <summary> Allocates memory for 2048 textures in the 1x1 array and adds default data. </summary>
-        void prepare1x1TextureArrays (Internals& internals) const noexcept;
-
-        /// <summary> Adds all of the given images to the given texture array, also updates the texture IDs. </summary>
+        /// <summary> 
+        /// Adds every resident mipmap level of the given images to the given texture array, also updates the texture
+        /// IDs. Images added to streamed arrays are moved into the array's residency so levels can be added later.
+        /// </summary>
         void addTexturesToArray (Internals& internals, Texture2DArray& array, const GLuint arrayIndex, 
-            const size_t dimensions, const size_t components, const Images& images) const noexcept;
+            Images& images) const noexcept;
+
+        /// <summary> Gives each texture placed in an atlas the layer of its page and the region it occupies. </summary>
+        void mapAtlasPlacements (Internals& internals, const AtlasPlacements& placements) const noexcept;
 
-        /// <summary> Constructs a new material from the given scene material. </summary>
+        /// <summary> Uploads a level of the given texture to a level of a layer in the given array. </summary>
+        void uploadLevel (Texture2DArray& array, const GLint layer, const CachedTexture& texture, 
+            const size_t sourceLevel, const GLsizei level) const noexcept;
+
+        /// <summary>
+        /// Stages the next layer of the pending level of a streamed array, copying it into the upload queue on a 
+        /// worker. The layer is uploaded directly if the queue can never hold it.
+        /// </summary>
+        /// <returns> Whether the layer was dispatched, false if the ring is full and it should be retried later. </returns>
+        bool streamLayer (Internals& internals, UploadQueue& uploads, const size_t index) const noexcept;
+
+        /// <summary>
+        /// Creates a replacement for a streamed texture array with a different top level. Levels which both arrays
+        /// contain are copied on the GPU, any extra levels are left for the caller to upload.
+        /// </summary>
+        /// <returns> The new array, this will be uninitialised if it couldn't be created. </returns>
+        Texture2DArray createResidentArray (Internals& internals, const size_t index, 
+            const GLsizei topLevel) const noexcept;
+
+        /// <summary> 
+        /// Constructs a new material from the given scene material. Properties without a loaded texture map store
+        /// their uniform value in the material instead.
+        /// </summary>
         std::pair<bool, Material> generateMaterial (Internals& internals, const PBSMaterial& sceneMaterial) const noexcept;
 };
 
+
+/// <summary> The result of Materials::prepare(), ready to be uploaded on the OpenGL thread. </summary>
+struct Materials::Prepared final
+{
+    std::vector<PBSMaterial>    materials       { };    //!< Every material in the scene.
+    TexturesToBuffer            textures        { };    //!< Every usable texture, sorted by dimensions and format.
+    AtlasPlacements             atlasPlacements { };    //!< Where textures packed into atlas pages are stored.
+};
+
 #endif // _RENDERING_RENDERER_MATERIALS_
\ No newline at end of file
@@ -13,6 +13,8 @@ using namespace std::string_literals;
 
 // Definitions.
 const auto pbsDefines       = "content:///Shaders/Defines/PhysicallyBasedShading.glsl"s;
+const auto bindlessDefines  = "content:///Shaders/Defines/BindlessTextures.glsl"s;
+const auto compactDefines   = "content:///Shaders/Defines/CompactVertices.glsl"s;
 const auto SMAAVSDefines    = "content:///Shaders/Defines/SMAAVertexShader.glsl"s;
 const auto SMAAFSDefines    = "content:///Shaders/Defines/SMAAFragmentShader.glsl"s;
 
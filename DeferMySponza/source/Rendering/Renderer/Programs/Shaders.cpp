@@ -7,22 +7,37 @@
 
 // Personal headers.
 #include <Rendering/Renderer/Programs/HardCodedShaders.hpp>
+#include <Utility/FileService.hpp>
+#include <Utility/OpenGL/Bindless.hpp>
 
 
 // Initialise the static variable.
 const Shader Shaders::default = Shader { };
 
 
-bool Shaders::initialise (const bool usePhysicallyBasedShaders) noexcept
+bool Shaders::initialise (const bool usePhysicallyBasedShaders, const bool useCompactVertices) noexcept
 {
     // TODO: Load shaders from configuration file.
+    const auto useBindlessTextures = util::loadBindlessTextures();
+    prefetchSources (usePhysicallyBasedShaders, useBindlessTextures, useCompactVertices);
+
     bool success = true;
     const auto compileShader = [&] (const auto shaderType, const auto& main, auto&&... strings)
     {
         success = compile (shaderType, main, std::forward<decltype (strings)> (strings)...) && success;
     };
     
-    compileShader (GL_VERTEX_SHADER, geometryVS);
+    // Compact vertices only change how normals are read, positions are dequantised by the model transform.
+    if (useCompactVertices)
+    {
+        compileShader (GL_VERTEX_SHADER, geometryVS, compactDefines);
+    }
+
+    else
+    {
+        compileShader (GL_VERTEX_SHADER, geometryVS);
+    }
+
     compileShader (GL_VERTEX_SHADER, shadowMapVS);
     compileShader (GL_VERTEX_SHADER, fullScreenTriangleVS);
     compileShader (GL_VERTEX_SHADER, lightVolumeVS);
@@ -31,7 +46,17 @@ bool Shaders::initialise (const bool usePhysicallyBasedShaders) noexcept
     compileShader (GL_FRAGMENT_SHADER, geometryFS);
     compileShader (GL_FRAGMENT_SHADER, lightingPassFS);
     compileShader (GL_FRAGMENT_SHADER, lightsFS);
-    compileShader (GL_FRAGMENT_SHADER, materialFetcherFS);
+    
+    // Materials make texture arrays resident when the extension is available, see Materials::Internals.
+    if (useBindlessTextures)
+    {
+        compileShader (GL_FRAGMENT_SHADER, materialFetcherFS, bindlessDefines);
+    }
+
+    else
+    {
+        compileShader (GL_FRAGMENT_SHADER, materialFetcherFS);
+    }
     
     if (usePhysicallyBasedShaders)
     {
@@ -47,6 +72,42 @@ bool Shaders::initialise (const bool usePhysicallyBasedShaders) noexcept
 }
 
 
+void Shaders::prefetchSources (const bool usePhysicallyBasedShaders, const bool useBindlessTextures,
+    const bool useCompactVertices) noexcept
+{
+    // Queue every source file in the order it'll be compiled so that reads overlap with compilation.
+    auto& files = FileService::instance();
+
+    for (const auto& source : { geometryVS, shadowMapVS, fullScreenTriangleVS, lightVolumeVS, forwardRenderFS,
+        geometryFS, lightingPassFS, lightsFS, materialFetcherFS, reflectionModelsFS })
+    {
+        files.prefetchText (source, FileService::Priority::Normal);
+    }
+
+    if (usePhysicallyBasedShaders)
+    {
+        files.prefetchText (pbsDefines, FileService::Priority::Normal);
+    }
+
+    if (useBindlessTextures)
+    {
+        files.prefetchText (bindlessDefines, FileService::Priority::Normal);
+    }
+
+    if (useCompactVertices)
+    {
+        files.prefetchText (compactDefines, FileService::Priority::Normal);
+    }
+
+    // SMAA shaders are compiled later on so they can be read at a lower priority.
+    for (const auto& source : { SMAAVSDefines, SMAAFSDefines, SMAAUberShader, edgeDetectionVS, blendingWeightVS,
+        neighborhoodBlendingVS, edgeDetectionFS, blendingWeightFS, neighborhoodBlendingFS })
+    {
+        files.prefetchText (source);
+    }
+}
+
+
 const Shader& Shaders::find (const std::string& fileLocation) const noexcept
 {
     const auto iterator = compiled.find (fileLocation);
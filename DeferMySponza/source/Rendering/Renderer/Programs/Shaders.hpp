@@ -41,11 +41,13 @@ class Shaders final
 
 
         /// <summary> 
-        /// Initialise available shaders. This is currently loaded using hard coded filenames.
+        /// Initialise available shaders. This is currently loaded using hard coded filenames. The material fetcher
+        /// uses bindless textures when the current context supports them.
         /// </summary>
         /// <param name="usePhysicallyBasedShader"> Determines how the reflection model shader is compiled. </param>
+        /// <param name="useCompactVertices"> Whether the geometry shader should read CompactVertex normals. </param>
         /// <returns> Whether the initialisation was successful. </returns>
-        bool initialise (const bool usePhysicallyBasedShaders) noexcept;
+        bool initialise (const bool usePhysicallyBasedShaders, const bool useCompactVertices) noexcept;
 
         /// <summary> Discards and marks all shaders for deletion. They won't be deleted until detached from all programs. </summary>
         inline void clean() noexcept { compiled.clear(); }
@@ -73,6 +75,10 @@ class Shaders final
 
     private:
 
+        /// <summary> Queues every hard coded source file to be read in the background before compilation starts. </summary>
+        void prefetchSources (const bool usePhysicallyBasedShaders, const bool useBindlessTextures,
+            const bool useCompactVertices) noexcept;
+
         /// <summary> Attaches each given source file location to the given shader. </summary>
         template <typename Source, typename ExtraSource, typename... Args>
         bool attachShaderSource (Shader& shader, Source&& mainSource, 
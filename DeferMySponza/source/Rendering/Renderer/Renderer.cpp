@@ -2,15 +2,21 @@
 
 
 // STL headers.
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <future>
+#include <iostream>
+#include <unordered_set>
+#include <vector>
 
 
 // Engine headers.
 #ifdef _NVTX
 #include <nvToolsExt.h>
 #endif
+#include <glm/geometric.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <scene/scene.hpp>
 
@@ -29,7 +35,10 @@
 #include <Rendering/Renderer/Uniforms/Components/PointLight.hpp>
 #include <Rendering/Renderer/Uniforms/Components/Spotlight.hpp>
 #include <Utility/Algorithm.hpp>
+#include <Utility/InitialisationScheduler.hpp>
+#include <Utility/OpenGL/Textures.hpp>
 #include <Utility/Scene.hpp>
+#include <Utility/StartupTimeline.hpp>
 
 
 // Namespaces.
@@ -37,13 +46,123 @@ using namespace std::chrono_literals;
 using namespace types;
 
 
+// Constants.
+constexpr auto startupTimelineFile = "startup_timeline.json"; //!< Where the startup timeline is written once resident.
+
+
+namespace
+{
+    /// <summary> Projects the bounds of instances onto the screen so their level of detail can be selected. </summary>
+    struct LevelProjection final
+    {
+        glm::vec3   camera      { 0.f };    //!< The world-space position of the camera.
+        float       pixelScale  { 0.f };    //!< How many pixels a world-space unit covers one unit in front of the camera.
+        float       nearPlane   { 0.f };    //!< The closest an instance can be to the camera.
+
+        LevelProjection (const scene::Context& scene, const Resolution& resolution) noexcept
+        {
+            const auto& sceneCamera = scene.getCamera();
+            const auto fieldOfView  = glm::radians (sceneCamera.getVerticalFieldOfViewInDegrees());
+
+            camera      = util::toGLM (sceneCamera.getPosition());
+            pixelScale  = resolution.internalHeight / (2.f * std::tan (fieldOfView / 2.f));
+            nearPlane   = sceneCamera.getNearPlaneDistance();
+        }
+
+        /// <summary> Calculates how many pixels an object-space unit covers at the nearest point of the bounds. </summary>
+        float pixelsPerUnit (const InstanceBounds& bounds) const noexcept
+        {
+            const auto distance = std::max (glm::distance (bounds.centre, camera) - bounds.radius, nearPlane);
+            return bounds.scale * pixelScale / distance;
+        }
+    };
+
+
+    /// <summary>
+    /// Collects draw commands whilst levels of detail are selected. Commands for 16-bit elements are kept separately
+    /// so they can be written first. Consecutive instances which select the same level share a command per part.
+    /// </summary>
+    struct CommandList final
+    {
+        std::vector<MultiDrawElementsIndirectCommand>   shortCommands   { };    //!< Commands using 16-bit elements.
+        std::vector<MultiDrawElementsIndirectCommand>   wideCommands    { };    //!< Commands using 32-bit elements.
+
+        /// <summary> Adds a command for each part of a level, every part shares the same instances. </summary>
+        void add (const MeshLevels::Parts& parts, const GLuint baseInstance, const GLuint instanceCount)
+        {
+            for (const auto& part : parts)
+            {
+                auto& commands = part.elementType == GL_UNSIGNED_SHORT ? shortCommands : wideCommands;
+                commands.emplace_back (part.elementCount, instanceCount, part.elementsIndex, part.verticesIndex, 
+                    baseInstance);
+            }
+        }
+
+        /// <summary> Adds commands for contiguous instances of a mesh, selecting the level of each instance. </summary>
+        /// <param name="pixelsPerUnit"> How many pixels an object-space unit of each instance covers on screen. </param>
+        /// <param name="maxPixelError"> How many pixels the error of a selected level may cover. </param>
+        void add (const MeshLevels& mesh, const GLuint baseInstance, const GLuint instanceCount, 
+            const float* pixelsPerUnit, const float maxPixelError)
+        {
+            if (instanceCount == 0 || mesh.levels.size() == 1)
+            {
+                add (mesh.levels.front(), baseInstance, instanceCount);
+                return;
+            }
+
+            auto first = GLuint { 0 };
+            auto level = mesh.selectLevel (pixelsPerUnit[0], maxPixelError);
+
+            for (GLuint i { 1 }; i <= instanceCount; ++i)
+            {
+                const auto next = i < instanceCount ? mesh.selectLevel (pixelsPerUnit[i], maxPixelError) : level;
+                if (i == instanceCount || next != level)
+                {
+                    add (mesh.levels[level], baseInstance + first, i - first);
+                    first = i;
+                    level = next;
+                }
+            }
+        }
+
+        /// <summary> 
+        /// Writes the commands into the given partition of the draw command buffer, 16-bit commands first, and 
+        /// prepares them for drawing. Commands beyond the capacity of the buffer are dropped.
+        /// </summary>
+        ModifiedRange write (MultiDrawCommands<PMB>& drawing, const size_t partition) const noexcept
+        {
+            const auto capacity = static_cast<size_t> (drawing.capacity);
+            const auto shorts   = std::min (shortCommands.size(), capacity);
+            const auto wides    = std::min (wideCommands.size(), capacity - shorts);
+            const auto commands = (MultiDrawElementsIndirectCommand*) drawing.buffer.pointer (partition);
+
+            assert (shorts + wides == shortCommands.size() + wideCommands.size());
+            std::copy (std::begin (shortCommands), std::begin (shortCommands) + shorts, commands);
+            std::copy (std::begin (wideCommands), std::begin (wideCommands) + wides, commands + shorts);
+
+            drawing.start       = drawing.buffer.partitionOffset (partition);
+            drawing.shortCount  = static_cast<GLsizei> (shorts);
+            drawing.count       = static_cast<GLsizei> (shorts + wides);
+
+            return 
+            { 
+                static_cast<GLintptr> (drawing.start), 
+                static_cast<GLsizei> (sizeof (MultiDrawElementsIndirectCommand) * drawing.count) 
+            };
+        }
+    };
+}
+
+
 struct Renderer::ASyncActions final
 {
     using Action                = std::future<ModifiedRange>;
+    using StaticObjectAction    = std::future<ModifiedStaticObjectRanges>;
     using DynamicObjectAction   = std::future<ModifiedDynamicObjectRanges>;
     using LightVolumeAction     = std::future<ModifiedLightVolumeRanges>;
 
     Action              sceneUniforms, shadowUniforms, lightDrawCommands, directionalLights;
+    StaticObjectAction  staticObjects;
     DynamicObjectAction dynamicObjects;
     LightVolumeAction   pointLights, spotLights;
     
@@ -66,6 +185,7 @@ struct Renderer::ASyncActions final
         waitIfValid (shadowUniforms);
         waitIfValid (lightDrawCommands);
         waitIfValid (directionalLights);
+        waitIfValid (staticObjects);
         waitIfValid (dynamicObjects);
         waitIfValid (pointLights);
         waitIfValid (spotLights);
@@ -137,66 +257,74 @@ void Renderer::setDisplayResolution (const glm::ivec2& resolution) noexcept
 
 bool Renderer::initialise (scene::Context* scene, const glm::ivec2& internalRes, const glm::ivec2& displayRes) noexcept
 {   
+    // Each initialisation records its own timeline, phases from a previous initialisation would be reported again.
+    StartupTimeline::instance().clear();
+
     // Make sure we keep a reference to the scene.
     m_scene = scene;
 
     // Ensure we initialise the query objects!
     std::for_each (m_queries, [] (auto& query) { query.initialise (GL_TIME_ELAPSED); });
 
-    // Programs can be built immediately.
-    if (!buildPrograms())
-    {
-        return false;
-    }
+    // The scene geometry pack doesn't depend on the scene having loaded so it can be mapped or baked straight away.
+    m_geometryPack = std::async (std::launch::async, &Geometry::loadPack);
 
-    // Same with materials.
-    if (!buildMaterials())
-    {
-        return false;
-    }
+    // CPU-only preparation runs on worker threads whilst this thread creates OpenGL objects. Stages are consumed in
+    // order so each stage can depend on the ones before it.
+    auto scheduler = InitialisationScheduler { };
 
-    // And dynamic object buffers.
-    if (!buildDynamicObjectBuffers())
-    {
-        return false;
-    }
+    // Programs can be built immediately, the file service reads shader sources in the background.
+    scheduler.add ("Renderer::buildPrograms", [this] { return buildPrograms(); });
 
-    // Aaaaaand light object buffers.
-    if (!buildLightBuffers())
-    {
-        return false;
-    }
+    // Streamed textures and scene geometry are copied to the GPU through the upload ring.
+    scheduler.add ("UploadQueue::initialise", [this] { return m_uploads.initialise(); });
 
-    // With materials and instancing buffers done we can build the geometry.
-    if (!buildGeometry())
-    {
-        return false;
-    }
+    // Materials are available as soon as the scene has been constructed, their textures are decoded on a worker. The
+    // worker can't query the context so compressed format support is checked here.
+    const auto useS3TC = util::isExtensionSupported ("GL_EXT_texture_compression_s3tc");
+    scheduler.add ("Materials::prepare", 
+        [this, useS3TC] { return m_materials.prepare (*m_scene, useS3TC); },
+        [this] (Materials::Prepared&& prepared) { return buildMaterials (std::move (prepared)); });
+
+    // Aaaaaand light object buffers.
+    scheduler.add ("Renderer::buildLightBuffers", [this] { return buildLightBuffers(); });
 
     // Set the resolutions.
-    setInternalResolution (internalRes);
-    setDisplayResolution (displayRes);
+    scheduler.add ("Renderer::setResolution", [this, internalRes, displayRes]
+    {
+        setInternalResolution (internalRes);
+        setDisplayResolution (displayRes);
+        return true;
+    });
 
     // We can safely build the framebuffers now.
-    if (!buildFramebuffers())
-    {
-        return false;
-    }
+    scheduler.add ("Renderer::buildFramebuffers", [this] { return buildFramebuffers(); });
 
     // With the framebuffers and materials built we can build the uniforms.
-    if (!buildUniforms())
+    scheduler.add ("Renderer::buildUniforms", [this] { return buildUniforms(); });
+
+    // Now that we have our framebuffers we can prepare for antialiasing.
+    scheduler.add ("Renderer::buildSMAA", [this] { return buildSMAA(); });
+
+    if (!scheduler.run())
     {
         return false;
     }
 
-    // Now that we have our framebuffers we can prepare for antialiasing.
-    if (!buildSMAA())
+    // The scene may still be loading its meshes and instances, if so they'll be made resident when rendering.
+    m_residency = Residency::Loading;
+    if (m_scene->isFullyLoaded())
     {
-        return false;
+        if (!buildSceneResources())
+        {
+            m_residency = Residency::Failed;
+            return false;
+        }
+
+        completeResidency();
     }
 
     // Finally we've succeeded my lord!
-    fillDynamicInstances();
     return true;
 }
 
@@ -205,8 +333,12 @@ void Renderer::clean() noexcept
 {
     m_programs.clean();
     m_dynamics.clear();
+    m_materials.finishStreaming (m_uploads);
     m_materials.clean();
+    m_staticDrawing.buffer.clean();
+    m_staticShadows.buffer.clean();
     m_objectDrawing.buffer.clean();
+    m_objectShadows.buffer.clean();
     m_objectMaterialIDs.clean();
     m_objectTransforms.clean();
     m_lightDrawing.buffer.clean();
@@ -217,42 +349,139 @@ void Renderer::clean() noexcept
     m_shadowMaps.clean();
     m_smaa.clean();
     m_geometry.clean();
+    m_uploads.clean();
+    m_geometryPack              = { };
     m_scene                     = nullptr;
     m_resolution.internalWidth  = 0;
     m_resolution.internalHeight = 0;
     m_resolution.displayWidth   = 0;
     m_resolution.displayHeight  = 0;
     m_deferredRender            = true;
+    m_residency                 = Residency::Loading;
     std::for_each (m_syncs, [] (auto& sync) { sync.clean(); });
     std::for_each (m_queries, [] (auto& query) { query.clean(); });
     resetFrameTimings();
 }
 
 
+void Renderer::updateResidency() noexcept
+{
+    switch (m_residency)
+    {
+        case Residency::Loading:
+        {
+            // Neither the scene nor the geometry pack are waited on, we'll check again next frame.
+            const auto packReady = !m_geometryPack.valid() || 
+                m_geometryPack.wait_for (0s) == std::future_status::ready;
+
+            if (!m_scene->isFullyLoaded() || !packReady)
+            {
+                return;
+            }
+
+            // A failure is permanent so it must not cause the whole scene to be rebuilt every frame.
+            if (!buildSceneResources())
+            {
+                std::cerr << "Renderer::updateResidency(): Unable to make the scene resident." << std::endl;
+                m_residency = Residency::Failed;
+                return;
+            }
+
+            m_residency = Residency::Geometry;
+            return;
+        }
+
+        // Static objects have been drawn for a frame so dynamic objects can be added.
+        case Residency::Geometry:
+            completeResidency();
+            return;
+
+        default:
+            return;
+    }
+}
+
+
+bool Renderer::buildSceneResources() noexcept
+{
+    const StartupTimeline::Scope phase { "Renderer::buildSceneResources" };
+
+    // Textures may have been streamed whilst the scene was loading, their workers hold space in the upload ring which
+    // the geometry is about to be staged through.
+    m_materials.finishStreaming (m_uploads);
+
+    // Dynamic instances are only collected once the rest of the scene is resident.
+    m_dynamics.clear();
+
+    // The dynamic object buffers depend on the instances being available.
+    if (!buildDynamicObjectBuffers())
+    {
+        return false;
+    }
+
+    // With materials and instancing buffers done we can build the geometry.
+    if (!buildGeometry())
+    {
+        return false;
+    }
+
+    // Static draw commands depend on how the geometry batched static instances.
+    return buildStaticObjectBuffers();
+}
+
+
+void Renderer::completeResidency() noexcept
+{
+    {
+        const StartupTimeline::Scope phase { "Renderer::fillDynamicInstances" };
+        fillDynamicInstances();
+    }
+
+    // Startup is complete once the scene is resident so we can report where the time went.
+    auto& timeline = StartupTimeline::instance();
+    timeline.stop();
+    timeline.printSummary();
+    timeline.writeJSON (startupTimelineFile);
+
+    // Finally we've succeeded my lord!
+    m_residency = Residency::Resident;
+}
+
+
 bool Renderer::buildPrograms() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildPrograms" };
+
     // Firstly we must compile the shaders.
     auto shaders = Shaders { };
     
-    if (!shaders.initialise (m_pbs))
     {
-        return false;
+        const StartupTimeline::Scope step { "Shaders::initialise" };
+        if (!shaders.initialise (m_pbs, compactVertices))
+        {
+            return false;
+        }
     }
 
     // Next we can link the shaders together to create programs.
+    const StartupTimeline::Scope step { "Programs::initialise" };
     return m_programs.initialise (shaders);
 }
 
 
-bool Renderer::buildMaterials() noexcept
+bool Renderer::buildMaterials (Materials::Prepared&& prepared) noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildMaterials" };
+
     // As simple as initialising the materials.
-    return m_materials.initialise (*m_scene, materialsStartingTextureUnit);
+    return m_materials.initialise (std::move (prepared), materialsStartingTextureUnit);
 }
 
 
 bool Renderer::buildDynamicObjectBuffers() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildDynamicObjectBuffers" };
+
     // We need to find out how many dynamic instances there are.
     const auto& instances = m_scene->getAllInstances();
 
@@ -276,21 +505,26 @@ bool Renderer::buildDynamicObjectBuffers() noexcept
 
     // Initialise the objects with the correct memory values.
     if (!(m_objectDrawing.buffer.initialise (drawCommandSize, false, false) &&
+        m_objectShadows.buffer.initialise (drawCommandSize, false, false) &&
         m_objectMaterialIDs.initialise (materialIDSize, false, false) && 
         m_objectTransforms.initialise (transformSize, false, false)))
     {
         return false;
     }
 
-    // Now set up the draw buffer and we're done.
-    m_objectDrawing.capacity    = static_cast<GLuint> (uniqueMeshes.size());
+    // Now set up the draw buffers and we're done.
+    m_objectDrawing.capacity    = static_cast<GLsizei> (uniqueMeshes.size());
     m_objectDrawing.count       = 0;
+    m_objectShadows.capacity    = m_objectDrawing.capacity;
+    m_objectShadows.count       = 0;
     return true;
 }
 
 
 bool Renderer::buildLightBuffers() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildLightBuffers" };
+
     // We need to count the amount of lights that exist.
     const auto& point   = m_scene->getAllPointLights();
     const auto& spot    = m_scene->getAllSpotLights();
@@ -318,6 +552,8 @@ bool Renderer::buildLightBuffers() noexcept
 
 bool Renderer::buildGeometry() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildGeometry" };
+
     // We need to collate the static instances first.
     const auto& instances   = m_scene->getAllInstances();
     auto staticInstances    = std::map<scene::MeshId, std::vector<scene::Instance>> { };
@@ -330,13 +566,48 @@ bool Renderer::buildGeometry() noexcept
         }
     });
 
+    // The pack will have been loading on a worker thread since initialisation started.
+    const auto pack = m_geometryPack.valid() ? m_geometryPack.get() : Geometry::loadPack();
+
     // Now we can try to initialise the geometry object.
-    return m_geometry.initialise (m_materials, staticInstances, m_objectMaterialIDs, m_objectTransforms, m_lightTransforms);
+    return m_geometry.initialise (pack, m_uploads, compactVertices, m_materials, staticInstances, 
+        m_objectMaterialIDs, m_objectTransforms, m_lightTransforms);
+}
+
+
+bool Renderer::buildStaticObjectBuffers() noexcept
+{
+    const StartupTimeline::Scope phase { "Renderer::buildStaticObjectBuffers" };
+
+    // In the worst case every instance selects a different level to its neighbours so needs its own commands.
+    auto commands = size_t { 0 };
+    for (const auto& batch : m_geometry.getStaticBatches())
+    {
+        commands += batch.instanceCount * batch.mesh->maxParts();
+    }
+
+    // Empty buffers can't be created so we need room for at least one command.
+    const auto drawCommandSize = static_cast<GLsizeiptr> (std::max (commands, size_t { 1 }) * 
+        sizeof (MultiDrawElementsIndirectCommand));
+
+    if (!(m_staticDrawing.buffer.initialise (drawCommandSize, false, false) &&
+        m_staticShadows.buffer.initialise (drawCommandSize, false, false)))
+    {
+        return false;
+    }
+
+    m_staticDrawing.capacity    = static_cast<GLsizei> (commands);
+    m_staticDrawing.count       = 0;
+    m_staticShadows.capacity    = m_staticDrawing.capacity;
+    m_staticShadows.count       = 0;
+    return true;
 }
 
 
 bool Renderer::buildFramebuffers() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildFramebuffers" };
+
     // We need width and height values to initialise with.
     const auto width    = m_resolution.internalWidth;
     const auto height   = m_resolution.internalHeight;
@@ -349,6 +620,8 @@ bool Renderer::buildFramebuffers() noexcept
 
 bool Renderer::buildUniforms() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildUniforms" };
+
     // Make sure the uniforms build correctly.
     if (!m_uniforms.initialise (m_gbuffer, m_shadowMaps, m_materials))
     {
@@ -363,6 +636,8 @@ bool Renderer::buildUniforms() noexcept
 
 bool Renderer::buildSMAA() noexcept
 {
+    const StartupTimeline::Scope phase { "Renderer::buildSMAA" };
+
     if (!m_smaa.initialise (m_smaaQuality, m_resolution.internalWidth, m_resolution.internalHeight,
        smaaStartingTextureUnit, false))
     {
@@ -379,10 +654,16 @@ void Renderer::fillDynamicInstances() noexcept
     m_dynamics.clear();
     m_dynamics.reserve (sceneMeshes.size());
 
-    for (const auto& pair : sceneMeshes)
+    sceneMeshes.forEach ([&] (const scene::MeshId id, const MeshLevels& mesh)
     {
+        // Meshes without elements have nothing to draw.
+        if (mesh.empty())
+        {
+            return;
+        }
+
         // Retrieve the instances for the current mesh.
-        const auto instances = m_scene->getInstancesByMeshId (pair.first);
+        const auto instances = m_scene->getInstancesByMeshId (id);
 
         // We only want the dynamic instance IDs.
         auto dynamicIDs = std::vector<scene::InstanceId> { };
@@ -401,17 +682,53 @@ void Renderer::fillDynamicInstances() noexcept
         // Finally add the mesh if necessary.
         if (dynamicIDs.size() > 0)
         {
-            m_dynamics.emplace_back (pair.second, std::move (dynamicIDs));
+            m_dynamics.emplace_back (mesh, std::move (dynamicIDs));
         }
-    }
+    });
 
     // Finally remove any excess memory in the dynamic container.
     m_dynamics.shrink_to_fit();
+
+    // Each part needs its own draw command. In the worst case every instance selects a different level to its
+    // neighbours so needs its own commands.
+    auto commands = size_t { 0 };
+    forEachDynamicMesh ([&] (const auto, const MeshLevels& mesh, const MeshInstances::Instances& instances)
+    {
+        commands += instances.size() * mesh.maxParts();
+    });
+
+    // The buffers were created with a single command for each mesh which may not be enough.
+    if (commands > static_cast<size_t> (m_objectDrawing.capacity))
+    {
+        const auto drawCommandSize = static_cast<GLsizeiptr> (commands * sizeof (MultiDrawElementsIndirectCommand));
+        if (m_objectDrawing.buffer.initialise (drawCommandSize, false, false) &&
+            m_objectShadows.buffer.initialise (drawCommandSize, false, false))
+        {
+            m_objectDrawing.capacity    = static_cast<GLsizei> (commands);
+            m_objectShadows.capacity    = m_objectDrawing.capacity;
+        }
+    }
 }
 
 
 void Renderer::render() noexcept
 {
+    // Each frame makes more of the scene resident, only what is resident will be drawn.
+    updateResidency();
+
+    // The lighting volumes and scene VAOs belong to the geometry so without it there is nothing to draw. Texture
+    // detail keeps streaming in meanwhile.
+    if (m_residency != Residency::Geometry && m_residency != Residency::Resident)
+    {
+        m_uploads.process();
+        m_materials.streamTextures (m_uploads);
+
+        glBindFramebuffer (GL_FRAMEBUFFER, 0);
+        glViewport (0, 0, m_resolution.displayWidth, m_resolution.displayHeight);
+        glClear (GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        return;
+    }
+
     #ifdef _NVTX
         nvtxRangePush (L"Entire Draw");
         nvtxRangePush (L"Checking Fence Sync");
@@ -463,6 +780,7 @@ void Renderer::render() noexcept
 
     // Now execute the asynchonous tasks.
     actions.sceneUniforms       = std::async (policy, [&]() { return updateSceneUniforms(); });
+    actions.staticObjects       = std::async (policy, [&]() { return updateStaticObjects(); });
     actions.dynamicObjects      = std::async (policy, [&]() { return updateDynamicObjects(); });
     actions.directionalLights   = std::async (policy, [&]() { return updateDirectionalLights (directional); });
     actions.pointLights         = std::async (policy, [&]() { return updatePointLights (point); });
@@ -487,7 +805,10 @@ void Renderer::render() noexcept
         nvtxRangePush (L"Binding Textures");
     #endif
 
-    // Now perform universal rendering actions. Start by ensuring each material texture unit is bound.
+    // Now perform universal rendering actions. Issue the copies workers have staged since the last frame, then
+    // stream in more texture detail before binding each material texture unit as arrays may have been replaced.
+    m_uploads.process();
+    m_materials.streamTextures (m_uploads);
     m_materials.bindTextures();
 
     #ifdef _NVTX
@@ -496,20 +817,20 @@ void Renderer::render() noexcept
         nvtxRangePush (L"Preparing for Static Objects");
     #endif
 
-    // We need to configure the scene VAO for rendering static objects.
+    // Shadow maps only need positions so they're drawn with the depth-only VAO, configured for static objects.
     auto& sceneVAO = m_geometry.getSceneVAO();
-    sceneVAO.useStaticBuffers();
+    auto& depthVAO = m_geometry.getDepthVAO();
+    depthVAO.useStaticBuffers();
 
     // Ensure the VAO is bound.
-    const auto vaoBinder = VertexArrayBinder { sceneVAO.vao };
+    const auto vaoBinder = VertexArrayBinder { depthVAO.vao };
 
     // Start by generating shadow maps for spotlights in the scene.
     PassConfigurator::shadowMapPass();
     ProgramBinder::bind (m_programs.shadowMapPass);
 
-    // We only need to update the scene uniforms at this stage.
-    const auto& staticObjects = m_geometry.getStaticGeometryCommands();
-    BufferBinder<GL_DRAW_INDIRECT_BUFFER>::bind (staticObjects.buffer);
+    // Static objects select their level of detail each frame so their draw commands need updating too.
+    BufferBinder<GL_DRAW_INDIRECT_BUFFER>::bind (m_staticShadows.buffer.getID());
 
     #ifdef _NVTX
         nvtxRangePop();
@@ -520,12 +841,16 @@ void Renderer::render() noexcept
     m_uniforms.notifyModifiedDataRange (actions.sceneUniforms.get());
     m_uniforms.notifyModifiedDataRange (actions.shadowUniforms.get());
 
+    const auto staticRanges = actions.staticObjects.get();
+    m_staticDrawing.buffer.notifyModifiedDataRange (staticRanges.drawCommands);
+    m_staticShadows.buffer.notifyModifiedDataRange (staticRanges.shadowCommands);
+
     #ifdef _NVTX
         nvtxRangePop();
         nvtxRangePush (L"Static Object Shadow Pass");
     #endif
 
-    m_shadowMaps.generateMaps (true, [&] () { staticObjects.drawWithoutBinding(); });
+    m_shadowMaps.generateMaps (true, [&] () { m_staticShadows.drawWithoutBinding(); });
 
     #ifdef _NVTX
         nvtxRangePop();
@@ -533,22 +858,23 @@ void Renderer::render() noexcept
     #endif
 
     // We must prepare for drawing dynamic objects.
-    sceneVAO.useDynamicBuffers<multiBuffering> (m_partition);
+    depthVAO.useDynamicBuffers<multiBuffering> (m_partition);
 
     const auto objectRanges = actions.dynamicObjects.get();
     m_objectDrawing.buffer.notifyModifiedDataRange (objectRanges.drawCommands);
+    m_objectShadows.buffer.notifyModifiedDataRange (objectRanges.shadowCommands);
     m_objectMaterialIDs.notifyModifiedDataRange (objectRanges.materialIDs);
     m_objectTransforms.notifyModifiedDataRange (objectRanges.transforms);
 
     // Generate shadow maps for dynamic objects.
-    BufferBinder<GL_DRAW_INDIRECT_BUFFER>::bind (m_objectDrawing.buffer.getID());
+    BufferBinder<GL_DRAW_INDIRECT_BUFFER>::bind (m_objectShadows.buffer.getID());
 
     #ifdef _NVTX
         nvtxRangePop();
         nvtxRangePush (L"Dynamic Object Shadow Pass");
     #endif
 
-    m_shadowMaps.generateMaps (false, [&] () { m_objectDrawing.drawWithoutBinding(); });
+    m_shadowMaps.generateMaps (false, [&] () { m_objectShadows.drawWithoutBinding(); });
 
     #ifdef _NVTX
         nvtxRangePop();
@@ -556,8 +882,10 @@ void Renderer::render() noexcept
         nvtxRangePush (L"Binding Shadow Maps");
     #endif
 
-    // Now prepare for rendering the scene again.
+    // Now prepare for rendering the scene again with every vertex attribute.
+    depthVAO.useStaticBuffers();
     sceneVAO.useStaticBuffers();
+    vaoBinder.bind (sceneVAO.vao);
 
     // Ensure we reset the viewport and bind the shadow maps.
     const auto shadowMaps = TextureBinder { m_shadowMaps.getShadowMaps() };
@@ -570,7 +898,7 @@ void Renderer::render() noexcept
             nvtxRangePush (L"Deferred Render");
         #endif
 
-        deferredRender (staticObjects, sceneVAO, actions);
+        deferredRender (m_staticDrawing, sceneVAO, actions);
     }
 
     else
@@ -580,7 +908,7 @@ void Renderer::render() noexcept
             nvtxRangePush (L"Forward Render");
         #endif
 
-        forwardRender (staticObjects, sceneVAO, actions);
+        forwardRender (m_staticDrawing, sceneVAO, actions);
     }
 
     // Render to the screen performing antialiasing if necessary.
@@ -660,7 +988,7 @@ void Renderer::syncWithGPUIfNecessary() noexcept
 }
 
 
-void Renderer::deferredRender (const MultiDrawCommands<Buffer>& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept
+void Renderer::deferredRender (const DrawCommands& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept
 {
     #ifdef _NVTX
         nvtxRangePush (L"Binding Program/Framebuffer/Indirect");
@@ -815,7 +1143,7 @@ void Renderer::deferredRender (const MultiDrawCommands<Buffer>& staticObjects, S
 }
 
 
-void Renderer::forwardRender (const MultiDrawCommands<Buffer>& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept
+void Renderer::forwardRender (const DrawCommands& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept
 {
     #ifdef _NVTX
         nvtxRangePush (L"Binding Program/Framebuffer/Indirect");
@@ -824,7 +1152,7 @@ void Renderer::forwardRender (const MultiDrawCommands<Buffer>& staticObjects, Sc
     // We need to use the purpose-made forward render program and write straight into the light buffer.
     const auto activeProgram        = ProgramBinder { m_programs.forwardRender };
     const auto activeFramebuffer    = FramebufferBinder<GL_FRAMEBUFFER> { m_lbuffer.getFramebuffer() };
-    const auto activeIndirectBuffer = BufferBinder<GL_DRAW_INDIRECT_BUFFER> { staticObjects.buffer };
+    const auto activeIndirectBuffer = BufferBinder<GL_DRAW_INDIRECT_BUFFER> { staticObjects.buffer.getID() };
     
     #ifdef _NVTX
         nvtxRangePop();
@@ -901,44 +1229,98 @@ ModifiedRange Renderer::updateSceneUniforms() noexcept
 }
 
 
+Renderer::ModifiedStaticObjectRanges Renderer::updateStaticObjects() noexcept
+{
+    // Static instances never move so their bounds were calculated when they were loaded.
+    const auto& bounds      = m_geometry.getStaticBounds();
+    const auto projection   = LevelProjection { *m_scene, m_resolution };
+    auto sceneCommands      = CommandList { };
+    auto shadowCommands     = CommandList { };
+    auto pixelsPerUnit      = std::vector<float> { };
+
+    for (const auto& batch : m_geometry.getStaticBatches())
+    {
+        // Meshes without simplified levels don't need projecting.
+        const auto& mesh = *batch.mesh;
+        pixelsPerUnit.resize (batch.instanceCount);
+
+        if (mesh.levels.size() > 1)
+        {
+            for (GLuint i { 0 }; i < batch.instanceCount; ++i)
+            {
+                pixelsPerUnit[i] = projection.pixelsPerUnit (bounds[batch.baseInstance + i]);
+            }
+        }
+
+        sceneCommands.add (mesh, batch.baseInstance, batch.instanceCount, pixelsPerUnit.data(), sceneLevelError);
+        shadowCommands.add (mesh, batch.baseInstance, batch.instanceCount, pixelsPerUnit.data(), shadowLevelError);
+    }
+
+    return 
+    { 
+        sceneCommands.write (m_staticDrawing, m_partition), 
+        shadowCommands.write (m_staticShadows, m_partition) 
+    };
+}
+
+
 Renderer::ModifiedDynamicObjectRanges Renderer::updateDynamicObjects() noexcept
 {
     // Retrieve the necessary pointers. We also need to keep track of how many instances there are.
-    auto drawCommandBuffer  = (MultiDrawElementsIndirectCommand*) m_objectDrawing.buffer.pointer (m_partition);
     auto transformBuffer    = (ModelTransform*) m_objectTransforms.pointer (m_partition);
     auto materialIDBuffer   = (MaterialID*) m_objectMaterialIDs.pointer (m_partition);
     auto instanceCount      = GLuint { 0 };
 
+    // Levels of detail are selected from how large each instance appears on screen.
+    const auto projection   = LevelProjection { *m_scene, m_resolution };
+    auto sceneCommands      = CommandList { };
+    auto shadowCommands     = CommandList { };
+    auto pixelsPerUnit      = std::vector<float> { };
+
     // Create lambda functions to update the data.
-    const auto addDrawCommand = [&] (const auto index, const Mesh& mesh, const MeshInstances::Instances& instances)
+    const auto addDrawCommands = [&] (const auto, const MeshLevels& mesh, const MeshInstances::Instances& instances)
     {
         const auto count = static_cast<GLuint> (instances.size());
-        drawCommandBuffer[index] = { mesh.elementCount, count, mesh.elementsIndex, mesh.verticesIndex, instanceCount };
+        pixelsPerUnit.resize (instances.size());
+
+        if (mesh.levels.size() > 1)
+        {
+            for (size_t i { 0 }; i < instances.size(); ++i)
+            {
+                const auto& instance    = m_scene->getInstanceById (instances[i]);
+                const auto model        = util::toGLM (instance.getTransformationMatrix());
+                pixelsPerUnit[i]        = projection.pixelsPerUnit (mesh.bounds (model));
+            }
+        }
+
+        sceneCommands.add (mesh, instanceCount, count, pixelsPerUnit.data(), sceneLevelError);
+        shadowCommands.add (mesh, instanceCount, count, pixelsPerUnit.data(), shadowLevelError);
 
         // Ensure we increment the base instance.
         instanceCount += count;
     };
 
-    const auto addTransform = [&] (const auto index, const scene::Instance& instance)
+    // Quantised meshes need their dequantisation folded into the transform of every instance.
+    const auto addTransform = [&] (const auto index, const scene::Instance& instance, const Mesh& mesh)
     {
-        transformBuffer[index] = ModelTransform (util::toGLM (instance.getTransformationMatrix()));
+        transformBuffer[index] = mesh.dequantise (ModelTransform (util::toGLM (instance.getTransformationMatrix())));
     };
 
-    const auto addMaterialID = [&] (const auto index, const scene::Instance& instance)
+    const auto addMaterialID = [&] (const auto index, const scene::Instance& instance, const Mesh&)
     {
         materialIDBuffer[index] = m_materials[instance.getMaterialId()];
     };
 
-    const auto addTransformAndMaterialID = [&] (const auto index, const scene::Instance& instance)
+    const auto addTransformAndMaterialID = [&] (const auto index, const scene::Instance& instance, const Mesh& mesh)
     {
-        addTransform (index, instance);
-        addMaterialID (index, instance);
+        addTransform (index, instance, mesh);
+        addMaterialID (index, instance, mesh);
     };
 
     // If we're on a single thread we should just iterate through the list once otherwise we may reduce performance.
     if (!m_multiThreaded)
     {
-        forEachDynamicMeshInstance (addTransformAndMaterialID, addDrawCommand);
+        forEachDynamicMeshInstance (addTransformAndMaterialID, addDrawCommands);
     }
 
     // Distribute the load with multiple cores. We'll iterate the contents multiple times but it should be faster.
@@ -946,18 +1328,16 @@ Renderer::ModifiedDynamicObjectRanges Renderer::updateDynamicObjects() noexcept
     {
         const auto transforms   = std::async (std::launch::async, [&] { forEachDynamicMeshInstance (addTransform); });
         const auto materialIDs  = std::async (std::launch::async, [&] { forEachDynamicMeshInstance (addMaterialID); });
-        forEachDynamicMesh (addDrawCommand);
+        forEachDynamicMesh (addDrawCommands);
         transforms.wait();
         materialIDs.wait();
     }
 
-    // Now configure the draw commands and return our modified data ranges.
-    const auto drawingOffset    = m_objectDrawing.buffer.partitionOffset (m_partition);
-    m_objectDrawing.start       = drawingOffset;
-    m_objectDrawing.count       = static_cast<GLsizei> (m_dynamics.size());
+    // Now write the draw commands and return our modified data ranges.
     return 
     { 
-        { drawingOffset,                                        static_cast<GLsizeiptr> (sizeof (MultiDrawElementsIndirectCommand) * m_objectDrawing.count) },
+        sceneCommands.write (m_objectDrawing, m_partition),
+        shadowCommands.write (m_objectShadows, m_partition),
         { m_objectTransforms.partitionOffset (m_partition),     static_cast<GLsizeiptr> (sizeof (ModelTransform) * instanceCount) },
         { m_objectMaterialIDs.partitionOffset (m_partition),    static_cast<GLsizeiptr> (sizeof (MaterialID) * instanceCount) }
     };
@@ -985,7 +1365,7 @@ ModifiedRange Renderer::updateLightDrawCommands (const GLuint pointLights, const
 }
 
 
-ModifiedRange Renderer::updateDirectionalLights (const std::vector<scene::DirectionalLight>& lights) noexcept
+ModifiedRange Renderer::updateDirectionalLights (const scene::Span<const scene::DirectionalLight> lights) noexcept
 {
     auto uniforms = m_uniforms.getWritableDirectionalLightData();
     return processLightUniforms (uniforms, lights, [] (const scene::DirectionalLight& scene, const float intensityScale)
@@ -999,7 +1379,7 @@ ModifiedRange Renderer::updateDirectionalLights (const std::vector<scene::Direct
 }
 
 
-Renderer::ModifiedLightVolumeRanges Renderer::updatePointLights (const std::vector<scene::PointLight>& lights) noexcept
+Renderer::ModifiedLightVolumeRanges Renderer::updatePointLights (const scene::Span<const scene::PointLight> lights) noexcept
 {
     // We need lambdas for translating scene to uniform information.
     const auto uniforms = [] (const scene::PointLight& scene, const float intensityScale)
@@ -1039,7 +1419,7 @@ Renderer::ModifiedLightVolumeRanges Renderer::updatePointLights (const std::vect
 }
 
 
-Renderer::ModifiedLightVolumeRanges Renderer::updateSpotlights (const std::vector<scene::SpotLight>& lights, 
+Renderer::ModifiedLightVolumeRanges Renderer::updateSpotlights (const scene::Span<const scene::SpotLight> lights, 
             const size_t transformOffset) noexcept
 {
     // We need lambdas for translating scene to uniform information.
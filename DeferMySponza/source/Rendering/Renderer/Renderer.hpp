@@ -4,12 +4,14 @@
 #define         _RENDERING_RENDERER_
 
 // STL headers.
+#include <future>
 #include <utility>
 
 
 // Engine headers.
 #include <glm/fwd.hpp>
 #include <scene/scene_fwd.hpp>
+#include <scene/Span.hpp>
 
 
 // Personal headers.
@@ -85,7 +87,8 @@ class Renderer final
         /// <summary> 
         /// Attempt to initialise the renderer, building all mesh and material data, preparing the renderer for 
         /// rendering. Successive calls will completely rebuild the entire scene. Upon failure the object will
-        /// clean itself to an uninitialised state.
+        /// clean itself to an uninitialised state. If the scene is still loading then mesh data will be made 
+        /// resident in stages by render() once loading has finished, without waiting on the loading threads.
         /// </summary>
         /// <param name="scene"> A context to use for rendering a scene. </param>
         /// <param name="internalRes"> The internal resolution for the framebuffers. </param>
@@ -97,7 +100,10 @@ class Renderer final
         void clean() noexcept;
 
 
-        /// <summary> Causes the renderer to render a frame to the display. </summary>
+        /// <summary> 
+        /// Causes the renderer to render a frame to the display. Whatever part of the scene is resident is drawn, 
+        /// the display will be cleared instead if the scene geometry isn't resident yet.
+        /// </summary>
         void render() noexcept;
 
     private:
@@ -108,25 +114,47 @@ class Renderer final
         constexpr static auto smaaStartingTextureUnit       = GLuint { 6 };         //!< The starting texture unit for the antialiasing textures, occupies three units.
         constexpr static auto materialsStartingTextureUnit  = GLuint { 9 };         //!< The starting texture unit for the material data.
         constexpr static auto defaultAA                     = SMAA::Quality::Ultra; //!< The default value for antialiasing.
+        constexpr static auto compactVertices               = true;                 //!< Whether scene vertices are quantised into 16 bytes.
+        constexpr static auto sceneLevelError               = 1.f;                  //!< How many pixels the error of a level of detail may cover on screen.
+        constexpr static auto shadowLevelError              = 4.f;                  //!< Shadow maps are filtered and rarely viewed closely so they use coarser levels.
+
+        /// <summary> How much of the scene has been made resident, each stage is reached on a separate frame. </summary>
+        enum class Residency
+        {
+            Loading,    //!< Waiting on the scene or geometry pack, nothing can be drawn yet.
+            Geometry,   //!< Static objects are drawn, dynamic instances are collected during the next frame.
+            Resident,   //!< The entire scene is drawn.
+            Failed      //!< The scene resources couldn't be built, they won't be attempted again.
+        };
 
         struct MeshInstances final
         {
             using Instances = std::vector<scene::InstanceId>;
 
-            Mesh        mesh        { };    //!< Rendering data for a particular scene mesh.
+            MeshLevels  mesh        { };    //!< Rendering data for each level of detail of a particular scene mesh.
             Instances   instances   { };    //!< A list of instances requiring the stored mesh.
 
-            MeshInstances (const Mesh& mesh, Instances&& instances) noexcept
-                : mesh (std::move (mesh)), instances (std::move (instances)) {}
+            MeshInstances (const MeshLevels& mesh, Instances&& instances) noexcept
+                : mesh (mesh), instances (std::move (instances)) {}
         };
 
         struct ModifiedDynamicObjectRanges final
         {
-            ModifiedRange drawCommands, transforms, materialIDs;
+            ModifiedRange drawCommands, shadowCommands, transforms, materialIDs;
 
             ModifiedDynamicObjectRanges() = default;
-            ModifiedDynamicObjectRanges (const ModifiedRange& a, const ModifiedRange& b, const ModifiedRange& c)
-                : drawCommands (a), transforms (b), materialIDs (c) { }
+            ModifiedDynamicObjectRanges (const ModifiedRange& a, const ModifiedRange& b, const ModifiedRange& c, 
+                const ModifiedRange& d)
+                : drawCommands (a), shadowCommands (b), transforms (c), materialIDs (d) { }
+        };
+
+        struct ModifiedStaticObjectRanges final
+        {
+            ModifiedRange drawCommands, shadowCommands;
+
+            ModifiedStaticObjectRanges() = default;
+            ModifiedStaticObjectRanges (const ModifiedRange& a, const ModifiedRange& b)
+                : drawCommands (a), shadowCommands (b) { }
         };
 
         struct ModifiedLightVolumeRanges final
@@ -144,6 +172,7 @@ class Renderer final
         using DrawCommands      = MultiDrawCommands<types::PMB>;
         using SyncObjects       = std::array<Sync, types::multiBuffering>;
         using QueryObjects      = std::array<Query, types::multiBuffering>;
+        using PendingPack       = std::future<GeometryPack>;
                 
         scene::Context*     m_scene             { };            //!< Used to render the scene from the correct viewpoint.
         Uniforms            m_uniforms          { };            //!< Uniform data which is accessible to any program that requests it.
@@ -151,9 +180,14 @@ class Renderer final
 
         DrawableObjects     m_dynamics          { };            //!< A collection of dynamic mesh instances that need drawing.
         ShadowMaps          m_shadowMaps        { };            //!< Used to produce shadow maps for spotlights in the scene.
+        UploadQueue         m_uploads           { };            //!< Stages texture and geometry data in a persistently mapped ring, declared before its users so it outlives them.
         Materials           m_materials         { };            //!< Contains every material in the scene, used for filling instancing data for dynamic objects.
         
+        DrawCommands        m_staticDrawing     { };            //!< Draw commands for static objects, rebuilt each frame to select levels of detail.
+        DrawCommands        m_staticShadows     { };            //!< Draw commands for static objects in shadow maps.
+
         DrawCommands        m_objectDrawing     { };            //!< Draw commands for dynamic objects.
+        DrawCommands        m_objectShadows     { };            //!< Draw commands for dynamic objects in shadow maps.
         types::PMB          m_objectMaterialIDs { };            //!< Material ID instancing data for dynamic objects.
         types::PMB          m_objectTransforms  { };            //!< Model transforms for dynamic objects.
 
@@ -164,6 +198,7 @@ class Renderer final
         LightBuffer         m_lbuffer           { };            //!< A colour buffer where lighting is applied using data stored in the gbuffer.
         
         Geometry            m_geometry          { };            //!< A collection of OpenGL objects which store the scene geometry.
+        PendingPack         m_geometryPack      { };            //!< The scene geometry, mapped or baked on a worker thread during initialisation.
         SMAA                m_smaa              { };            //!< Used to perform antialiasing.
 
         Resolution          m_resolution        { };            //!< The internal and display resolution of drawing operations.
@@ -172,6 +207,7 @@ class Renderer final
         SyncObjects         m_syncs             { };            //!< Contains sync objects for each level of buffering, allows us to manually synchronise with the GPU if needed.
         QueryObjects        m_queries           { };            //!< A collection of query objects used to check how long each frame took to complete.
        
+        Residency           m_residency         { };            //!< How much of the scene has been loaded onto the GPU.
         bool                m_deferredRender    { true };       //!< Whether a deferred or forward render should be performed.
         bool                m_multiThreaded     { true };       //!< Whether the renderer should be multi-threaded or not.
         bool                m_pbs               { true };       //!< Whether physically based shaders should be used.
@@ -185,15 +221,31 @@ class Renderer final
 
     private:
 
+        /// <summary>
+        /// Makes the next stage of the scene resident if everything it needs has finished loading. Loading threads
+        /// are polled rather than waited on so frames keep being drawn. Failures are reported once and remembered.
+        /// </summary>
+        void updateResidency() noexcept;
+
+        /// <summary>
+        /// Attempts to build the dynamic object buffers, geometry and static object buffers. The scene must have
+        /// finished loading, this will wait for the geometry pack if it's still loading.
+        /// </summary>
+        bool buildSceneResources() noexcept;
+
+        /// <summary> Collects the dynamic instances, completing residency, and reports the startup timeline. </summary>
+        void completeResidency() noexcept;
+
         /// <summary>
         /// Attempts to build the OpenGL programs. 
         /// </summary>
         bool buildPrograms() noexcept;
 
         /// <summary>
-        /// Attempts to load the texture and material data of every object in the scene.
+        /// Attempts to upload the texture and material data of every object in the scene.
         /// </summary>
-        bool buildMaterials() noexcept;
+        /// <param name="prepared"> The textures and materials read by Materials::prepare(). </param>
+        bool buildMaterials (Materials::Prepared&& prepared) noexcept;
 
         /// <summary>
         /// Attempts to build the dynamic object command and instancing buffers. This parses the instances container
@@ -213,6 +265,12 @@ class Renderer final
         /// </summary> 
         bool buildGeometry() noexcept;
 
+        /// <summary>
+        /// Attempts to build the static object command buffers. Every static instance may select a different level of
+        /// detail so enough memory is allocated for each instance to need its own command for every part.
+        /// </summary> 
+        bool buildStaticObjectBuffers() noexcept;
+
         /// <summary> 
         /// Attempt to build the geometry and light buffers according to the current internal resolution. 
         /// </summary>
@@ -231,7 +289,9 @@ class Renderer final
         bool buildSMAA() noexcept;
 
         /// <summary>
-        /// Fills the drawable instances container with non-static instances found in the given scene
+        /// Fills the drawable instances container with non-static instances found in the given scene. The dynamic draw
+        /// command buffers will grow if every instance selecting its own level of detail would need more commands than
+        /// they can hold.
         /// </summary> 
         void fillDynamicInstances() noexcept;
 
@@ -239,53 +299,63 @@ class Renderer final
         void syncWithGPUIfNecessary() noexcept;
 
         /// <summary> Performs a forward render of the entire scene. </summary>
-        void forwardRender (const MultiDrawCommands<Buffer>& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept;
+        void forwardRender (const DrawCommands& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept;
 
         /// <summary> Performs a deferred render of the entire scene. </summary>
-        void deferredRender (const MultiDrawCommands<Buffer>& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept;
+        void deferredRender (const DrawCommands& staticObjects, SceneVAO& sceneVAO, ASyncActions& actions) noexcept;
 
         /// <summary> Updates the scene uniforms such as the camera position, ambient lighting and matrices. </summary>
         ModifiedRange updateSceneUniforms() noexcept;
 
-        /// <summary> Updates the draw commands, transforms and materail IDs of dynamic objects. </summary>
+        /// <summary> 
+        /// Updates the draw commands of static objects, selecting the level of detail of each instance from how large 
+        /// it appears on screen. Shadow maps use their own commands with coarser levels.
+        /// </summary>
+        ModifiedStaticObjectRanges updateStaticObjects() noexcept;
+
+        /// <summary> 
+        /// Updates the draw commands, transforms and materail IDs of dynamic objects. Levels of detail are selected
+        /// like static objects.
+        /// </summary>
         ModifiedDynamicObjectRanges updateDynamicObjects() noexcept;
 
         /// <summary> Adds a draw command for a full-screen quad and every point and spotlight in the scene. </summary>
         ModifiedRange updateLightDrawCommands (const GLuint pointLights, const GLuint spotlights) noexcept;
 
         /// <summary> Updates the directional light uniform data with the given light data. </summary>
-        ModifiedRange updateDirectionalLights (const std::vector<scene::DirectionalLight>& lights) noexcept;
+        ModifiedRange updateDirectionalLights (const scene::Span<const scene::DirectionalLight> lights) noexcept;
 
         /// <summary> Updates the transform and uniform data for every given point light. </summary>
-        ModifiedLightVolumeRanges updatePointLights (const std::vector<scene::PointLight>& lights) noexcept;
+        ModifiedLightVolumeRanges updatePointLights (const scene::Span<const scene::PointLight> lights) noexcept;
 
         /// <summary> Updates the transform and uniform data for every given spot light. </summary>
-        ModifiedLightVolumeRanges updateSpotlights (const std::vector<scene::SpotLight>& lights, 
+        ModifiedLightVolumeRanges updateSpotlights (const scene::Span<const scene::SpotLight> lights, 
             const size_t transformOffset) noexcept;
 
         /// <summary> 
-        /// Calls the given functions for each dynamic mesh. The function should take a size_t, Mesh and 
+        /// Calls the given functions for each dynamic mesh. The function should take a size_t, MeshLevels and 
         /// MeshInstances::Instances parameter. All of which should be constant.
         /// </summary>
         template <typename... Funcs>
         void forEachDynamicMesh (Funcs&&... funcs) const noexcept;
 
         /// <summary>
-        /// Calls the given function for each dynamic instance. The function should take a size_t and 
-        /// scene::InstanceId parameter. All of which should be constant if references. Extra functions will be passed
-        /// to forEachDynamicMesh to be called on each mesh.
+        /// Calls the given function for each dynamic instance. The function should take a size_t, scene::Instance and
+        /// Mesh parameter, the mesh being the first part which every level shares the dequantisation of. All of which
+        /// should be constant if references. Extra functions will be passed to forEachDynamicMesh to be called on 
+        /// each mesh.
         /// </summary>
         template <typename Func, typename... MeshFuncs>
         void forEachDynamicMeshInstance (const Func& func, MeshFuncs&&... meshFuncs) const noexcept;
 
-        /// <summary> Calls the given function, passing the index, mesh and instances as parameters. </summary>
+        /// <summary> Calls the given function, passing the index, mesh levels and instances as parameters. </summary>
         template <typename A, typename B, typename Func>
         void processMesh (const A index, const B& meshInstances, const Func& func) const noexcept
         {
             func (index, meshInstances.mesh, meshInstances.instances);
         }
         
-        /// <summary> Calls the given functions, passing the index, mesh and instances as parameters. </summary>
+        /// <summary> Calls the given functions, passing the index, mesh levels and instances as parameters. </summary>
         template <typename A, typename B, typename Func, typename... Funcs>
         void processMesh (const A index, const B& meshInstances, const Func& func, Funcs&&... funcs) const noexcept
         {
@@ -331,7 +401,7 @@ void Renderer::forEachDynamicMeshInstance (const Func& func, MeshFuncs&&... mesh
     {
         for (const auto instanceID : instances)
         {
-            func (index++, m_scene->getInstanceById (instanceID));
+            func (index++, m_scene->getInstanceById (instanceID), mesh.front());
         }
     }, std::forward<MeshFuncs> (meshFuncs)...);
 }
@@ -34,6 +34,7 @@ struct Samplers final
     Sampler shadowMaps          { 0, "shadowMaps" };        //!< A 2D texture array containing shadow maps.
     Sampler materials           { 0, "materials" };         //!< A texture buffer containing every material in the scene.
     Sampler textures            { 0, "textures" };          //!< An array of textures containing texture maps.
+    Sampler textureHandles      { 0, "textureHandles" };    //!< A texture buffer containing bindless texture array handles.
     GLsizei textureSamplerCount { 0 };                      //!< The number of texture arrays in the "textures" sampler.
 
     Samplers() noexcept                             = default;
@@ -92,6 +92,7 @@ void Uniforms::bindUniformsToPrograms (const Programs& programs) const noexcept
         bindSampler (program, m_samplers.gbufferMaterials);
         bindSampler (program, m_samplers.shadowMaps);
         bindSampler (program, m_samplers.materials);
+        bindSampler (program, m_samplers.textureHandles);
 
         // And finally the texture arrays.
         const auto location = glGetUniformLocation (program.getID(), m_samplers.textures.name);
@@ -142,6 +143,7 @@ void Uniforms::retrieveSamplerData (Samplers& samplers, const GeometryBuffer& gb
     // Retrieve the material data.
     samplers.materials.unit         = materials.getMaterialTextureUnit();
     samplers.textures.unit          = materials.getTextureArrayStartingUnit();
+    samplers.textureHandles.unit    = materials.getTextureHandleUnit();
     samplers.textureSamplerCount    = materials.getTextureArrayCount();
 }
 
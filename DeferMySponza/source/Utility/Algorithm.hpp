@@ -7,6 +7,10 @@
 #include <algorithm>
 
 
+// Engine headers.
+#include <scene/parallel.hpp>
+
+
 namespace std
 {
     /// <summary> A shortcut for std::for_each which calls std::begin and std::end. </summary>
@@ -22,4 +26,16 @@ namespace std
     }
 }
 
+
+
+namespace util
+{
+    /// <summary>
+    /// Calls a function once for every index in the range [0, count) using every available hardware thread. The scene
+    /// library and the renderer share one implementation, see scene::parallelFor. The first exception thrown by the
+    /// function is rethrown once every thread has finished.
+    /// </summary>
+    using scene::parallelFor;
+}
+
 #endif
\ No newline at end of file
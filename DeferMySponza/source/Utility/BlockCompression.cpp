@@ -0,0 +1,694 @@
+#include "BlockCompression.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+
+// Engine headers.
+#include <emmintrin.h>
+
+
+// Namespaces.
+using util::BlockFormat;
+
+
+namespace
+{
+    constexpr auto blockTexels      = size_t { 16 };    //!< How many texels each block contains.
+    constexpr auto refineThreshold  = 1e-6f;            //!< Below this the least squares system is treated as singular.
+
+    using Colour    = std::array<float, 4>;
+    using Indices   = std::array<std::uint8_t, blockTexels>;
+
+
+    /// <summary>
+    /// A 4x4 block of texels in the range [0, 255], stored per channel so that each row of the block can be loaded
+    /// into a single SSE register. Missing colour channels are zero and missing alpha is opaque.
+    /// </summary>
+    struct Block final
+    {
+        alignas (16) float texels[4][blockTexels];  //!< Indexed by channel and then by texel in row-major order.
+
+        /// <summary> Loads the given row of texels for the given channel. </summary>
+        inline __m128 row (const size_t channel, const size_t row) const noexcept
+        {
+            return _mm_load_ps (texels[channel] + row * 4);
+        }
+    };
+
+
+    /// <summary> Writes values into a 128-bit block, starting from the least significant bit. </summary>
+    class BitWriter final
+    {
+        public:
+
+            /// <summary> Appends the lowest bits of the given value. </summary>
+            inline void write (const std::uint32_t value, const size_t bits) noexcept
+            {
+                for (size_t i { 0 }; i < bits; ++i, ++m_position)
+                {
+                    m_words[m_position / 64] |= std::uint64_t { (value >> i) & 1U } << (m_position % 64);
+                }
+            }
+
+            /// <summary> Copies the written bits to the given block. </summary>
+            inline void copyTo (std::uint8_t* destination) const noexcept
+            {
+                std::memcpy (destination, m_words.data(), sizeof (m_words));
+            }
+
+        private:
+
+            std::array<std::uint64_t, 2>    m_words     { };    //!< The bits of the block, little-endian.
+            size_t                          m_position  { 0 };  //!< The next bit to be written.
+    };
+
+
+    /// <summary> Adds every lane of the given vector together. </summary>
+    inline float horizontalSum (const __m128 vector) noexcept
+    {
+        const auto pairs = _mm_add_ps (vector, _mm_movehl_ps (vector, vector));
+        return _mm_cvtss_f32 (_mm_add_ss (pairs, _mm_shuffle_ps (pairs, pairs, _MM_SHUFFLE (1, 1, 1, 1))));
+    }
+
+
+    /// <summary> Finds the smallest lane of the given vector. </summary>
+    inline float horizontalMin (const __m128 vector) noexcept
+    {
+        const auto pairs = _mm_min_ps (vector, _mm_movehl_ps (vector, vector));
+        return _mm_cvtss_f32 (_mm_min_ss (pairs, _mm_shuffle_ps (pairs, pairs, _MM_SHUFFLE (1, 1, 1, 1))));
+    }
+
+
+    /// <summary> Finds the largest lane of the given vector. </summary>
+    inline float horizontalMax (const __m128 vector) noexcept
+    {
+        const auto pairs = _mm_max_ps (vector, _mm_movehl_ps (vector, vector));
+        return _mm_cvtss_f32 (_mm_max_ss (pairs, _mm_shuffle_ps (pairs, pairs, _MM_SHUFFLE (1, 1, 1, 1))));
+    }
+
+
+    /// <summary> Clamps a value to the range of an 8-bit channel. </summary>
+    inline float saturate (const float value) noexcept
+    {
+        return std::min (std::max (value, 0.f), 255.f);
+    }
+
+
+    /// <summary> Reads the 4x4 block at the given block co-ordinates, texels outside the image repeat edges. </summary>
+    template <typename Component>
+    Block loadBlock (const Component* source, const size_t width, const size_t height, const size_t components,
+        const size_t blockX, const size_t blockY) noexcept
+    {
+        constexpr auto maximum  = static_cast<float> ((size_t { 1 } << (sizeof (Component) * 8)) - 1);
+        constexpr auto scale    = 255.f / maximum;
+
+        auto block = Block { };
+
+        for (size_t y { 0 }; y < 4; ++y)
+        {
+            const auto row = std::min (blockY * 4 + y, height - 1);
+
+            for (size_t x { 0 }; x < 4; ++x)
+            {
+                const auto column   = std::min (blockX * 4 + x, width - 1);
+                const auto texel    = source + (row * width + column) * components;
+                const auto index    = y * 4 + x;
+
+                for (size_t channel { 0 }; channel < 4; ++channel)
+                {
+                    block.texels[channel][index] = channel < components ? texel[channel] * scale :
+                                                   channel == 3 ? 255.f : 0.f;
+                }
+            }
+        }
+
+        return block;
+    }
+
+
+    /// <summary>
+    /// Fits a line through the first given number of channels of every texel in the block. The line passes through
+    /// the mean and follows the principal axis, found by power iteration on the covariance matrix. The endpoints are
+    /// the furthest projections of the texels onto the line.
+    /// </summary>
+    template <size_t Channels>
+    void fitEndpoints (const Block& block, Colour& first, Colour& second) noexcept
+    {
+        // Centre each channel around the mean.
+        auto mean = Colour { };
+        __m128 centred[Channels][4];
+
+        for (size_t channel { 0 }; channel < Channels; ++channel)
+        {
+            auto sum = _mm_setzero_ps();
+            for (size_t row { 0 }; row < 4; ++row)
+            {
+                sum = _mm_add_ps (sum, block.row (channel, row));
+            }
+
+            mean[channel]       = horizontalSum (sum) / static_cast<float> (blockTexels);
+            const auto offset   = _mm_set1_ps (mean[channel]);
+
+            for (size_t row { 0 }; row < 4; ++row)
+            {
+                centred[channel][row] = _mm_sub_ps (block.row (channel, row), offset);
+            }
+        }
+
+        // Build the covariance matrix, it is symmetric so only half of it needs calculating.
+        float covariance[4][4] = { };
+
+        for (size_t a { 0 }; a < Channels; ++a)
+        {
+            for (size_t b { a }; b < Channels; ++b)
+            {
+                auto sum = _mm_setzero_ps();
+                for (size_t row { 0 }; row < 4; ++row)
+                {
+                    sum = _mm_add_ps (sum, _mm_mul_ps (centred[a][row], centred[b][row]));
+                }
+
+                covariance[a][b] = covariance[b][a] = horizontalSum (sum);
+            }
+        }
+
+        // Start from the channel with the most variance as it's unlikely to be perpendicular to the axis.
+        auto axis   = Colour { };
+        auto start  = size_t { 0 };
+
+        for (size_t channel { 1 }; channel < Channels; ++channel)
+        {
+            start = covariance[channel][channel] > covariance[start][start] ? channel : start;
+        }
+
+        axis[start] = 1.f;
+
+        for (size_t iteration { 0 }; iteration < 8; ++iteration)
+        {
+            auto next   = Colour { };
+            auto length = 0.f;
+
+            for (size_t a { 0 }; a < Channels; ++a)
+            {
+                for (size_t b { 0 }; b < Channels; ++b)
+                {
+                    next[a] += covariance[a][b] * axis[b];
+                }
+
+                length += next[a] * next[a];
+            }
+
+            // Uniform blocks have no axis, every texel will project onto the mean.
+            if (length < refineThreshold)
+            {
+                break;
+            }
+
+            const auto inverse = 1.f / std::sqrt (length);
+            for (size_t channel { 0 }; channel < Channels; ++channel)
+            {
+                axis[channel] = next[channel] * inverse;
+            }
+        }
+
+        // Project every texel onto the axis to find the extents of the line.
+        auto minimum = _mm_set1_ps (std::numeric_limits<float>::max());
+        auto maximum = _mm_set1_ps (std::numeric_limits<float>::lowest());
+
+        for (size_t row { 0 }; row < 4; ++row)
+        {
+            auto projection = _mm_setzero_ps();
+            for (size_t channel { 0 }; channel < Channels; ++channel)
+            {
+                projection = _mm_add_ps (projection, _mm_mul_ps (centred[channel][row], _mm_set1_ps (axis[channel])));
+            }
+
+            minimum = _mm_min_ps (minimum, projection);
+            maximum = _mm_max_ps (maximum, projection);
+        }
+
+        const auto lower = horizontalMin (minimum);
+        const auto upper = horizontalMax (maximum);
+
+        first = second = Colour { 0.f, 0.f, 0.f, 255.f };
+        for (size_t channel { 0 }; channel < Channels; ++channel)
+        {
+            first[channel]  = saturate (mean[channel] + axis[channel] * lower);
+            second[channel] = saturate (mean[channel] + axis[channel] * upper);
+        }
+    }
+
+
+    /// <summary> Chooses the closest palette entry for every texel in the block. </summary>
+    /// <returns> The sum of the squared error of every texel. </returns>
+    template <size_t Channels, size_t Entries>
+    float selectIndices (const Block& block, const std::array<Colour, Entries>& palette, Indices& indices) noexcept
+    {
+        // Broadcast the palette up front as it is compared against every row.
+        __m128 entries[Entries][Channels];
+
+        for (size_t entry { 0 }; entry < Entries; ++entry)
+        {
+            for (size_t channel { 0 }; channel < Channels; ++channel)
+            {
+                entries[entry][channel] = _mm_set1_ps (palette[entry][channel]);
+            }
+        }
+
+        auto error = _mm_setzero_ps();
+
+        for (size_t row { 0 }; row < 4; ++row)
+        {
+            auto closest        = _mm_set1_ps (std::numeric_limits<float>::max());
+            auto closestIndex   = _mm_setzero_si128();
+
+            for (size_t entry { 0 }; entry < Entries; ++entry)
+            {
+                auto distance = _mm_setzero_ps();
+                for (size_t channel { 0 }; channel < Channels; ++channel)
+                {
+                    const auto difference = _mm_sub_ps (block.row (channel, row), entries[entry][channel]);
+                    distance = _mm_add_ps (distance, _mm_mul_ps (difference, difference));
+                }
+
+                // Ties keep the earliest entry so that blocks with matching endpoints only ever use index zero.
+                const auto closer   = _mm_castps_si128 (_mm_cmplt_ps (distance, closest));
+                const auto index    = _mm_set1_epi32 (static_cast<int> (entry));
+                closest             = _mm_min_ps (distance, closest);
+                closestIndex        = _mm_or_si128 (_mm_and_si128 (closer, index),
+                                                    _mm_andnot_si128 (closer, closestIndex));
+            }
+
+            error = _mm_add_ps (error, closest);
+
+            alignas (16) std::int32_t rowIndices[4];
+            _mm_store_si128 (reinterpret_cast<__m128i*> (rowIndices), closestIndex);
+
+            for (size_t column { 0 }; column < 4; ++column)
+            {
+                indices[row * 4 + column] = static_cast<std::uint8_t> (rowIndices[column]);
+            }
+        }
+
+        return horizontalSum (error);
+    }
+
+
+    /// <summary>
+    /// Solves for the endpoints which minimise the squared error of the block with the given indices.
+    /// </summary>
+    /// <param name="weights"> How far each palette entry is from the first endpoint to the second, [0, 1]. </param>
+    /// <returns> Whether the system could be solved, it can't when every texel uses the same weight. </returns>
+    template <size_t Channels, size_t Entries>
+    bool refineEndpoints (const Block& block, const Indices& indices, const std::array<float, Entries>& weights,
+        Colour& first, Colour& second) noexcept
+    {
+        auto firstSquared   = 0.f;
+        auto secondSquared  = 0.f;
+        auto both           = 0.f;
+        auto firstSum       = Colour { };
+        auto secondSum      = Colour { };
+
+        for (size_t texel { 0 }; texel < blockTexels; ++texel)
+        {
+            const auto weight   = weights[indices[texel]];
+            const auto inverse  = 1.f - weight;
+
+            firstSquared    += inverse * inverse;
+            secondSquared   += weight * weight;
+            both            += inverse * weight;
+
+            for (size_t channel { 0 }; channel < Channels; ++channel)
+            {
+                firstSum[channel]   += inverse * block.texels[channel][texel];
+                secondSum[channel]  += weight * block.texels[channel][texel];
+            }
+        }
+
+        const auto determinant = firstSquared * secondSquared - both * both;
+        if (std::abs (determinant) < refineThreshold)
+        {
+            return false;
+        }
+
+        const auto inverse = 1.f / determinant;
+        for (size_t channel { 0 }; channel < Channels; ++channel)
+        {
+            first[channel]  = saturate ((firstSum[channel] * secondSquared - secondSum[channel] * both) * inverse);
+            second[channel] = saturate ((secondSum[channel] * firstSquared - firstSum[channel] * both) * inverse);
+        }
+
+        return true;
+    }
+
+
+    /// <summary> Quantises a colour to the 5:6:5 format used by BC1 endpoints. </summary>
+    inline std::uint16_t toRGB565 (const Colour& colour) noexcept
+    {
+        const auto quantise = [] (const float value, const float maximum)
+        {
+            return static_cast<std::uint16_t> (saturate (value) * maximum / 255.f + 0.5f);
+        };
+
+        return static_cast<std::uint16_t> (quantise (colour[0], 31.f) << 11 | quantise (colour[1], 63.f) << 5 |
+                                           quantise (colour[2], 31.f));
+    }
+
+
+    /// <summary> Expands a 5:6:5 colour to 8 bits per channel, as the GPU does. </summary>
+    inline Colour fromRGB565 (const std::uint16_t colour) noexcept
+    {
+        const auto red      = (colour >> 11) & 31;
+        const auto green    = (colour >> 5) & 63;
+        const auto blue     = colour & 31;
+
+        return
+        {
+            static_cast<float> (red << 3 | red >> 2),
+            static_cast<float> (green << 2 | green >> 4),
+            static_cast<float> (blue << 3 | blue >> 2),
+            255.f
+        };
+    }
+
+
+    /// <summary> Encodes the RGB channels of a block as BC1. </summary>
+    void encodeBC1 (const Block& block, std::uint8_t* destination) noexcept
+    {
+        // Entries two and three sit a third and two thirds of the way from the first endpoint to the second.
+        constexpr auto weights = std::array<float, 4> { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+        auto endpoints  = std::array<std::uint16_t, 2> { };
+        auto indices    = Indices { };
+
+        // Quantises the endpoints and picks the closest entry for each texel.
+        const auto evaluate = [&] (const Colour& first, const Colour& second, std::array<std::uint16_t, 2>& colours,
+            Indices& chosen)
+        {
+            // The four colour mode is only used when the first endpoint is larger.
+            colours = { toRGB565 (first), toRGB565 (second) };
+            if (colours[0] < colours[1])
+            {
+                std::swap (colours[0], colours[1]);
+            }
+
+            auto palette = std::array<Colour, 4> { fromRGB565 (colours[0]), fromRGB565 (colours[1]) };
+            for (size_t channel { 0 }; channel < 3; ++channel)
+            {
+                palette[2][channel] = (2.f * palette[0][channel] + palette[1][channel]) / 3.f;
+                palette[3][channel] = (palette[0][channel] + 2.f * palette[1][channel]) / 3.f;
+            }
+
+            return selectIndices<3> (block, palette, chosen);
+        };
+
+        auto first  = Colour { };
+        auto second = Colour { };
+        fitEndpoints<3> (block, first, second);
+
+        const auto error = evaluate (first, second, endpoints, indices);
+
+        // Keep the refined endpoints if they are an improvement.
+        if (refineEndpoints<3> (block, indices, weights, first, second))
+        {
+            auto refinedEndpoints   = std::array<std::uint16_t, 2> { };
+            auto refinedIndices     = Indices { };
+
+            if (evaluate (first, second, refinedEndpoints, refinedIndices) < error)
+            {
+                endpoints   = refinedEndpoints;
+                indices     = refinedIndices;
+            }
+        }
+
+        auto bits = std::uint64_t { endpoints[0] } | std::uint64_t { endpoints[1] } << 16;
+        for (size_t texel { 0 }; texel < blockTexels; ++texel)
+        {
+            bits |= std::uint64_t { indices[texel] } << (32 + texel * 2);
+        }
+
+        std::memcpy (destination, &bits, sizeof (bits));
+    }
+
+
+    /// <summary> Encodes a single channel of a block as BC4, this forms half of a BC5 block. </summary>
+    void encodeBC4 (const Block& block, const size_t channel, std::uint8_t* destination) noexcept
+    {
+        // The eight value mode spans the full range of the block so the extremes make the best endpoints.
+        auto minimum = block.row (channel, 0);
+        auto maximum = minimum;
+
+        for (size_t row { 1 }; row < 4; ++row)
+        {
+            minimum = _mm_min_ps (minimum, block.row (channel, row));
+            maximum = _mm_max_ps (maximum, block.row (channel, row));
+        }
+
+        const auto upper = static_cast<std::uint8_t> (horizontalMax (maximum) + 0.5f);
+        const auto lower = static_cast<std::uint8_t> (horizontalMin (minimum) + 0.5f);
+
+        auto bits = std::uint64_t { upper } | std::uint64_t { lower } << 8;
+
+        // Uniform blocks use index zero for every texel.
+        if (upper > lower)
+        {
+            // The palette is evenly spaced so the closest entry is the rounded position along the ramp. Position
+            // seven is the first endpoint, zero is the second and the rest are stored in reverse from index two.
+            const auto offset   = _mm_set1_ps (static_cast<float> (lower));
+            const auto scale    = _mm_set1_ps (7.f / static_cast<float> (upper - lower));
+            const auto one      = _mm_set1_epi32 (1);
+            const auto seven    = _mm_set1_epi32 (7);
+            const auto eight    = _mm_set1_epi32 (8);
+
+            for (size_t row { 0 }; row < 4; ++row)
+            {
+                const auto position = _mm_mul_ps (_mm_sub_ps (block.row (channel, row), offset), scale);
+                const auto ramp     = _mm_cvtps_epi32 (_mm_min_ps (_mm_max_ps (position, _mm_setzero_ps()),
+                                                                   _mm_set1_ps (7.f)));
+                auto index          = _mm_sub_epi32 (eight, ramp);
+                index               = _mm_sub_epi32 (index, _mm_and_si128 (_mm_cmpeq_epi32 (index, one), one));
+                index               = _mm_sub_epi32 (index, _mm_and_si128 (_mm_cmpeq_epi32 (index, eight), seven));
+
+                alignas (16) std::int32_t rowIndices[4];
+                _mm_store_si128 (reinterpret_cast<__m128i*> (rowIndices), index);
+
+                for (size_t column { 0 }; column < 4; ++column)
+                {
+                    bits |= static_cast<std::uint64_t> (rowIndices[column]) << (16 + (row * 4 + column) * 3);
+                }
+            }
+        }
+
+        std::memcpy (destination, &bits, sizeof (bits));
+    }
+
+
+    /// <summary> Encodes the RGBA channels of a block as BC7 using mode 6. </summary>
+    void encodeBC7 (const Block& block, std::uint8_t* destination) noexcept
+    {
+        // Mode 6 interpolates endpoints with 6-bit weights.
+        constexpr auto weights = std::array<std::uint32_t, 16>
+        {
+            0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+        };
+
+        // An endpoint is stored as 7 bits per channel plus a shared least significant bit.
+        struct Endpoint final
+        {
+            std::array<std::uint32_t, 4>    values  { };
+            std::uint32_t                   pBit    { 0 };
+        };
+
+        // Picks the p-bit which best represents the colour.
+        const auto quantise = [] (const Colour& colour)
+        {
+            auto best       = Endpoint { };
+            auto bestError  = std::numeric_limits<float>::max();
+
+            for (std::uint32_t pBit { 0 }; pBit < 2; ++pBit)
+            {
+                auto endpoint   = Endpoint { };
+                auto error      = 0.f;
+                endpoint.pBit   = pBit;
+
+                for (size_t channel { 0 }; channel < 4; ++channel)
+                {
+                    const auto value    = (colour[channel] - static_cast<float> (pBit)) * 0.5f + 0.5f;
+                    const auto stored   = static_cast<std::uint32_t> (std::min (std::max (value, 0.f), 127.f));
+                    const auto expanded = static_cast<float> (stored << 1 | pBit);
+
+                    endpoint.values[channel]    = stored;
+                    error                       += (expanded - colour[channel]) * (expanded - colour[channel]);
+                }
+
+                if (error < bestError)
+                {
+                    best        = endpoint;
+                    bestError   = error;
+                }
+            }
+
+            return best;
+        };
+
+        // Quantises the endpoints and picks the closest entry for each texel.
+        const auto evaluate = [&] (const Colour& first, const Colour& second, std::array<Endpoint, 2>& endpoints,
+            Indices& chosen)
+        {
+            endpoints = { quantise (first), quantise (second) };
+
+            auto palette = std::array<Colour, 16> { };
+            for (size_t entry { 0 }; entry < palette.size(); ++entry)
+            {
+                for (size_t channel { 0 }; channel < 4; ++channel)
+                {
+                    const auto lower    = endpoints[0].values[channel] << 1 | endpoints[0].pBit;
+                    const auto upper    = endpoints[1].values[channel] << 1 | endpoints[1].pBit;
+                    const auto weight   = weights[entry];
+                    palette[entry][channel] = static_cast<float> (((64 - weight) * lower + weight * upper + 32) >> 6);
+                }
+            }
+
+            return selectIndices<4> (block, palette, chosen);
+        };
+
+        auto first  = Colour { };
+        auto second = Colour { };
+        fitEndpoints<4> (block, first, second);
+
+        auto endpoints  = std::array<Endpoint, 2> { };
+        auto indices    = Indices { };
+        const auto error = evaluate (first, second, endpoints, indices);
+
+        // Keep the refined endpoints if they are an improvement.
+        auto fractions = std::array<float, 16> { };
+        std::transform (std::begin (weights), std::end (weights), std::begin (fractions),
+            [] (const std::uint32_t weight) { return static_cast<float> (weight) / 64.f; });
+
+        if (refineEndpoints<4> (block, indices, fractions, first, second))
+        {
+            auto refinedEndpoints   = std::array<Endpoint, 2> { };
+            auto refinedIndices     = Indices { };
+
+            if (evaluate (first, second, refinedEndpoints, refinedIndices) < error)
+            {
+                endpoints   = refinedEndpoints;
+                indices     = refinedIndices;
+            }
+        }
+
+        // The most significant bit of the first index is implicitly zero so swap the endpoints if it's set.
+        if (indices[0] >= 8)
+        {
+            std::swap (endpoints[0], endpoints[1]);
+            std::for_each (std::begin (indices), std::end (indices), [] (std::uint8_t& index) { index = 15 - index; });
+        }
+
+        auto writer = BitWriter { };
+        writer.write (1U << 6, 7);
+
+        for (size_t channel { 0 }; channel < 4; ++channel)
+        {
+            writer.write (endpoints[0].values[channel], 7);
+            writer.write (endpoints[1].values[channel], 7);
+        }
+
+        writer.write (endpoints[0].pBit, 1);
+        writer.write (endpoints[1].pBit, 1);
+        writer.write (indices[0], 3);
+
+        for (size_t texel { 1 }; texel < blockTexels; ++texel)
+        {
+            writer.write (indices[texel], 4);
+        }
+
+        writer.copyTo (destination);
+    }
+
+
+    /// <summary> Encodes a block in the given format. </summary>
+    void encodeBlock (const Block& block, const BlockFormat format, std::uint8_t* destination) noexcept
+    {
+        switch (format)
+        {
+            case BlockFormat::BC1:
+                return encodeBC1 (block, destination);
+
+            case BlockFormat::BC4:
+                return encodeBC4 (block, 0, destination);
+
+            case BlockFormat::BC5:
+                encodeBC4 (block, 0, destination);
+                return encodeBC4 (block, 1, destination + 8);
+
+            case BlockFormat::BC7:
+                return encodeBC7 (block, destination);
+        }
+    }
+
+
+    /// <summary> Compresses an image with the given component type. </summary>
+    template <typename Component>
+    void compress (const void* source, const size_t width, const size_t height, const size_t components,
+        const BlockFormat format, void* destination)
+    {
+        const auto texels       = static_cast<const Component*> (source);
+        const auto blocks       = static_cast<std::uint8_t*> (destination);
+        const auto blocksWide   = (width + 3) / 4;
+        const auto blocksTall   = (height + 3) / 4;
+        const auto size         = util::blockSize (format);
+
+        for (size_t row { 0 }; row < blocksTall; ++row)
+        {
+            const auto output = blocks + row * blocksWide * size;
+
+            for (size_t column { 0 }; column < blocksWide; ++column)
+            {
+                const auto block = loadBlock (texels, width, height, components, column, row);
+                encodeBlock (block, format, output + column * size);
+            }
+        }
+    }
+}
+
+
+namespace util
+{
+    size_t blockSize (const BlockFormat format) noexcept
+    {
+        return format == BlockFormat::BC1 || format == BlockFormat::BC4 ? 8 : 16;
+    }
+
+
+    size_t compressedSize (const size_t width, const size_t height, const BlockFormat format) noexcept
+    {
+        return ((width + 3) / 4) * ((height + 3) / 4) * blockSize (format);
+    }
+
+
+    void compressImage (const void* source, const size_t width, const size_t height, const size_t components,
+        const size_t bytesPerComponent, const BlockFormat format, void* destination)
+    {
+        if (width == 0 || height == 0 || components < 1 || components > 4)
+        {
+            return;
+        }
+
+        if (bytesPerComponent == 1)
+        {
+            compress<std::uint8_t> (source, width, height, components, format, destination);
+        }
+
+        else if (bytesPerComponent == 2)
+        {
+            compress<std::uint16_t> (source, width, height, components, format, destination);
+        }
+    }
+}
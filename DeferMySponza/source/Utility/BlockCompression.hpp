@@ -0,0 +1,45 @@
+#pragma once
+
+#if !defined    _UTIL_BLOCK_COMPRESSION_
+#define         _UTIL_BLOCK_COMPRESSION_
+
+// STL headers.
+#include <cstddef>
+
+
+namespace util
+{
+    /// <summary> The block compression formats which images can be encoded in, each block covers 4x4 texels. </summary>
+    enum class BlockFormat
+    {
+        BC1,    //!< RGB endpoints stored as 5:6:5 with two-bit indices, 8 bytes per block. Alpha is discarded.
+        BC4,    //!< A single channel with 8-bit endpoints and three-bit indices, 8 bytes per block.
+        BC5,    //!< Two BC4 blocks, one for red and one for green, 16 bytes per block.
+        BC7     //!< RGBA encoded using mode 6 only; 7:7:7:7 endpoints with p-bits and four-bit indices, 16 bytes.
+    };
+
+
+    /// <summary> Gets how many bytes each 4x4 block occupies in the given format. </summary>
+    size_t blockSize (const BlockFormat format) noexcept;
+
+    /// <summary> Calculates how many bytes an image of the given dimensions occupies once compressed. </summary>
+    size_t compressedSize (const size_t width, const size_t height, const BlockFormat format) noexcept;
+
+    /// <summary>
+    /// Compresses a tightly packed image into rows of 4x4 blocks. Images which aren't a multiple of four in each
+    /// dimension, such as the smallest mipmap levels, are padded by repeating the edge texels. Endpoints are fitted
+    /// along the principal axis of each block and refined with a least squares pass, texels are evaluated with SSE2.
+    /// Compression runs on the calling thread, callers already compress separate images in parallel.
+    /// </summary>
+    /// <param name="source"> The texels of the image. </param>
+    /// <param name="width"> How many texels wide the image is. </param>
+    /// <param name="height"> How many texels tall the image is. </param>
+    /// <param name="components"> How many components each texel has, 1 to 4. Missing alpha is opaque. </param>
+    /// <param name="bytesPerComponent"> The size of each component, 1 or 2. 16-bit data is reduced to 8-bit. </param>
+    /// <param name="format"> The format to compress the image into. </param>
+    /// <param name="destination"> Where the blocks should be written, this must be compressedSize() bytes. </param>
+    void compressImage (const void* source, const size_t width, const size_t height, const size_t components,
+        const size_t bytesPerComponent, const BlockFormat format, void* destination);
+}
+
+#endif // _UTIL_BLOCK_COMPRESSION_
@@ -0,0 +1,162 @@
+#pragma once
+
+#if !defined    _UTIL_DENSE_ID_MAP_
+#define         _UTIL_DENSE_ID_MAP_
+
+// STL headers.
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+/// <summary>
+/// Maps integral IDs to values using a flat array indexed by the offset from the smallest stored ID. Scene IDs are
+/// allocated sequentially for each type so lookups are a subtraction and an array access rather than a hash, at the
+/// cost of a slot for every ID between the smallest and largest stored.
+/// </summary>
+template <typename ID, typename Value>
+class DenseIDMap final
+{
+    public:
+
+        DenseIDMap() noexcept                               = default;
+        DenseIDMap (DenseIDMap&&) noexcept                  = default;
+        DenseIDMap (const DenseIDMap&)                      = default;
+        DenseIDMap& operator= (const DenseIDMap&)           = default;
+        DenseIDMap& operator= (DenseIDMap&&) noexcept       = default;
+        ~DenseIDMap()                                       = default;
+
+
+        /// <summary> Gets the value stored for the given ID, the ID must have been stored. </summary>
+        inline const Value& operator[] (const ID id) const noexcept;
+
+        /// <summary> Gets how many IDs have been stored. </summary>
+        inline size_t size() const noexcept                 { return m_count; }
+
+        /// <summary> Checks whether a value has been stored for the given ID. </summary>
+        inline bool contains (const ID id) const noexcept;
+
+        /// <summary> Gets the value stored for the given ID or the given fallback if there isn't one. </summary>
+        inline Value get (const ID id, const Value fallback) const noexcept;
+
+
+        /// <summary> Stores the given value for the given ID, replacing any existing value. </summary>
+        void set (const ID id, Value value) noexcept;
+
+        /// <summary> Reserves enough slots for the given range of IDs, avoiding reallocation as they're stored. </summary>
+        void reserve (const size_t range) noexcept;
+
+        /// <summary> Removes every stored value. </summary>
+        void clear() noexcept;
+
+        /// <summary> Calls the given function with the ID and value of every stored value, in ID order. </summary>
+        /// <param name="func"> A function taking an ID and a const reference to a value. </param>
+        template <typename Func>
+        void forEach (const Func& func) const;
+
+    private:
+
+        ID                          m_first     { 0 };  //!< The ID stored in the first slot.
+        std::vector<Value>          m_values    { };    //!< The value of each ID from the first onwards.
+        std::vector<std::uint8_t>   m_stored    { };    //!< Whether each slot contains a value.
+        size_t                      m_count     { 0 };  //!< How many slots contain a value.
+
+        /// <summary> Gets the slot of the given ID, this will be out of range if it precedes the first ID. </summary>
+        inline size_t slot (const ID id) const noexcept { return static_cast<size_t> (id - m_first); }
+};
+
+
+template <typename ID, typename Value>
+const Value& DenseIDMap<ID, Value>::operator[] (const ID id) const noexcept
+{
+    assert (contains (id));
+    return m_values[slot (id)];
+}
+
+
+template <typename ID, typename Value>
+bool DenseIDMap<ID, Value>::contains (const ID id) const noexcept
+{
+    // Unsigned IDs preceding the first will wrap around and be rejected too.
+    const auto index = slot (id);
+    return id >= m_first && index < m_stored.size() && m_stored[index] != 0;
+}
+
+
+template <typename ID, typename Value>
+Value DenseIDMap<ID, Value>::get (const ID id, const Value fallback) const noexcept
+{
+    return contains (id) ? m_values[slot (id)] : fallback;
+}
+
+
+template <typename ID, typename Value>
+void DenseIDMap<ID, Value>::set (const ID id, Value value) noexcept
+{
+    // The first ID stored becomes the base, IDs preceding it require every slot to be shifted.
+    if (m_count == 0)
+    {
+        m_values.clear();
+        m_stored.clear();
+        m_first = id;
+    }
+
+    else if (id < m_first)
+    {
+        const auto shift = static_cast<size_t> (m_first - id);
+        m_values.insert (std::begin (m_values), shift, Value { });
+        m_stored.insert (std::begin (m_stored), shift, std::uint8_t { 0 });
+        m_first = id;
+    }
+
+    const auto index = slot (id);
+    if (index >= m_values.size())
+    {
+        m_values.resize (index + 1);
+        m_stored.resize (index + 1, 0);
+    }
+
+    if (m_stored[index] == 0)
+    {
+        m_stored[index] = 1;
+        ++m_count;
+    }
+
+    m_values[index] = std::move (value);
+}
+
+
+template <typename ID, typename Value>
+void DenseIDMap<ID, Value>::reserve (const size_t range) noexcept
+{
+    m_values.reserve (range);
+    m_stored.reserve (range);
+}
+
+
+template <typename ID, typename Value>
+void DenseIDMap<ID, Value>::clear() noexcept
+{
+    m_first = ID { 0 };
+    m_values.clear();
+    m_stored.clear();
+    m_count = 0;
+}
+
+
+template <typename ID, typename Value>
+template <typename Func>
+void DenseIDMap<ID, Value>::forEach (const Func& func) const
+{
+    for (size_t i { 0 }; i < m_values.size(); ++i)
+    {
+        if (m_stored[i] != 0)
+        {
+            func (static_cast<ID> (m_first + i), m_values[i]);
+        }
+    }
+}
+
+#endif // _UTIL_DENSE_ID_MAP_
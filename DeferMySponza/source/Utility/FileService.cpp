@@ -0,0 +1,245 @@
+#include "FileService.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+
+// Engine headers.
+#include <tygra/FileHelper.hpp>
+
+
+// Constants.
+constexpr auto maxThreads = size_t { 4 };    //!< Reads are I/O bound, beyond a few threads the disk becomes the limit.
+constexpr auto pageSize   = size_t { 4096 }; //!< The smallest page size of supported platforms.
+
+
+namespace
+{
+    /// <summary> Fulfils a promise with an empty result, as tygra does on failure. </summary>
+    template <typename T>
+    void setEmpty (std::promise<T>& promise)
+    {
+        promise.set_value (T { });
+    }
+
+
+    /// <summary> Maps the given file and touches every page so the OS reads it in before returning. </summary>
+    MappedFile mapFile (const std::string& fileLocation) noexcept
+    {
+        auto file = MappedFile { };
+        if (file.initialise (fileLocation))
+        {
+            // Volatile reads can't be optimised away.
+            const auto bytes = static_cast<const volatile std::uint8_t*> (file.getData());
+            for (size_t i { 0 }; i < file.getSize(); i += pageSize)
+            {
+                static_cast<void> (bytes[i]);
+            }
+        }
+
+        return file;
+    }
+
+
+    /// <summary> Performs a read, fulfilling the promise with an empty result if the reader throws. </summary>
+    template <typename T, typename Reader>
+    void performRead (std::promise<T>& promise, const std::string& uri, const Reader& reader) noexcept
+    {
+        try
+        {
+            promise.set_value (reader (uri));
+        }
+
+        catch (const std::exception& e)
+        {
+            std::cerr << "FileService: Unable to read \"" << uri << "\": " << e.what() << std::endl;
+            setEmpty (promise);
+        }
+    }
+}
+
+
+FileService::FileService() noexcept
+{
+    try
+    {
+        const auto hardwareThreads  = static_cast<size_t> (std::thread::hardware_concurrency());
+        const auto threadCount      = std::max (std::min (hardwareThreads, maxThreads), size_t { 1 });
+
+        m_threads.reserve (threadCount);
+        for (size_t i { 0 }; i < threadCount; ++i)
+        {
+            m_threads.emplace_back ([this] { process(); });
+        }
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "FileService::FileService(): Unable to start I/O threads: " << e.what() << std::endl;
+    }
+}
+
+
+FileService::~FileService()
+{
+    {
+        const std::lock_guard<std::mutex> lock { m_mutex };
+        m_stopping = true;
+    }
+
+    m_signal.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+
+FileService& FileService::instance() noexcept
+{
+    static FileService service { };
+    return service;
+}
+
+
+void FileService::prefetchText (const std::string& uri, const Priority priority) noexcept
+{
+    prefetch (m_texts, uri, priority, [] (const std::string& file) { return tygra::createStringFromFile (file); });
+}
+
+
+FileService::Text FileService::readText (const std::string& uri, const Priority priority) noexcept
+{
+    return read (m_texts, uri, priority, [] (const std::string& file) { return tygra::createStringFromFile (file); });
+}
+
+
+void FileService::prefetchFile (const std::string& fileLocation, const Priority priority) noexcept
+{
+    prefetch (m_files, fileLocation, priority, [] (const std::string& file) { return mapFile (file); });
+}
+
+
+FileService::Mapping FileService::readFile (const std::string& fileLocation, const Priority priority) noexcept
+{
+    return read (m_files, fileLocation, priority, [] (const std::string& file) { return mapFile (file); });
+}
+
+
+
+void FileService::process() noexcept
+{
+    while (true)
+    {
+        auto job = std::shared_ptr<Job> { };
+
+        {
+            auto lock = std::unique_lock<std::mutex> { m_mutex };
+            m_signal.wait (lock, [this] { return m_stopping || !m_queue.empty(); });
+
+            if (m_stopping)
+            {
+                return;
+            }
+
+            job = m_queue.top().job;
+            m_queue.pop();
+        }
+
+        // Jobs which have been promoted are queued more than once, only the first request will perform the read.
+        if (!job->started.test_and_set())
+        {
+            job->work();
+        }
+    }
+}
+
+
+void FileService::enqueue (const std::shared_ptr<Job>& job, const Priority priority)
+{
+    auto request        = Request { };
+    request.priority    = priority;
+    request.sequence    = m_sequence++;
+    request.job         = job;
+
+    m_queue.push (std::move (request));
+    m_signal.notify_one();
+}
+
+
+template <typename T, typename Reader>
+FileService::Pending<T> FileService::createJob (const std::string& uri, Reader&& reader)
+{
+    // The promise is shared because std::function requires copyable functions.
+    auto promise    = std::make_shared<std::promise<T>>();
+    auto pending    = Pending<T> { };
+    pending.job     = std::make_shared<Job>();
+    pending.result  = promise->get_future();
+
+    pending.job->work = [promise, uri, reader] { performRead (*promise, uri, reader); };
+
+    return pending;
+}
+
+
+template <typename T, typename Reader>
+void FileService::prefetch (PendingMap<T>& pending, const std::string& uri, const Priority priority, Reader&& reader)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock { m_mutex };
+
+        if (pending.find (uri) == std::end (pending))
+        {
+            auto job = createJob<T> (uri, std::forward<Reader> (reader));
+            enqueue (job.job, priority);
+            pending.emplace (uri, std::move (job));
+        }
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "FileService::prefetch(): Unable to queue \"" << uri << "\": " << e.what() << std::endl;
+    }
+}
+
+
+template <typename T, typename Reader>
+std::future<T> FileService::read (PendingMap<T>& pending, const std::string& uri, const Priority priority,
+    Reader&& reader)
+{
+    try
+    {
+        const std::lock_guard<std::mutex> lock { m_mutex };
+
+        // Claim any prefetched read, queueing it again at the new priority. This is harmless if it already started.
+        const auto iterator = pending.find (uri);
+        if (iterator != std::end (pending))
+        {
+            auto job = std::move (iterator->second);
+            pending.erase (iterator);
+
+            if (priority > Priority::Low)
+            {
+                enqueue (job.job, priority);
+            }
+
+            return std::move (job.result);
+        }
+
+        auto job = createJob<T> (uri, std::forward<Reader> (reader));
+        enqueue (job.job, priority);
+        return std::move (job.result);
+    }
+
+    catch (...)
+    {
+        // We can't queue the read so perform it on the calling thread instead.
+        auto promise = std::promise<T> { };
+        performRead (promise, uri, reader);
+        return promise.get_future();
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#if !defined    _UTIL_FILE_SERVICE_
+#define         _UTIL_FILE_SERVICE_
+
+// STL headers.
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+
+// Personal headers.
+#include <Utility/MappedFile.hpp>
+
+
+/// <summary>
+/// An asynchronous front end to tygra::createStringFromFile() and MappedFile. Reads are performed by a small pool of
+/// I/O threads in priority order. Files can be prefetched as soon as they're known to be needed; a later read of the
+/// same file will claim the prefetched result, raising its priority if it hasn't started yet. Shaders are read as
+/// text whereas texture sources and texture cache entries are mapped, see CachedTexture.
+/// </summary>
+class FileService final
+{
+    public:
+
+        /// <summary> Determines the order in which queued reads are performed. </summary>
+        enum class Priority : int
+        {
+            Low     = 0,    //!< Speculative prefetches.
+            Normal  = 1,    //!< Data which will be needed soon.
+            High    = 2     //!< Data which is being waited on.
+        };
+
+        using Text      = std::future<std::string>;
+        using Mapping   = std::future<MappedFile>;
+
+    public:
+
+        FileService() noexcept;
+        ~FileService();
+
+        FileService (FileService&&)                 = delete;
+        FileService (const FileService&)            = delete;
+        FileService& operator= (FileService&&)      = delete;
+        FileService& operator= (const FileService&) = delete;
+
+
+        /// <summary> Gets the service shared by the entire application. </summary>
+        static FileService& instance() noexcept;
+
+
+        /// <summary>
+        /// Queues the given text file for reading. The result can be claimed later by calling readText().
+        /// Prefetching a file that is already queued has no effect.
+        /// </summary>
+        void prefetchText (const std::string& uri, const Priority priority = Priority::Low) noexcept;
+
+        /// <summary>
+        /// Reads the given text file asynchronously, claiming the result of a previous prefetch if one exists. The
+        /// string will be empty if the file couldn't be read.
+        /// </summary>
+        /// <param name="uri"> The location of the file, any URI supported by tygra can be used. </param>
+        /// <param name="priority"> The priority of the read, prefetched files will be raised to this priority. </param>
+        Text readText (const std::string& uri, const Priority priority = Priority::High) noexcept;
+
+        /// <summary>
+        /// Queues the given file for mapping. The result can be claimed later by calling readFile(). Prefetching a
+        /// file that is already queued has no effect.
+        /// </summary>
+        void prefetchFile (const std::string& fileLocation, const Priority priority = Priority::Low) noexcept;
+
+        /// <summary>
+        /// Maps the given file asynchronously and pages its contents in, so the mapping can be consumed without
+        /// stalling on the disk. A previous prefetch will be claimed if one exists. The mapping will be uninitialised
+        /// if the file couldn't be mapped.
+        /// </summary>
+        /// <param name="fileLocation"> The local path of the file, URIs aren't supported. </param>
+        /// <param name="priority"> The priority of the read, prefetched files will be raised to this priority. </param>
+        Mapping readFile (const std::string& fileLocation, const Priority priority = Priority::High) noexcept;
+
+    private:
+
+        /// <summary> A read which will be performed exactly once, regardless of how many times it's queued. </summary>
+        struct Job final
+        {
+            std::atomic_flag        started = ATOMIC_FLAG_INIT; //!< Set by the first thread to run the job.
+            std::function<void()>   work    { };                //!< Performs the read and fulfils the promise.
+        };
+
+        /// <summary> An entry in the queue, a job may be queued multiple times at different priorities. </summary>
+        struct Request final
+        {
+            Priority                priority    { Priority::Normal };   //!< Higher priorities are read first.
+            size_t                  sequence    { 0 };                  //!< Ensures FIFO order within a priority.
+            std::shared_ptr<Job>    job         { };                    //!< The job to run.
+
+            bool operator< (const Request& rhs) const noexcept
+            {
+                return priority != rhs.priority ? priority < rhs.priority : sequence > rhs.sequence;
+            }
+        };
+
+        /// <summary> A prefetched read waiting to be claimed. </summary>
+        template <typename T>
+        struct Pending final
+        {
+            std::shared_ptr<Job>    job     { };    //!< The job performing the read.
+            std::future<T>          result  { };    //!< Where the result will be stored.
+        };
+
+        template <typename T>
+        using PendingMap = std::unordered_map<std::string, Pending<T>>;
+
+        std::mutex                      m_mutex     { };        //!< Protects the queue and pending reads.
+        std::condition_variable         m_signal    { };        //!< Wakes I/O threads when work is queued.
+        std::priority_queue<Request>    m_queue     { };        //!< Reads waiting to be performed.
+        PendingMap<std::string>         m_texts     { };        //!< Prefetched text files waiting to be claimed.
+        PendingMap<MappedFile>          m_files     { };        //!< Prefetched mappings waiting to be claimed.
+        std::vector<std::thread>        m_threads   { };        //!< The I/O threads.
+        size_t                          m_sequence  { 0 };      //!< The sequence number of the next request.
+        bool                            m_stopping  { false };  //!< Tells the I/O threads to exit.
+
+    private:
+
+        /// <summary> Runs on each I/O thread, performing queued reads until the service is destroyed. </summary>
+        void process() noexcept;
+
+        /// <summary> Adds the given job to the queue. The mutex must be locked. </summary>
+        void enqueue (const std::shared_ptr<Job>& job, const Priority priority);
+
+        /// <summary> Creates a job which produces a result using the given function. </summary>
+        template <typename T, typename Reader>
+        static Pending<T> createJob (const std::string& uri, Reader&& reader);
+
+        /// <summary> Implements prefetchText() and prefetchFile(). </summary>
+        template <typename T, typename Reader>
+        void prefetch (PendingMap<T>& pending, const std::string& uri, const Priority priority, Reader&& reader);
+
+        /// <summary> Implements readText() and readFile(). </summary>
+        template <typename T, typename Reader>
+        std::future<T> read (PendingMap<T>& pending, const std::string& uri, const Priority priority,
+            Reader&& reader);
+};
+
+#endif // _UTIL_FILE_SERVICE_
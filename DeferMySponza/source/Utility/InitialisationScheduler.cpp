@@ -0,0 +1,41 @@
+#include "InitialisationScheduler.hpp"
+
+
+bool InitialisationScheduler::run() noexcept
+{
+    // A missing stage would leave later stages without the data they depend on.
+    if (m_failed)
+    {
+        return false;
+    }
+
+    for (auto& stage : m_stages)
+    {
+        // Exceptions thrown during preparation are rethrown when the result is consumed, they count as a failure.
+        auto succeeded  = false;
+        auto reason     = std::string { };
+
+        try
+        {
+            succeeded = stage.consume();
+        }
+
+        catch (const std::exception& e)
+        {
+            reason = std::string { ": " } + e.what();
+        }
+
+        catch (...)
+        {
+            reason = ": unknown exception";
+        }
+
+        if (!succeeded)
+        {
+            std::cerr << "InitialisationScheduler::run(): \"" << stage.name << "\" failed" << reason << "." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#if !defined    _UTIL_INITIALISATION_SCHEDULER_
+#define         _UTIL_INITIALISATION_SCHEDULER_
+
+// STL headers.
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Personal headers.
+#include <Utility/StartupTimeline.hpp>
+
+
+/// <summary>
+/// Splits initialisation into stages which each have an optional CPU-only preparation step and a consumption step
+/// which must run on the thread that owns the OpenGL context. Preparation starts on a worker thread as soon as a stage
+/// is added, run() then consumes each stage in the order they were added, only waiting when a result isn't ready yet.
+/// This means startup is bounded by the slowest preparation step rather than the sum of every step.
+/// </summary>
+class InitialisationScheduler final
+{
+    public:
+
+        InitialisationScheduler() noexcept                                  = default;
+        InitialisationScheduler (InitialisationScheduler&&) noexcept        = default;
+        InitialisationScheduler& operator= (InitialisationScheduler&&)      = default;
+        ~InitialisationScheduler()                                          = default;
+
+        InitialisationScheduler (const InitialisationScheduler&)            = delete;
+        InitialisationScheduler& operator= (const InitialisationScheduler&) = delete;
+
+
+        /// <summary>
+        /// Adds a stage which prepares data on a worker thread and consumes it on the thread which calls run(). The
+        /// preparation function must not make any OpenGL calls or modify state used by other stages.
+        /// </summary>
+        /// <param name="name"> Used to identify the stage if it fails. </param>
+        /// <param name="prepare"> Returns the prepared data, this is started immediately. </param>
+        /// <param name="consume"> Takes the prepared data as an rvalue and returns whether it succeeded. </param>
+        template <typename Prepare, typename Consume>
+        void add (std::string name, Prepare&& prepare, Consume&& consume) noexcept;
+
+        /// <summary> Adds a stage with no preparation, it only runs on the thread which calls run(). </summary>
+        /// <param name="name"> Used to identify the stage if it fails. </param>
+        /// <param name="consume"> Takes no parameters and returns whether it succeeded. </param>
+        template <typename Consume>
+        void add (std::string name, Consume&& consume) noexcept;
+
+        /// <summary>
+        /// Consumes every stage in the order they were added. Processing stops at the first stage to fail, a stage
+        /// whose preparation or consumption throws is treated as failing. Any outstanding preparation will be
+        /// finished when the scheduler is destroyed.
+        /// </summary>
+        /// <returns> Whether every stage succeeded. </returns>
+        bool run() noexcept;
+
+    private:
+
+        /// <summary> A unit of work to be performed on the OpenGL thread. </summary>
+        struct Stage final
+        {
+            std::string             name    { };    //!< Identifies the stage in error messages.
+            std::function<bool()>   consume { };    //!< Waits for any preparation and consumes the result.
+        };
+
+        std::vector<Stage>  m_stages    { };        //!< Every stage, in the order they should be consumed.
+        bool                m_failed    { false };  //!< Whether a stage couldn't be added.
+};
+
+
+// STL headers.
+#include <iostream>
+
+
+template <typename Prepare, typename Consume>
+void InitialisationScheduler::add (std::string name, Prepare&& prepare, Consume&& consume) noexcept
+{
+    using Result = decltype (prepare());
+
+    try
+    {
+        // The future is shared because std::function requires copyable functions.
+        auto future     = std::async (std::launch::async, std::forward<Prepare> (prepare));
+        auto result     = std::make_shared<std::future<Result>> (std::move (future));
+        auto waitName   = "Waiting for " + name;
+
+        auto stage      = Stage { };
+        stage.name      = name;
+        stage.consume   = [result, consume, waitName] () mutable
+        {
+            // Record any time spent waiting separately so it's clear when preparation is the bottleneck.
+            {
+                const StartupTimeline::Scope phase { waitName.c_str() };
+                result->wait();
+            }
+
+            return consume (result->get());
+        };
+
+        m_stages.push_back (std::move (stage));
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "InitialisationScheduler::add(): Unable to schedule \"" << name << "\": " << e.what() << std::endl;
+        m_failed = true;
+    }
+}
+
+
+template <typename Consume>
+void InitialisationScheduler::add (std::string name, Consume&& consume) noexcept
+{
+    try
+    {
+        auto stage      = Stage { };
+        stage.name      = name;
+        stage.consume   = std::forward<Consume> (consume);
+
+        m_stages.push_back (std::move (stage));
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "InitialisationScheduler::add(): Unable to schedule \"" << name << "\": " << e.what() << std::endl;
+        m_failed = true;
+    }
+}
+
+#endif // _UTIL_INITIALISATION_SCHEDULER_
@@ -0,0 +1,183 @@
+#include "MappedFile.hpp"
+
+
+// STL headers.
+#include <utility>
+
+
+// Engine headers.
+#if defined _WIN32
+    #if !defined WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #if !defined NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+
+MappedFile::MappedFile (MappedFile&& move) noexcept
+{
+    *this = std::move (move);
+}
+
+
+MappedFile& MappedFile::operator= (MappedFile&& move) noexcept
+{
+    if (this != &move)
+    {
+        // Ensure we don't leak.
+        clean();
+
+        m_data      = move.m_data;
+        m_size      = move.m_size;
+        m_file      = move.m_file;
+        move.m_data = nullptr;
+        move.m_size = 0;
+
+        #if defined _WIN32
+            m_mapping       = move.m_mapping;
+            move.m_file     = nullptr;
+            move.m_mapping  = nullptr;
+        #else
+            move.m_file     = -1;
+        #endif
+    }
+
+    return *this;
+}
+
+
+#if defined _WIN32
+
+bool MappedFile::initialise (const std::string& fileLocation) noexcept
+{
+    // Open the file for reading, informing the OS that we'll be reading the file sequentially.
+    const auto file = CreateFileA (fileLocation.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, 
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    // Empty files can't be mapped.
+    auto size = LARGE_INTEGER { };
+    if (!GetFileSizeEx (file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle (file);
+        return false;
+    }
+
+    // Now create the mapping and a view of the entire file.
+    const auto mapping = CreateFileMappingA (file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        CloseHandle (file);
+        return false;
+    }
+
+    const auto data = MapViewOfFile (mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle (mapping);
+        CloseHandle (file);
+        return false;
+    }
+
+    // Finally replace the current mapping.
+    clean();
+    m_data      = data;
+    m_size      = static_cast<size_t> (size.QuadPart);
+    m_file      = file;
+    m_mapping   = mapping;
+
+    return true;
+}
+
+
+void MappedFile::clean() noexcept
+{
+    if (m_data)
+    {
+        UnmapViewOfFile (m_data);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    if (m_mapping)
+    {
+        CloseHandle (m_mapping);
+        m_mapping = nullptr;
+    }
+
+    if (m_file)
+    {
+        CloseHandle (m_file);
+        m_file = nullptr;
+    }
+}
+
+#else
+
+bool MappedFile::initialise (const std::string& fileLocation) noexcept
+{
+    // Open the file for reading.
+    const auto file = open (fileLocation.c_str(), O_RDONLY);
+    if (file == -1)
+    {
+        return false;
+    }
+
+    // Empty files can't be mapped.
+    struct stat status { };
+    if (fstat (file, &status) != 0 || status.st_size == 0)
+    {
+        close (file);
+        return false;
+    }
+
+    // Map the entire file, informing the OS that we'll be reading the file sequentially.
+    const auto size = static_cast<size_t> (status.st_size);
+    const auto data = mmap (nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED)
+    {
+        close (file);
+        return false;
+    }
+
+    madvise (data, size, MADV_SEQUENTIAL);
+
+    // Finally replace the current mapping.
+    clean();
+    m_data  = data;
+    m_size  = size;
+    m_file  = file;
+
+    return true;
+}
+
+
+void MappedFile::clean() noexcept
+{
+    if (m_data)
+    {
+        munmap (const_cast<void*> (m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+
+    if (m_file != -1)
+    {
+        close (m_file);
+        m_file = -1;
+    }
+}
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#if !defined    _UTIL_MAPPED_FILE_
+#define         _UTIL_MAPPED_FILE_
+
+// STL headers.
+#include <cstddef>
+#include <string>
+
+
+/// <summary>
+/// An RAII encapsulation of a read-only memory-mapped file. The contents of the file are paged in by the OS on demand
+/// so large files can be consumed without first copying them into application memory.
+/// </summary>
+class MappedFile final
+{
+    public:
+
+        MappedFile() noexcept                       = default;
+        MappedFile (MappedFile&& move) noexcept;
+        MappedFile& operator= (MappedFile&& move) noexcept;
+
+        MappedFile (const MappedFile&)              = delete;
+        MappedFile& operator= (const MappedFile&)   = delete;
+
+        ~MappedFile() { clean(); }
+
+
+        /// <summary> Check if a file is currently mapped. </summary>
+        inline bool isInitialised() const noexcept  { return m_data != nullptr; }
+
+        /// <summary> Gets a pointer to the start of the mapped file. </summary>
+        inline const void* getData() const noexcept { return m_data; }
+
+        /// <summary> Gets the size of the mapped file in bytes. </summary>
+        inline size_t getSize() const noexcept      { return m_size; }
+
+
+        /// <summary>
+        /// Attempts to map the given file into memory for reading. Empty files cannot be mapped. Successive calls will
+        /// only modify the object if successful.
+        /// </summary>
+        /// <param name="fileLocation"> The location of the file to map. </param>
+        /// <returns> Whether the file was successfully mapped. </returns>
+        bool initialise (const std::string& fileLocation) noexcept;
+
+        /// <summary> Unmaps the file and closes any open handles. </summary>
+        void clean() noexcept;
+
+    private:
+
+        const void* m_data      { nullptr };    //!< The start of the mapped view of the file.
+        size_t      m_size      { 0 };          //!< How many bytes have been mapped.
+
+        #if defined _WIN32
+            void*   m_file      { nullptr };    //!< The handle of the opened file.
+            void*   m_mapping   { nullptr };    //!< The handle of the file mapping object.
+        #else
+            int     m_file      { -1 };         //!< The descriptor of the opened file.
+        #endif
+};
+
+#endif // _UTIL_MAPPED_FILE_
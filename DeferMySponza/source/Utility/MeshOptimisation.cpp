@@ -0,0 +1,330 @@
+#include "MeshOptimisation.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+
+// Engine headers.
+#include <glm/geometric.hpp>
+
+
+// Personal headers.
+#include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
+
+
+namespace
+{
+    constexpr auto noVertex = std::numeric_limits<size_t>::max(); //!< Marks the end of Tipsify.
+
+
+    /// <summary> Checks whether the elements form a triangle list which only references existing vertices. </summary>
+    bool isValidTriangleList (const GLuint* elements, const size_t elementCount, const size_t vertexCount) noexcept
+    {
+        return elementCount % 3 == 0 && std::all_of (elements, elements + elementCount,
+            [=] (const GLuint element) { return element < vertexCount; });
+    }
+
+
+    /// <summary> The triangles which use each vertex, stored contiguously with an offset per vertex. </summary>
+    struct Adjacency final
+    {
+        std::vector<size_t> offsets     { };    //!< Where the triangles of each vertex start, one more than vertices.
+        std::vector<size_t> triangles   { };    //!< The triangles of every vertex.
+
+        Adjacency (const GLuint* elements, const size_t elementCount, const size_t vertexCount)
+            : offsets (vertexCount + 1, 0), triangles (elementCount)
+        {
+            for (size_t i { 0 }; i < elementCount; ++i)
+            {
+                ++offsets[elements[i] + 1];
+            }
+
+            std::partial_sum (std::begin (offsets), std::end (offsets), std::begin (offsets));
+
+            auto next = std::vector<size_t> (std::begin (offsets), std::end (offsets) - 1);
+            for (size_t i { 0 }; i < elementCount; ++i)
+            {
+                triangles[next[elements[i]]++] = i / 3;
+            }
+        }
+
+        inline size_t count (const size_t vertex) const noexcept    { return offsets[vertex + 1] - offsets[vertex]; }
+        inline const size_t* begin (const size_t vertex) const      { return triangles.data() + offsets[vertex]; }
+        inline const size_t* end (const size_t vertex) const        { return triangles.data() + offsets[vertex + 1]; }
+    };
+}
+
+
+util::VertexCacheStatistics util::analyseVertexCache (const GLuint* elements, const size_t elementCount,
+    const size_t vertexCount, const size_t cacheSize)
+{
+    // A vertex is in the cache if fewer than cacheSize vertices have been inserted since it was.
+    auto insertedAt = std::vector<size_t> (vertexCount, 0);
+    auto referenced = std::vector<bool> (vertexCount, false);
+    auto time       = cacheSize + 1;
+    auto statistics = VertexCacheStatistics { };
+
+    for (size_t i { 0 }; i < elementCount; ++i)
+    {
+        const auto vertex = elements[i];
+        if (time - insertedAt[vertex] > cacheSize)
+        {
+            insertedAt[vertex] = time++;
+            ++statistics.transformed;
+        }
+
+        if (!referenced[vertex])
+        {
+            referenced[vertex] = true;
+            ++statistics.vertices;
+        }
+    }
+
+    statistics.triangles = elementCount / 3;
+    return statistics;
+}
+
+
+std::vector<size_t> util::optimiseVertexCache (GLuint* elements, const size_t elementCount, const size_t vertexCount,
+    const size_t cacheSize)
+{
+    const auto triangleCount    = elementCount / 3;
+    const auto adjacency        = Adjacency { elements, elementCount, vertexCount };
+
+    auto live       = std::vector<size_t> (vertexCount);
+    auto insertedAt = std::vector<size_t> (vertexCount, 0);
+    auto emitted    = std::vector<bool> (triangleCount, false);
+    auto deadEnds   = std::vector<size_t> { };
+    auto candidates = std::vector<size_t> { };
+    auto output     = std::vector<GLuint> { };
+    auto clusters   = std::vector<size_t> { };
+    auto time       = cacheSize + 1;
+    auto cursor     = size_t { 0 };
+
+    for (size_t v { 0 }; v < vertexCount; ++v)
+    {
+        live[v] = adjacency.count (v);
+    }
+
+    output.reserve (elementCount);
+
+    // When the fan runs out of candidates we continue from the most recently used vertex which still has triangles,
+    // otherwise the next vertex in input order. The latter means the cache is cold so a new cluster starts.
+    const auto skipDeadEnd = [&]
+    {
+        while (!deadEnds.empty())
+        {
+            const auto vertex = deadEnds.back();
+            deadEnds.pop_back();
+
+            if (live[vertex] > 0)
+            {
+                return vertex;
+            }
+        }
+
+        for (; cursor < vertexCount; ++cursor)
+        {
+            if (live[cursor] > 0)
+            {
+                return cursor;
+            }
+        }
+
+        return noVertex;
+    };
+
+    // Prefer the candidate which will be in the cache longest whilst its remaining triangles are emitted.
+    const auto nextVertex = [&]
+    {
+        auto best       = noVertex;
+        auto bestAge    = size_t { 0 };
+
+        for (const auto vertex : candidates)
+        {
+            if (live[vertex] == 0)
+            {
+                continue;
+            }
+
+            const auto age      = time - insertedAt[vertex];
+            const auto priority = age + 2 * live[vertex] <= cacheSize ? age : 0;
+
+            if (best == noVertex || priority > bestAge)
+            {
+                best    = vertex;
+                bestAge = priority;
+            }
+        }
+
+        return best != noVertex ? best : skipDeadEnd();
+    };
+
+    for (auto fan = skipDeadEnd(); fan != noVertex; fan = nextVertex())
+    {
+        if (time - insertedAt[fan] > cacheSize)
+        {
+            clusters.push_back (output.size() / 3);
+        }
+
+        candidates.clear();
+        for (auto triangle = adjacency.begin (fan); triangle != adjacency.end (fan); ++triangle)
+        {
+            if (emitted[*triangle])
+            {
+                continue;
+            }
+
+            for (size_t corner { 0 }; corner < 3; ++corner)
+            {
+                const auto vertex = static_cast<size_t> (elements[*triangle * 3 + corner]);
+                output.push_back (static_cast<GLuint> (vertex));
+                deadEnds.push_back (vertex);
+                candidates.push_back (vertex);
+                --live[vertex];
+
+                if (time - insertedAt[vertex] > cacheSize)
+                {
+                    insertedAt[vertex] = time++;
+                }
+            }
+
+            emitted[*triangle] = true;
+        }
+    }
+
+    std::copy (std::begin (output), std::end (output), elements);
+    return clusters;
+}
+
+
+void util::optimiseOverdraw (GLuint* elements, const size_t elementCount, const Vertex* vertices,
+    const std::vector<size_t>& clusters)
+{
+    const auto triangleCount = elementCount / 3;
+    if (clusters.size() < 2)
+    {
+        return;
+    }
+
+    // Area weighted centroids and normals of each cluster and the mesh as a whole.
+    auto centroids  = std::vector<glm::vec3> (clusters.size(), glm::vec3 { 0.f });
+    auto normals    = std::vector<glm::vec3> (clusters.size(), glm::vec3 { 0.f });
+    auto areas      = std::vector<float> (clusters.size(), 0.f);
+    auto meshCentre = glm::vec3 { 0.f };
+    auto meshArea   = 0.f;
+
+    for (size_t c { 0 }; c < clusters.size(); ++c)
+    {
+        const auto last = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+        for (auto t = clusters[c]; t < last; ++t)
+        {
+            const auto& a       = vertices[elements[t * 3]].position;
+            const auto& b       = vertices[elements[t * 3 + 1]].position;
+            const auto& v       = vertices[elements[t * 3 + 2]].position;
+            const auto normal   = glm::cross (b - a, v - a);
+            const auto area     = glm::length (normal);
+            const auto centre   = (a + b + v) / 3.f;
+
+            centroids[c]    += centre * area;
+            normals[c]      += normal;
+            areas[c]        += area;
+        }
+
+        meshCentre  += centroids[c];
+        meshArea    += areas[c];
+    }
+
+    meshCentre = meshArea > 0.f ? meshCentre / meshArea : meshCentre;
+
+    // Clusters which face away from the centre and sit furthest along their normal should be drawn first.
+    auto sortKeys = std::vector<float> (clusters.size(), 0.f);
+    for (size_t c { 0 }; c < clusters.size(); ++c)
+    {
+        const auto normalLength = glm::length (normals[c]);
+        if (areas[c] > 0.f && normalLength > 0.f)
+        {
+            sortKeys[c] = glm::dot (centroids[c] / areas[c] - meshCentre, normals[c] / normalLength);
+        }
+    }
+
+    // A stable sort keeps the cache order of clusters with equal keys so the result is deterministic.
+    auto order = std::vector<size_t> (clusters.size());
+    std::iota (std::begin (order), std::end (order), size_t { 0 });
+    std::stable_sort (std::begin (order), std::end (order),
+        [&] (const size_t lhs, const size_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+    auto output = std::vector<GLuint> { };
+    output.reserve (elementCount);
+
+    for (const auto c : order)
+    {
+        const auto first    = clusters[c] * 3;
+        const auto last     = (c + 1 < clusters.size() ? clusters[c + 1] : triangleCount) * 3;
+        output.insert (std::end (output), elements + first, elements + last);
+    }
+
+    std::copy (std::begin (output), std::end (output), elements);
+}
+
+
+void util::optimiseVertexFetch (GLuint* elements, const size_t elementCount, Vertex* vertices,
+    const size_t vertexCount)
+{
+    constexpr auto unmapped = std::numeric_limits<GLuint>::max();
+
+    auto remap  = std::vector<GLuint> (vertexCount, unmapped);
+    auto next   = GLuint { 0 };
+
+    for (size_t i { 0 }; i < elementCount; ++i)
+    {
+        auto& mapped = remap[elements[i]];
+        if (mapped == unmapped)
+        {
+            mapped = next++;
+        }
+
+        elements[i] = mapped;
+    }
+
+    for (auto& mapped : remap)
+    {
+        if (mapped == unmapped)
+        {
+            mapped = next++;
+        }
+    }
+
+    auto reordered = std::vector<Vertex> (vertexCount);
+    for (size_t v { 0 }; v < vertexCount; ++v)
+    {
+        reordered[remap[v]] = vertices[v];
+    }
+
+    std::copy (std::begin (reordered), std::end (reordered), vertices);
+}
+
+
+util::MeshOptimisationReport util::optimiseMesh (GLuint* elements, const size_t elementCount, Vertex* vertices,
+    const size_t vertexCount, const size_t cacheSize)
+{
+    auto report = MeshOptimisationReport { };
+    if (elementCount == 0 || !isValidTriangleList (elements, elementCount, vertexCount))
+    {
+        return report;
+    }
+
+    report.before = analyseVertexCache (elements, elementCount, vertexCount, cacheSize);
+
+    const auto clusters = optimiseVertexCache (elements, elementCount, vertexCount, cacheSize);
+    optimiseOverdraw (elements, elementCount, vertices, clusters);
+    optimiseVertexFetch (elements, elementCount, vertices, vertexCount);
+
+    report.after        = analyseVertexCache (elements, elementCount, vertexCount, cacheSize);
+    report.clusters     = clusters.size();
+    report.optimised    = true;
+    return report;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#if !defined    _UTIL_MESH_OPTIMISATION_
+#define         _UTIL_MESH_OPTIMISATION_
+
+// STL headers.
+#include <cstddef>
+#include <vector>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+// Forward declarations.
+struct Vertex;
+
+
+namespace util
+{
+    constexpr auto defaultVertexCacheSize = size_t { 16 }; //!< A conservative FIFO size for post-transform caches.
+
+    /// <summary> How well a triangle list makes use of a FIFO post-transform vertex cache. </summary>
+    struct VertexCacheStatistics final
+    {
+        size_t  transformed { 0 };  //!< How many vertices missed the cache and had to be shaded.
+        size_t  triangles   { 0 };  //!< How many triangles were analysed.
+        size_t  vertices    { 0 };  //!< How many unique vertices are referenced.
+
+        /// <summary> The average cache miss ratio, shaded vertices per triangle. Lower is better, 3 is the worst. </summary>
+        inline float acmr() const noexcept { return triangles > 0 ? transformed / static_cast<float> (triangles) : 0.f; }
+
+        /// <summary> The average transformed vertex ratio, shaded vertices per unique vertex. 1 is ideal. </summary>
+        inline float atvr() const noexcept { return vertices > 0 ? transformed / static_cast<float> (vertices) : 0.f; }
+    };
+
+    /// <summary> The result of optimising a single mesh. </summary>
+    struct MeshOptimisationReport final
+    {
+        VertexCacheStatistics   before      { };        //!< The vertex cache usage of the original triangle order.
+        VertexCacheStatistics   after       { };        //!< The vertex cache usage of the optimised triangle order.
+        size_t                  clusters    { 0 };      //!< How many clusters were sorted to reduce overdraw.
+        bool                    optimised   { false };  //!< False if the mesh wasn't a valid triangle list.
+    };
+
+
+    /// <summary> Simulates a FIFO post-transform vertex cache of the given size on an indexed triangle list. </summary>
+    /// <param name="elements"> The triangle list, every element must be less than vertexCount. </param>
+    /// <param name="elementCount"> How many elements there are, a multiple of three. </param>
+    /// <param name="vertexCount"> How many vertices the elements index. </param>
+    /// <param name="cacheSize"> How many vertices the simulated cache holds. </param>
+    VertexCacheStatistics analyseVertexCache (const GLuint* elements, const size_t elementCount,
+        const size_t vertexCount, const size_t cacheSize = defaultVertexCacheSize);
+
+    /// <summary>
+    /// Reorders triangles for post-transform vertex cache locality using Tipsify, fanning around the vertex which is
+    /// most likely to remain in the cache. The order only depends on the input so the output is deterministic.
+    /// </summary>
+    /// <param name="elements"> The triangle list to reorder in place. </param>
+    /// <param name="elementCount"> How many elements there are, a multiple of three. </param>
+    /// <param name="vertexCount"> How many vertices the elements index. </param>
+    /// <param name="cacheSize"> The cache size to optimise for. </param>
+    /// <returns>
+    /// The first triangle of each cluster, starting with zero. Clusters start wherever the cache had to be refilled
+    /// so they can be reordered with optimiseOverdraw() without significantly affecting cache efficiency.
+    /// </returns>
+    std::vector<size_t> optimiseVertexCache (GLuint* elements, const size_t elementCount, const size_t vertexCount,
+        const size_t cacheSize = defaultVertexCacheSize);
+
+    /// <summary>
+    /// Sorts clusters of triangles so those facing away from the centre of the mesh are drawn first. Outward facing
+    /// clusters are more likely to occlude the rest of the mesh, reducing overdraw from any viewpoint. The triangles
+    /// within each cluster keep their order.
+    /// </summary>
+    /// <param name="elements"> The triangle list to reorder in place. </param>
+    /// <param name="elementCount"> How many elements there are, a multiple of three. </param>
+    /// <param name="vertices"> The vertices the elements index, only positions are used. </param>
+    /// <param name="clusters"> The first triangle of each cluster, as returned by optimiseVertexCache(). </param>
+    void optimiseOverdraw (GLuint* elements, const size_t elementCount, const Vertex* vertices,
+        const std::vector<size_t>& clusters);
+
+    /// <summary>
+    /// Reorders vertices into the order they're first referenced so vertex fetches stream through memory, the
+    /// elements are remapped to match. Unreferenced vertices are moved to the end in their original order.
+    /// </summary>
+    /// <param name="elements"> The triangle list to remap in place. </param>
+    /// <param name="elementCount"> How many elements there are. </param>
+    /// <param name="vertices"> The vertices to reorder in place. </param>
+    /// <param name="vertexCount"> How many vertices there are. </param>
+    void optimiseVertexFetch (GLuint* elements, const size_t elementCount, Vertex* vertices, const size_t vertexCount);
+
+    /// <summary>
+    /// Applies optimiseVertexCache(), optimiseOverdraw() and optimiseVertexFetch() in that order, analysing the
+    /// cache efficiency before and after. Meshes which aren't valid triangle lists are left untouched.
+    /// </summary>
+    MeshOptimisationReport optimiseMesh (GLuint* elements, const size_t elementCount, Vertex* vertices,
+        const size_t vertexCount, const size_t cacheSize = defaultVertexCacheSize);
+}
+
+#endif // _UTIL_MESH_OPTIMISATION_
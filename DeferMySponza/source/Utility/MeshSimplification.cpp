@@ -0,0 +1,352 @@
+#include "MeshSimplification.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <queue>
+#include <unordered_map>
+
+
+// Engine headers.
+#include <glm/geometric.hpp>
+#include <glm/vec3.hpp>
+
+
+// Personal headers.
+#include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
+
+
+namespace
+{
+    /// <summary>
+    /// The sum of squared distances to a set of planes, each weighted by the area of the triangle it came from. Only
+    /// the upper triangle of the symmetric 4x4 matrix is stored.
+    /// </summary>
+    struct Quadric final
+    {
+        double  xx { 0 }, xy { 0 }, xz { 0 }, xw { 0 },
+                          yy { 0 }, yz { 0 }, yw { 0 },
+                                    zz { 0 }, zw { 0 },
+                                              ww { 0 };
+        double  area { 0 };     //!< The total weight of every plane.
+
+        Quadric() noexcept = default;
+
+        /// <summary> Constructs the quadric of the plane dot (normal, p) + d = 0, the normal must be unit length. </summary>
+        Quadric (const glm::dvec3& normal, const double d, const double weight) noexcept
+            :   xx (weight * normal.x * normal.x), xy (weight * normal.x * normal.y), xz (weight * normal.x * normal.z),
+                xw (weight * normal.x * d), yy (weight * normal.y * normal.y), yz (weight * normal.y * normal.z),
+                yw (weight * normal.y * d), zz (weight * normal.z * normal.z), zw (weight * normal.z * d),
+                ww (weight * d * d), area (weight)
+        {
+        }
+
+        Quadric& operator+= (const Quadric& rhs) noexcept
+        {
+            xx += rhs.xx; xy += rhs.xy; xz += rhs.xz; xw += rhs.xw;
+            yy += rhs.yy; yz += rhs.yz; yw += rhs.yw;
+            zz += rhs.zz; zw += rhs.zw;
+            ww += rhs.ww;
+            area += rhs.area;
+            return *this;
+        }
+
+        /// <summary> The area weighted mean squared distance from the given point to every plane. </summary>
+        double error (const glm::dvec3& p) const noexcept
+        {
+            const auto sum = xx * p.x * p.x + yy * p.y * p.y + zz * p.z * p.z + ww +
+                2.0 * (xy * p.x * p.y + xz * p.x * p.z + yz * p.y * p.z + xw * p.x + yw * p.y + zw * p.z);
+
+            return area > 0.0 ? std::max (sum, 0.0) / area : 0.0;
+        }
+    };
+
+
+    /// <summary> A candidate collapse of one vertex onto another, stale once either vertex has changed. </summary>
+    struct Collapse final
+    {
+        float           error       { 0.f };    //!< The object-space error the collapse would introduce.
+        GLuint          from        { 0 };      //!< The vertex to remove.
+        GLuint          to          { 0 };      //!< The vertex which replaces it.
+        std::uint32_t   fromVersion { 0 };      //!< The version of the removed vertex when the error was evaluated.
+        std::uint32_t   toVersion   { 0 };      //!< The version of the kept vertex when the error was evaluated.
+    };
+
+
+    /// <summary> Orders the collapse queue so the cheapest collapse is on top. </summary>
+    struct CheaperFirst final
+    {
+        bool operator() (const Collapse& lhs, const Collapse& rhs) const noexcept { return lhs.error > rhs.error; }
+    };
+
+
+    /// <summary> Identifies an undirected edge between two vertices. </summary>
+    inline std::uint64_t edgeKey (const GLuint a, const GLuint b) noexcept
+    {
+        return (static_cast<std::uint64_t> (std::min (a, b)) << 32) | static_cast<std::uint64_t> (std::max (a, b));
+    }
+}
+
+
+std::vector<util::SimplifiedLevel> util::simplifyMesh (const GLuint* elements, const size_t elementCount,
+    const Vertex* vertices, const size_t vertexCount, const std::vector<size_t>& targetTriangles,
+    const float maxError)
+{
+    auto levels = std::vector<SimplifiedLevel> { };
+    if (elementCount == 0 || elementCount % 3 != 0 || targetTriangles.empty() ||
+        !std::all_of (elements, elements + elementCount, [=] (const GLuint element) { return element < vertexCount; }))
+    {
+        return levels;
+    }
+
+    const auto triangleCount = elementCount / 3;
+    const auto position = [=] (const GLuint vertex) { return glm::dvec3 { vertices[vertex].position }; };
+
+    auto triangles  = std::vector<GLuint> (elements, elements + elementCount);
+    auto alive      = std::vector<bool> (triangleCount, true);
+    auto adjacency  = std::vector<std::vector<size_t>> (vertexCount);
+    auto quadrics   = std::vector<Quadric> (vertexCount);
+    auto locked     = std::vector<bool> (vertexCount, false);
+    auto removed    = std::vector<bool> (vertexCount, false);
+    auto versions   = std::vector<std::uint32_t> (vertexCount, 0);
+    auto edges      = std::unordered_map<std::uint64_t, size_t> { };
+    auto liveCount  = triangleCount;
+
+    // Each vertex starts with the planes of the triangles around it.
+    for (size_t t { 0 }; t < triangleCount; ++t)
+    {
+        const auto corners  = triangles.data() + t * 3;
+        const auto a        = position (corners[0]);
+        const auto normal   = glm::cross (position (corners[1]) - a, position (corners[2]) - a);
+        const auto length   = glm::length (normal);
+        const auto plane    = length > 0.0 ? Quadric { normal / length, -glm::dot (normal / length, a), length / 2.0 }
+            : Quadric { };
+
+        for (size_t corner { 0 }; corner < 3; ++corner)
+        {
+            adjacency[corners[corner]].push_back (t);
+            quadrics[corners[corner]] += plane;
+            ++edges[edgeKey (corners[corner], corners[(corner + 1) % 3])];
+        }
+    }
+
+    // Edges which aren't shared by exactly two triangles are on a boundary, seam or non-manifold.
+    for (const auto& edge : edges)
+    {
+        if (edge.second != 2)
+        {
+            locked[static_cast<size_t> (edge.first >> 32)]          = true;
+            locked[static_cast<size_t> (edge.first & 0xFFFFFFFF)]   = true;
+        }
+    }
+
+    auto queue = std::priority_queue<Collapse, std::vector<Collapse>, CheaperFirst> { };
+
+    const auto evaluate = [&] (const GLuint from, const GLuint to)
+    {
+        if (!locked[from])
+        {
+            auto quadric = quadrics[from];
+            quadric += quadrics[to];
+
+            const auto error = static_cast<float> (std::sqrt (quadric.error (position (to))));
+            queue.push ({ error, from, to, versions[from], versions[to] });
+        }
+    };
+
+    const auto evaluateEdges = [&] (const GLuint vertex)
+    {
+        for (const auto t : adjacency[vertex])
+        {
+            for (size_t corner { 0 }; corner < 3; ++corner)
+            {
+                const auto other = triangles[t * 3 + corner];
+                if (other != vertex)
+                {
+                    evaluate (vertex, other);
+                    evaluate (other, vertex);
+                }
+            }
+        }
+    };
+
+    for (size_t t { 0 }; t < triangleCount; ++t)
+    {
+        for (size_t corner { 0 }; corner < 3; ++corner)
+        {
+            evaluate (triangles[t * 3 + corner], triangles[t * 3 + (corner + 1) % 3]);
+            evaluate (triangles[t * 3 + (corner + 1) % 3], triangles[t * 3 + corner]);
+        }
+    }
+
+    // Vertices connected to both ends of an edge must only be the opposite corners of the triangles sharing it,
+    // otherwise the collapse would fold the surface onto itself.
+    auto fromNeighbours = std::vector<GLuint> { };
+    auto toNeighbours   = std::vector<GLuint> { };
+    auto common         = std::vector<GLuint> { };
+
+    const auto neighbours = [&] (const GLuint vertex, std::vector<GLuint>& output)
+    {
+        output.clear();
+        for (const auto t : adjacency[vertex])
+        {
+            for (size_t corner { 0 }; corner < 3; ++corner)
+            {
+                const auto other = triangles[t * 3 + corner];
+                if (other != vertex)
+                {
+                    output.push_back (other);
+                }
+            }
+        }
+
+        std::sort (std::begin (output), std::end (output));
+        output.erase (std::unique (std::begin (output), std::end (output)), std::end (output));
+    };
+
+    const auto isValid = [&] (const GLuint from, const GLuint to)
+    {
+        const auto target   = position (to);
+        auto shared         = size_t { 0 };
+
+        for (const auto t : adjacency[from])
+        {
+            const auto corners = triangles.data() + t * 3;
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                ++shared;
+                continue;
+            }
+
+            // Moving the removed corner must not flip or flatten any triangle which remains.
+            auto moved = std::array<glm::dvec3, 3> { position (corners[0]), position (corners[1]), position (corners[2]) };
+            const auto before = glm::cross (moved[1] - moved[0], moved[2] - moved[0]);
+
+            for (size_t corner { 0 }; corner < 3; ++corner)
+            {
+                moved[corner] = corners[corner] == from ? target : moved[corner];
+            }
+
+            const auto after = glm::cross (moved[1] - moved[0], moved[2] - moved[0]);
+            if (glm::dot (before, after) <= 0.0)
+            {
+                return false;
+            }
+        }
+
+        neighbours (from, fromNeighbours);
+        neighbours (to, toNeighbours);
+
+        common.clear();
+        std::set_intersection (std::begin (fromNeighbours), std::end (fromNeighbours),
+            std::begin (toNeighbours), std::end (toNeighbours), std::back_inserter (common));
+
+        return common.size() == shared;
+    };
+
+    const auto collapse = [&] (const GLuint from, const GLuint to)
+    {
+        const auto around = std::move (adjacency[from]);
+        adjacency[from]   = { };
+
+        for (const auto t : around)
+        {
+            const auto corners = triangles.data() + t * 3;
+            if (corners[0] == to || corners[1] == to || corners[2] == to)
+            {
+                alive[t] = false;
+                --liveCount;
+                continue;
+            }
+
+            std::replace (corners, corners + 3, from, to);
+            adjacency[to].push_back (t);
+        }
+
+        // Removed triangles must leave the lists of their remaining corners.
+        for (const auto t : around)
+        {
+            for (size_t corner { 0 }; !alive[t] && corner < 3; ++corner)
+            {
+                auto& list = adjacency[triangles[t * 3 + corner]];
+                list.erase (std::remove (std::begin (list), std::end (list), t), std::end (list));
+            }
+        }
+
+        quadrics[to] += quadrics[from];
+        removed[from] = true;
+        ++versions[to];
+
+        evaluateEdges (to);
+    };
+
+    const auto addLevel = [&] (const float error)
+    {
+        auto level = SimplifiedLevel { };
+        level.error = error;
+        level.elements.reserve (liveCount * 3);
+
+        for (size_t t { 0 }; t < triangleCount; ++t)
+        {
+            if (alive[t])
+            {
+                level.elements.insert (std::end (level.elements),
+                    std::begin (triangles) + t * 3, std::begin (triangles) + t * 3 + 3);
+            }
+        }
+
+        levels.push_back (std::move (level));
+    };
+
+    // Collapse the cheapest edge until each target is reached, stale candidates are skipped as they're found.
+    auto target = std::begin (targetTriangles);
+    auto error  = 0.f;
+
+    while (target != std::end (targetTriangles))
+    {
+        if (liveCount <= *target)
+        {
+            addLevel (error);
+            ++target;
+            continue;
+        }
+
+        if (queue.empty())
+        {
+            break;
+        }
+
+        const auto next = queue.top();
+        queue.pop();
+
+        if (removed[next.from] || removed[next.to] ||
+            versions[next.from] != next.fromVersion || versions[next.to] != next.toVersion)
+        {
+            continue;
+        }
+
+        if (next.error > maxError)
+        {
+            break;
+        }
+
+        if (isValid (next.from, next.to))
+        {
+            error = std::max (error, next.error);
+            collapse (next.from, next.to);
+        }
+    }
+
+    // A level which couldn't reach its target is still worth keeping if it removed enough triangles.
+    const auto previous = levels.empty() ? triangleCount : levels.back().elements.size() / 3;
+    if (target != std::end (targetTriangles) && liveCount * 4 <= previous * 3)
+    {
+        addLevel (error);
+    }
+
+    return levels;
+}
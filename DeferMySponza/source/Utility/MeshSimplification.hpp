@@ -0,0 +1,51 @@
+#pragma once
+
+#if !defined    _UTIL_MESH_SIMPLIFICATION_
+#define         _UTIL_MESH_SIMPLIFICATION_
+
+// STL headers.
+#include <cstddef>
+#include <vector>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+// Forward declarations.
+struct Vertex;
+
+
+namespace util
+{
+    /// <summary> A simplified version of a triangle list which indexes the same vertices as the original. </summary>
+    struct SimplifiedLevel final
+    {
+        std::vector<GLuint> elements    { };        //!< The remaining triangles.
+        float               error       { 0.f };    //!< An estimate of how far the surface moved, in object space.
+    };
+
+
+    /// <summary>
+    /// Generates a chain of simplified levels of detail using quadric error metrics. Edges are collapsed onto one of
+    /// their existing vertices, cheapest first, so every level can share the vertices of the original mesh and only
+    /// needs its own elements. Vertices on open edges are never removed, this includes texture and normal seams
+    /// because their vertices aren't shared, so open boundaries and seams stay intact. Collapses which would flip a
+    /// triangle are rejected. Each level continues simplifying the previous one so the error only grows.
+    /// </summary>
+    /// <param name="elements"> The triangle list to simplify, every element must be less than vertexCount. </param>
+    /// <param name="elementCount"> How many elements there are, a multiple of three. </param>
+    /// <param name="vertices"> The vertices the elements index, only positions are used. </param>
+    /// <param name="vertexCount"> How many vertices there are. </param>
+    /// <param name="targetTriangles"> The triangle count to reach for each level, from largest to smallest. </param>
+    /// <param name="maxError"> Simplification stops before any collapse with a larger object-space error. </param>
+    /// <returns>
+    /// A level for each target that was reached, a final level is added if a target couldn't be reached but at
+    /// least a quarter of the triangles of the previous level were removed.
+    /// </returns>
+    std::vector<SimplifiedLevel> simplifyMesh (const GLuint* elements, const size_t elementCount,
+        const Vertex* vertices, const size_t vertexCount, const std::vector<size_t>& targetTriangles,
+        const float maxError);
+}
+
+#endif // _UTIL_MESH_SIMPLIFICATION_
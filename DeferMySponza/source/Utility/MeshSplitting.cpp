@@ -0,0 +1,76 @@
+#include "MeshSplitting.hpp"
+
+
+// STL headers.
+#include <algorithm>
+
+
+util::SplitElements util::splitForShortElements (const GLuint* elements, const size_t elementCount)
+{
+    auto split      = SplitElements { };
+    auto triangles  = std::vector<size_t> { };
+    auto low        = GLuint { 0 };
+    auto high       = GLuint { 0 };
+
+    split.shortElements.reserve (elementCount);
+
+    // The lowest vertex of a range is only known once it's complete so elements are rebased when it's closed.
+    const auto closeRange = [&]
+    {
+        if (triangles.empty())
+        {
+            return;
+        }
+
+        split.ranges.push_back ({ split.shortElements.size(), triangles.size() * 3, low, true });
+        for (const auto triangle : triangles)
+        {
+            for (size_t corner { 0 }; corner < 3; ++corner)
+            {
+                split.shortElements.push_back (static_cast<GLushort> (elements[triangle + corner] - low));
+            }
+        }
+
+        triangles.clear();
+    };
+
+    for (size_t triangle { 0 }; triangle + 2 < elementCount; triangle += 3)
+    {
+        const auto first    = elements + triangle;
+        const auto minimum  = std::min ({ first[0], first[1], first[2] });
+        const auto maximum  = std::max ({ first[0], first[1], first[2] });
+
+        if (maximum - minimum > maxShortElement)
+        {
+            split.wideElements.insert (std::end (split.wideElements), first, first + 3);
+            continue;
+        }
+
+        const auto newLow   = triangles.empty() ? minimum : std::min (low, minimum);
+        const auto newHigh  = triangles.empty() ? maximum : std::max (high, maximum);
+
+        if (newHigh - newLow > maxShortElement)
+        {
+            closeRange();
+            low     = minimum;
+            high    = maximum;
+        }
+
+        else
+        {
+            low     = newLow;
+            high    = newHigh;
+        }
+
+        triangles.push_back (triangle);
+    }
+
+    closeRange();
+
+    if (!split.wideElements.empty())
+    {
+        split.ranges.push_back ({ 0, split.wideElements.size(), 0, false });
+    }
+
+    return split;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#if !defined    _UTIL_MESH_SPLITTING_
+#define         _UTIL_MESH_SPLITTING_
+
+// STL headers.
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+
+// Engine headers.
+#include <tgl/tgl.h>
+
+
+namespace util
+{
+    constexpr auto maxShortElement = GLuint { std::numeric_limits<GLushort>::max() }; //!< The largest 16-bit element.
+
+    /// <summary> A contiguous run of triangles from a split triangle list which can be drawn with one command. </summary>
+    struct ElementRange final
+    {
+        size_t  first       { 0 };      //!< The first element of the range in either the short or wide elements.
+        size_t  count       { 0 };      //!< How many elements the range contains.
+        GLuint  baseVertex  { 0 };      //!< Added to every element in the range to get the original vertex index.
+        bool    isShort     { true };   //!< Whether the range is stored in the short elements or the wide elements.
+    };
+
+    /// <summary> A triangle list split into ranges of 16-bit elements and, only if unavoidable, 32-bit elements. </summary>
+    struct SplitElements final
+    {
+        std::vector<GLushort>       shortElements   { };    //!< Elements relative to the base vertex of their range.
+        std::vector<GLuint>         wideElements    { };    //!< Triangles whose own vertices are too far apart.
+        std::vector<ElementRange>   ranges          { };    //!< Every short range followed by at most one wide range.
+    };
+
+
+    /// <summary>
+    /// Splits a triangle list into ranges which can each be drawn with 16-bit elements and a base vertex. Triangles 
+    /// are added to the current range, in order, until the vertices of the range would span more than a 16-bit 
+    /// element can reach. Meshes with vertices in first use order therefore split into few ranges, most only need
+    /// one. Triangles which can't be reached from any base vertex are kept as 32-bit elements in a final range.
+    /// </summary>
+    /// <param name="elements"> The triangle list to split. </param>
+    /// <param name="elementCount"> How many elements there are, a multiple of three. </param>
+    SplitElements splitForShortElements (const GLuint* elements, const size_t elementCount);
+}
+
+#endif // _UTIL_MESH_SPLITTING_
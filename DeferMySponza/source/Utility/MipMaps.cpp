@@ -0,0 +1,383 @@
+#include "MipMaps.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+
+// Engine headers.
+#include <emmintrin.h>
+
+#if defined __AVX2__
+    #include <immintrin.h>
+#endif
+
+
+// Namespaces.
+using util::MipFilter;
+
+
+namespace
+{
+    constexpr auto encodeSteps = size_t { 16384 }; //!< The resolution of the table used to convert to sRGB.
+
+
+    /// <summary> Converts an sRGB encoded value into linear space. </summary>
+    inline float toLinear (const float srgb) noexcept
+    {
+        return srgb <= 0.04045f ? srgb / 12.92f : std::pow ((srgb + 0.055f) / 1.055f, 2.4f);
+    }
+
+
+    /// <summary> Converts a linear value into sRGB space. </summary>
+    inline float toSRGB (const float linear) noexcept
+    {
+        return linear <= 0.0031308f ? linear * 12.92f : 1.055f * std::pow (linear, 1.0f / 2.4f) - 0.055f;
+    }
+
+
+    /// <summary> Gets a table which maps every sRGB value of the given type into linear space. </summary>
+    template <typename Component>
+    const std::vector<float>& decodeTable()
+    {
+        // Function-local statics are initialised once in a thread-safe manner.
+        static const auto table = []
+        {
+            constexpr auto count = size_t { 1 } << (sizeof (Component) * 8);
+
+            auto values = std::vector<float> (count);
+            for (size_t i { 0 }; i < count; ++i)
+            {
+                values[i] = toLinear (static_cast<float> (i) / static_cast<float> (count - 1));
+            }
+
+            return values;
+        }();
+
+        return table;
+    }
+
+
+    /// <summary> Gets a table of sRGB values for evenly spaced linear values, plus one to interpolate to. </summary>
+    const std::vector<float>& encodeTable()
+    {
+        static const auto table = []
+        {
+            auto values = std::vector<float> (encodeSteps + 2);
+            for (size_t i { 0 }; i <= encodeSteps; ++i)
+            {
+                values[i] = toSRGB (static_cast<float> (i) / static_cast<float> (encodeSteps));
+            }
+
+            values.back() = values[encodeSteps];
+            return values;
+        }();
+
+        return table;
+    }
+
+
+    /// <summary> Loads a texel into four 32-bit integers, missing components are set to zero. </summary>
+    template <typename Component, size_t Components>
+    inline __m128i loadTexel (const Component* texel) noexcept
+    {
+        // Complete texels can be loaded with a single read and widened.
+        if (Components == 4)
+        {
+            const auto zero = _mm_setzero_si128();
+
+            if (sizeof (Component) == 1)
+            {
+                auto bytes = std::int32_t { 0 };
+                std::memcpy (&bytes, texel, 4);
+                return _mm_unpacklo_epi16 (_mm_unpacklo_epi8 (_mm_cvtsi32_si128 (bytes), zero), zero);
+            }
+
+            return _mm_unpacklo_epi16 (_mm_loadl_epi64 (reinterpret_cast<const __m128i*> (texel)), zero);
+        }
+
+        // Partial reads would stall when combined so build the vector from each component instead.
+        return _mm_set_epi32 (0,
+                              Components > 2 ? texel[Components > 2 ? 2 : 0] : 0,
+                              Components > 1 ? texel[Components > 1 ? 1 : 0] : 0,
+                              texel[0]);
+    }
+
+
+    /// <summary> Sums the components of the 2x2 block of texels which contribute to an output texel. </summary>
+    template <typename Component, size_t Components>
+    inline __m128i sumBlock (const Component* top, const Component* bottom, const size_t x0, const size_t x1) noexcept
+    {
+        #if defined __AVX2__
+            // RGBA texels fill eight lanes when widened so each row of the block can be loaded at once.
+            if (Components == 4 && x1 == x0 + 1)
+            {
+                const auto load = [=] (const Component* row)
+                {
+                    const auto texels = reinterpret_cast<const __m128i*> (row + x0 * 4);
+                    return sizeof (Component) == 1 ? _mm256_cvtepu8_epi32 (_mm_loadl_epi64 (texels)) :
+                                                     _mm256_cvtepu16_epi32 (_mm_loadu_si128 (texels));
+                };
+
+                const auto sum = _mm256_add_epi32 (load (top), load (bottom));
+                return _mm_add_epi32 (_mm256_castsi256_si128 (sum), _mm256_extracti128_si256 (sum, 1));
+            }
+        #endif
+
+        const auto left     = _mm_add_epi32 (loadTexel<Component, Components> (top + x0 * Components),
+                                             loadTexel<Component, Components> (bottom + x0 * Components));
+        const auto right    = _mm_add_epi32 (loadTexel<Component, Components> (top + x1 * Components),
+                                             loadTexel<Component, Components> (bottom + x1 * Components));
+        return _mm_add_epi32 (left, right);
+    }
+
+
+    /// <summary> Converts an sRGB texel into linear space, alpha is already linear. </summary>
+    template <typename Component, size_t Components>
+    inline __m128 loadLinearTexel (const Component* texel, const float* table, const float scale) noexcept
+    {
+        return _mm_set_ps (Components > 3 ? texel[Components > 3 ? 3 : 0] * scale : 0.f,
+                           Components > 2 ? table[texel[Components > 2 ? 2 : 0]] : 0.f,
+                           Components > 1 ? table[texel[Components > 1 ? 1 : 0]] : 0.f,
+                           table[texel[0]]);
+    }
+
+
+    /// <summary> Converts each colour component of a linear texel into sRGB space, alpha is left untouched. </summary>
+    inline __m128 encodeSRGB (const __m128 texel, const float* table) noexcept
+    {
+        // Linearly interpolating the table is accurate enough for 16-bit components and far cheaper than std::pow().
+        const auto clamped      = _mm_min_ps (_mm_max_ps (texel, _mm_setzero_ps()), _mm_set1_ps (1.f));
+        const auto position     = _mm_mul_ps (clamped, _mm_set1_ps (static_cast<float> (encodeSteps)));
+        const auto index        = _mm_cvttps_epi32 (position);
+        const auto weight       = _mm_sub_ps (position, _mm_cvtepi32_ps (index));
+
+        auto indices = std::array<std::int32_t, 4> { };
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (indices.data()), index);
+
+        const auto lower = _mm_set_ps (0.f, table[indices[2]], table[indices[1]], table[indices[0]]);
+        const auto upper = _mm_set_ps (0.f, table[indices[2] + 1], table[indices[1] + 1], table[indices[0] + 1]);
+        const auto srgb  = _mm_add_ps (lower, _mm_mul_ps (_mm_sub_ps (upper, lower), weight));
+
+        // Restore the alpha component.
+        const auto mask = _mm_castsi128_ps (_mm_set_epi32 (0, -1, -1, -1));
+        return _mm_or_ps (_mm_and_ps (mask, srgb), _mm_andnot_ps (mask, texel));
+    }
+
+
+    /// <summary>
+    /// Renormalises the XYZ components of a vector, degenerate vectors where the normals cancel out will point along
+    /// Z. The W component is left untouched.
+    /// </summary>
+    inline __m128 renormalise (const __m128 texel) noexcept
+    {
+        const auto mask     = _mm_castsi128_ps (_mm_set_epi32 (0, -1, -1, -1));
+        const auto vector   = _mm_and_ps (texel, mask);
+
+        // Sum the squares across every lane.
+        auto squared        = _mm_mul_ps (vector, vector);
+        squared             = _mm_add_ps (squared, _mm_shuffle_ps (squared, squared, _MM_SHUFFLE (2, 3, 0, 1)));
+        squared             = _mm_add_ps (squared, _mm_shuffle_ps (squared, squared, _MM_SHUFFLE (1, 0, 3, 2)));
+
+        const auto length   = _mm_sqrt_ps (squared);
+        const auto valid    = _mm_cmpgt_ps (length, _mm_set1_ps (1e-6f));
+        const auto up       = _mm_set_ps (0.f, 1.f, 0.f, 0.f);
+        const auto unit     = _mm_or_ps (_mm_and_ps (valid, _mm_div_ps (vector, length)), _mm_andnot_ps (valid, up));
+
+        return _mm_or_ps (_mm_and_ps (mask, unit), _mm_andnot_ps (mask, texel));
+    }
+
+
+    /// <summary> Writes the given integers to a texel, each must fit in the component type. </summary>
+    template <typename Component, size_t Components>
+    inline void storeTexel (const __m128i values, Component* texel) noexcept
+    {
+        if (sizeof (Component) == 1)
+        {
+            const auto packed   = _mm_packus_epi16 (_mm_packs_epi32 (values, values), values);
+            const auto bytes    = static_cast<std::uint32_t> (_mm_cvtsi128_si32 (packed));
+            std::memcpy (texel, &bytes, Components);
+        }
+
+        else
+        {
+            // There is no unsigned 32-bit to 16-bit pack in SSE2 so offset into the signed range and back again.
+            const auto offset   = _mm_set1_epi32 (32768);
+            const auto packed   = _mm_packs_epi32 (_mm_sub_epi32 (values, offset), values);
+            const auto shifted  = _mm_xor_si128 (packed, _mm_set1_epi16 (-32768));
+
+            auto shorts = std::uint64_t { 0 };
+            _mm_storel_epi64 (reinterpret_cast<__m128i*> (&shorts), shifted);
+            std::memcpy (texel, &shorts, Components * 2);
+        }
+    }
+
+
+    /// <summary>
+    /// Generates a mipmap level by averaging the stored components of each 2x2 block. The integer arithmetic is exact
+    /// and per-texel SSE is slower here than plain loops over the components, which the compiler can unroll.
+    /// </summary>
+    template <typename Component, size_t Components>
+    void generateLinear (const Component* source, const size_t width, const size_t height, Component* destination)
+    {
+        const auto levelWidth   = std::max (width / 2, size_t { 1 });
+        const auto levelHeight  = std::max (height / 2, size_t { 1 });
+        const auto rowSize      = width * Components;
+
+        for (size_t y { 0 }; y < levelHeight; ++y)
+        {
+            const auto top      = source + std::min (y * 2, height - 1) * rowSize;
+            const auto bottom   = source + std::min (y * 2 + 1, height - 1) * rowSize;
+            const auto output   = destination + y * levelWidth * Components;
+
+            for (size_t x { 0 }; x < levelWidth; ++x)
+            {
+                const auto left     = std::min (x * 2, width - 1) * Components;
+                const auto right    = std::min (x * 2 + 1, width - 1) * Components;
+                const auto texel    = output + x * Components;
+
+                for (size_t c { 0 }; c < Components; ++c)
+                {
+                    const auto sum = std::uint32_t { top[left + c] } + top[right + c] + bottom[left + c] +
+                        bottom[right + c];
+                    texel[c] = static_cast<Component> ((sum + 2) >> 2);
+                }
+            }
+        }
+    }
+
+
+    /// <summary> Generates a mipmap level with the given format and a floating-point filter. </summary>
+    template <typename Component, size_t Components, MipFilter Filter>
+    void generate (const Component* source, const size_t width, const size_t height, Component* destination)
+    {
+        constexpr auto maximum  = static_cast<float> ((size_t { 1 } << (sizeof (Component) * 8)) - 1);
+        const auto levelWidth   = std::max (width / 2, size_t { 1 });
+        const auto levelHeight  = std::max (height / 2, size_t { 1 });
+        const auto rowSize      = width * Components;
+
+        const auto table        = Filter == MipFilter::SRGB ? decodeTable<Component>().data() : nullptr;
+        const auto srgbTable    = Filter == MipFilter::SRGB ? encodeTable().data() : nullptr;
+        const auto scale        = 1.f / maximum;
+        const auto quarter      = _mm_set1_ps (0.25f);
+        const auto toStored     = _mm_set1_ps (maximum);
+        const auto zero         = _mm_setzero_ps();
+
+        // Normal components are stored in the range [0, 1] but must be averaged in the range [-1, 1]. Alpha isn't.
+        const auto toVector     = _mm_set_ps (0.25f / maximum, 0.5f / maximum, 0.5f / maximum, 0.5f / maximum);
+        const auto toCentre     = _mm_set_ps (0.f, -1.f, -1.f, -1.f);
+        const auto toUnsigned   = _mm_set_ps (1.f, 0.5f, 0.5f, 0.5f);
+        const auto toMiddle     = _mm_set_ps (0.f, 0.5f, 0.5f, 0.5f);
+
+        for (size_t y { 0 }; y < levelHeight; ++y)
+        {
+            const auto top      = source + std::min (y * 2, height - 1) * rowSize;
+            const auto bottom   = source + std::min (y * 2 + 1, height - 1) * rowSize;
+            const auto output   = destination + y * levelWidth * Components;
+
+            for (size_t x { 0 }; x < levelWidth; ++x)
+            {
+                const auto x0 = std::min (x * 2, width - 1);
+                const auto x1 = std::min (x * 2 + 1, width - 1);
+
+                auto texel = _mm_setzero_ps();
+
+                if (Filter == MipFilter::SRGB)
+                {
+                    // Each texel must be converted into linear space before they can be averaged.
+                    const auto load = [=] (const Component* row, const size_t column)
+                    {
+                        return loadLinearTexel<Component, Components> (row + column * Components, table, scale);
+                    };
+
+                    texel = _mm_add_ps (_mm_add_ps (load (top, x0), load (top, x1)),
+                                        _mm_add_ps (load (bottom, x0), load (bottom, x1)));
+                    texel = _mm_mul_ps (encodeSRGB (_mm_mul_ps (texel, quarter), srgbTable), toStored);
+                }
+
+                else
+                {
+                    // Unpacking is linear so the sum can be unpacked rather than each texel.
+                    const auto sum  = _mm_cvtepi32_ps (sumBlock<Component, Components> (top, bottom, x0, x1));
+                    const auto unit = renormalise (_mm_add_ps (_mm_mul_ps (sum, toVector), toCentre));
+                    texel           = _mm_mul_ps (_mm_add_ps (_mm_mul_ps (unit, toUnsigned), toMiddle), toStored);
+                }
+
+                const auto result = _mm_cvtps_epi32 (_mm_min_ps (_mm_max_ps (texel, zero), toStored));
+                storeTexel<Component, Components> (result, output + x * Components);
+            }
+        }
+    }
+
+
+    /// <summary> Selects the filter to generate a mipmap level with. </summary>
+    template <typename Component, size_t Components>
+    void generate (const void* source, const size_t width, const size_t height, const MipFilter filter,
+        void* destination)
+    {
+        const auto from = static_cast<const Component*> (source);
+        const auto to   = static_cast<Component*> (destination);
+
+        switch (filter)
+        {
+            case MipFilter::SRGB:
+                return generate<Component, Components, MipFilter::SRGB> (from, width, height, to);
+
+            case MipFilter::NormalMap:
+                return generate<Component, Components, MipFilter::NormalMap> (from, width, height, to);
+
+            default:
+                return generateLinear<Component, Components> (from, width, height, to);
+        }
+    }
+
+
+    /// <summary> Selects the number of components to generate a mipmap level with. </summary>
+    template <typename Component>
+    void generate (const void* source, const size_t width, const size_t height, const size_t components,
+        const MipFilter filter, void* destination)
+    {
+        switch (components)
+        {
+            case 1:
+                return generate<Component, 1> (source, width, height, filter, destination);
+
+            case 2:
+                return generate<Component, 2> (source, width, height, filter, destination);
+
+            case 3:
+                return generate<Component, 3> (source, width, height, filter, destination);
+
+            case 4:
+                return generate<Component, 4> (source, width, height, filter, destination);
+        }
+    }
+}
+
+
+namespace util
+{
+    void generateMipLevel (const void* source, const size_t width, const size_t height, const size_t components,
+        const size_t bytesPerComponent, const MipFilter filter, void* destination)
+    {
+        if (width == 0 || height == 0)
+        {
+            return;
+        }
+
+        if (bytesPerComponent == 1)
+        {
+            generate<std::uint8_t> (source, width, height, components, filter, destination);
+        }
+
+        else if (bytesPerComponent == 2)
+        {
+            generate<std::uint16_t> (source, width, height, components, filter, destination);
+        }
+    }
+}
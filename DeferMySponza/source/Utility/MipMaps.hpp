@@ -0,0 +1,38 @@
+#pragma once
+
+#if !defined    _UTIL_MIP_MAPS_
+#define         _UTIL_MIP_MAPS_
+
+// STL headers.
+#include <cstddef>
+
+
+namespace util
+{
+    /// <summary> Determines how texels are combined when generating a mipmap level. </summary>
+    enum class MipFilter
+    {
+        Linear,     //!< Components are averaged as they are stored, used for data such as material properties.
+        SRGB,       //!< Colour components are converted to linear space before averaging, alpha is averaged linearly.
+        NormalMap   //!< Texels are unpacked into vectors, averaged and renormalised. Alpha is averaged linearly.
+    };
+
+
+    /// <summary>
+    /// Generates the next mipmap level of a tightly packed image by filtering each 2x2 block of texels. The level will
+    /// be half the width and height of the source, each dimension is clamped to one so full chains down to 1x1 can be
+    /// generated from non-square images. Linear levels are averaged with integer arithmetic, the other filters use
+    /// SSE2 and RGBA images also use AVX2 if it's targeted.
+    /// </summary>
+    /// <param name="source"> The texels of the source level. </param>
+    /// <param name="width"> How many texels wide the source level is. </param>
+    /// <param name="height"> How many texels tall the source level is. </param>
+    /// <param name="components"> How many components each texel has, 1 to 4. </param>
+    /// <param name="bytesPerComponent"> The size of each component, 1 or 2. </param>
+    /// <param name="filter"> How the texels should be combined. </param>
+    /// <param name="destination"> Where the generated level should be written, this is also tightly packed. </param>
+    void generateMipLevel (const void* source, const size_t width, const size_t height, const size_t components,
+        const size_t bytesPerComponent, const MipFilter filter, void* destination);
+}
+
+#endif // _UTIL_MIP_MAPS_
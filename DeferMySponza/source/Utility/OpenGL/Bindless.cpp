@@ -0,0 +1,86 @@
+#include "Bindless.hpp"
+
+
+// Engine headers.
+#if defined _WIN32
+    #undef APIENTRY
+    #undef CALLBACK
+    #undef WINGDIAPI
+    #if !defined WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #if !defined NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+#endif
+
+
+// Personal headers.
+#include <Utility/OpenGL/Textures.hpp>
+
+
+namespace
+{
+    // tgl only loads core functions so the extension is loaded here.
+    PFNGLGETTEXTUREHANDLEARBPROC                getTextureHandle                { nullptr };
+    PFNGLMAKETEXTUREHANDLERESIDENTARBPROC       makeTextureHandleResident       { nullptr };
+    PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC    makeTextureHandleNonResident    { nullptr };
+
+
+    /// <summary> Loads every function required for bindless textures. </summary>
+    bool loadFunctions() noexcept
+    {
+        if (!util::isExtensionSupported ("GL_ARB_bindless_texture"))
+        {
+            return false;
+        }
+
+        #if defined _WIN32
+            getTextureHandle                = reinterpret_cast<PFNGLGETTEXTUREHANDLEARBPROC> (
+                                                wglGetProcAddress ("glGetTextureHandleARB"));
+            makeTextureHandleResident       = reinterpret_cast<PFNGLMAKETEXTUREHANDLERESIDENTARBPROC> (
+                                                wglGetProcAddress ("glMakeTextureHandleResidentARB"));
+            makeTextureHandleNonResident    = reinterpret_cast<PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC> (
+                                                wglGetProcAddress ("glMakeTextureHandleNonResidentARB"));
+        #endif
+
+        return getTextureHandle && makeTextureHandleResident && makeTextureHandleNonResident;
+    }
+}
+
+
+namespace util
+{
+    bool loadBindlessTextures() noexcept
+    {
+        static const auto supported = loadFunctions();
+        return supported;
+    }
+
+
+    GLuint64 makeTextureResident (const GLuint texture) noexcept
+    {
+        if (!loadBindlessTextures())
+        {
+            return 0;
+        }
+
+        const auto handle = getTextureHandle (texture);
+        if (handle != 0)
+        {
+            makeTextureHandleResident (handle);
+        }
+
+        return handle;
+    }
+
+
+    void makeTextureNonResident (const GLuint64 handle) noexcept
+    {
+        if (handle != 0 && loadBindlessTextures())
+        {
+            makeTextureHandleNonResident (handle);
+        }
+    }
+}
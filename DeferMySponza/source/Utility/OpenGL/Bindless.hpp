@@ -0,0 +1,29 @@
+#pragma once
+
+#if !defined    _UTILITY_OPENGL_BINDLESS_
+#define         _UTILITY_OPENGL_BINDLESS_
+
+// Personal headers.
+#include <tgl/tgl.h>
+
+
+namespace util
+{
+    /// <summary>
+    /// Checks whether the current context supports ARB_bindless_texture, loading its entry points the first time.
+    /// The result is remembered so an OpenGL context must be current on the first call.
+    /// </summary>
+    bool loadBindlessTextures() noexcept;
+
+    /// <summary>
+    /// Retrieves the bindless handle of a texture and makes it resident. The texture must be complete and its
+    /// parameters can no longer be changed afterwards.
+    /// </summary>
+    /// <returns> The handle, zero if bindless textures aren't supported. </returns>
+    GLuint64 makeTextureResident (const GLuint texture) noexcept;
+
+    /// <summary> Makes a handle from makeTextureResident() non-resident, zero is ignored. </summary>
+    void makeTextureNonResident (const GLuint64 handle) noexcept;
+}
+
+#endif // _UTILITY_OPENGL_BINDLESS_
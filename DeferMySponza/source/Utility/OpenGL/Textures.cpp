@@ -1,6 +1,10 @@
 #include "Textures.hpp"
 
 
+// STL headers.
+#include <cstring>
+
+
 namespace util
 {
     GLenum internalFormat (const size_t components) noexcept
@@ -22,4 +26,72 @@ namespace util
 
         return 0;
     }
-}
\ No newline at end of file
+
+
+    size_t pixelSize (const GLenum pixelFormat, const GLenum pixelType) noexcept
+    {
+        auto components = size_t { 0 };
+        switch (pixelFormat)
+        {
+            case GL_RED:
+            case GL_GREEN:
+            case GL_BLUE:
+            case GL_STENCIL_INDEX:
+            case GL_DEPTH_COMPONENT:
+                components = 1;
+                break;
+
+            case GL_RG:
+            case GL_DEPTH_STENCIL:
+                components = 2;
+                break;
+
+            case GL_RGB:
+            case GL_BGR:
+                components = 3;
+                break;
+
+            case GL_RGBA:
+            case GL_BGRA:
+                components = 4;
+                break;
+        }
+
+        switch (pixelType)
+        {
+            case GL_UNSIGNED_BYTE:
+            case GL_BYTE:
+                return components;
+
+            case GL_UNSIGNED_SHORT:
+            case GL_SHORT:
+            case GL_HALF_FLOAT:
+                return components * 2;
+
+            case GL_UNSIGNED_INT:
+            case GL_INT:
+            case GL_FLOAT:
+                return components * 4;
+        }
+
+        return 0;
+    }
+
+
+    bool isExtensionSupported (const char* const extension) noexcept
+    {
+        auto count = GLint { 0 };
+        glGetIntegerv (GL_NUM_EXTENSIONS, &count);
+
+        for (GLint i { 0 }; i < count; ++i)
+        {
+            const auto name = reinterpret_cast<const char*> (glGetStringi (GL_EXTENSIONS, static_cast<GLuint> (i)));
+            if (name && std::strcmp (name, extension) == 0)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+}
@@ -7,10 +7,24 @@
 #include <tgl/tgl.h>
 
 
+// S3TC is an extension rather than a core format so the core headers don't define it.
+#if !defined GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+    #define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+
 namespace util
 {
     /// <summary> Gets the internal format for the given number of components. </summary>
     GLenum internalFormat (const size_t components) noexcept;
+
+    /// <summary> Calculates how many bytes a single pixel occupies with the given client format and type. </summary>
+    /// <returns> The size of the pixel, zero if the format or type isn't supported. </returns>
+    size_t pixelSize (const GLenum pixelFormat, const GLenum pixelType) noexcept;
+
+    /// <summary> Checks the extension list of the current context for the given extension. </summary>
+    /// <param name="extension"> The name of the extension, e.g. "GL_EXT_texture_compression_s3tc". </param>
+    bool isExtensionSupported (const char* const extension) noexcept;
 }
 
 #endif // _UTILITY_OPENGL_TEXTURES_
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 // STL headers.
 #include <algorithm>
+#include <cstring>
 
 
 // Engine headers.
@@ -21,57 +22,87 @@ using namespace std::string_literals;
 
 namespace util
 {
-    void calculateSceneSize (const std::vector<scene::Mesh>& meshes, 
-        size_t& vertexCount, size_t& elementCount) noexcept
+    void calculateSceneSize (const std::vector<const scene::Mesh*>& meshes, 
+        std::vector<size_t>& vertexOffsets, std::vector<size_t>& elementOffsets) noexcept
     {
-        // Create temporary accumlators.
-        size_t vertices { 0 }, elements { 0 };  
+        // Each mesh starts where the previous one finished.
+        vertexOffsets.resize (meshes.size() + 1);
+        elementOffsets.resize (meshes.size() + 1);
+        vertexOffsets[0] = elementOffsets[0] = 0;
 
-        // We need to loop through each mesh adding up as we go along.
-        for (const auto& mesh : meshes)
+        for (size_t i { 0 }; i < meshes.size(); ++i)
         {
-            vertices += mesh.getPositionArray().size();
-            elements += mesh.getElementArray().size();
+            vertexOffsets[i + 1]    = vertexOffsets[i] + meshes[i]->getPositionArray().size();
+            elementOffsets[i + 1]   = elementOffsets[i] + meshes[i]->getElementArray().size();
         }
-
-        // Calculate the final values.
-        vertexCount     = vertices;
-        elementCount    = elements;
     }
 
 
-    std::vector<Vertex> assembleVertices (const scene::Mesh& mesh) noexcept
+    void assembleVertices (const scene::Mesh& mesh, Vertex* const output) noexcept
     {
         // Obtain each attribute.
         const auto& positions       = mesh.getPositionArray();
         const auto& normals         = mesh.getNormalArray();
         const auto& texturePoints   = mesh.getTextureCoordinateArray();
 
-        // Check how much data we need to allocate.
+        // Check how much data we need to write.
         const auto posSize  = positions.size(),
                    normSize = normals.size(),
                    texSize  = texturePoints.size();
 
-        auto vertices = std::vector<Vertex> { posSize };
-
-        // Fill the actual data.
+        // Fill the actual data, missing attributes are zeroed.
         for (size_t i { 0 }; i < posSize; ++i)
         {
-            auto& vertex    = vertices[i];
-            vertex.position = toGLM (positions[i]);
+            auto& vertex        = output[i];
+            vertex.position     = toGLM (positions[i]);
+            vertex.normal       = i < normSize ? toGLM (normals[i]) : glm::vec3 { 0.f };
+            vertex.texturePoint = i < texSize ? toGLM (texturePoints[i]) : glm::vec2 { 0.f };
+        }
+    }
+
+
+    std::uint64_t hashMeshData (const scene::Mesh& mesh) noexcept
+    {
+        auto hash = std::uint64_t { 14695981039346656037ULL };
+
+        // Each array is hashed along with its length so that data can't shift between arrays unnoticed.
+        const auto hashBytes = [&] (const auto& array)
+        {
+            const auto size     = static_cast<std::uint64_t> (array.size() * sizeof (array[0]));
+            const auto bytes    = reinterpret_cast<const std::uint8_t*> (array.data());
 
-            if (i < normSize)
+            for (size_t i { 0 }; i < sizeof (size); ++i)
             {
-                vertex.normal = toGLM (normals[i]);
+                hash = (hash ^ ((size >> (i * 8)) & 0xFF)) * 1099511628211ULL;
             }
 
-            if (i < texSize)
+            for (size_t i { 0 }; i < size; ++i)
             {
-                vertex.texturePoint = toGLM (texturePoints[i]);
+                hash = (hash ^ bytes[i]) * 1099511628211ULL;
             }
-        }
+        };
+
+        hashBytes (mesh.getPositionArray());
+        hashBytes (mesh.getNormalArray());
+        hashBytes (mesh.getTextureCoordinateArray());
+        hashBytes (mesh.getElementArray());
+
+        return hash;
+    }
+
 
-        return vertices;
+    bool meshDataEquals (const scene::Mesh& lhs, const scene::Mesh& rhs) noexcept
+    {
+        const auto equals = [] (const auto& a, const auto& b)
+        {
+            return a.size() == b.size() && 
+                (a.size() == 0 || std::memcmp (a.data(), b.data(), a.size() * sizeof (a[0])) == 0);
+        };
+
+        return equals (lhs.getPositionArray(), rhs.getPositionArray()) &&
+            equals (lhs.getNormalArray(), rhs.getNormalArray()) &&
+            equals (lhs.getTextureCoordinateArray(), rhs.getTextureCoordinateArray()) &&
+            equals (lhs.getElementArray(), rhs.getElementArray());
     }
 
 
@@ -5,6 +5,7 @@
 
 // STL headers.
 #include <array>
+#include <cstdint>
 #include <vector>
 
 
@@ -14,6 +15,7 @@
 #include <glm/mat4x3.hpp>
 #include <glm/mat4x4.hpp>
 #include <scene/scene_fwd.hpp>
+#include <scene/Span.hpp>
 #include <scene/types.hpp>
 #include <tgl/tgl.h>
 
@@ -42,17 +44,32 @@ struct PBSMaterial final
 
 namespace util
 {
-    /// <summary> Fills a given vector with vertex information which is obtained from the given mesh. </summary>
+    /// <summary> Writes the vertex information of the given mesh directly to the given location. </summary>
     /// <param name="mesh"> The mesh to retrieve Vertex data from. </param>
-    /// <returns> An array to be filled with Vertex information. </returns>
-    std::vector<Vertex> assembleVertices (const scene::Mesh& mesh) noexcept;
+    /// <param name="output"> Where to write the vertices, must have space for every position in the mesh. </param>
+    void assembleVertices (const scene::Mesh& mesh, Vertex* const output) noexcept;
     
-    /// <summary> Iterates through each given scene::Mesh and calculates the total number of vertices and elements. </summary>
-    /// <param name="meshes"> A container of all meshes in the scene. </param>
-    /// <param name="vertexCount"> Where to output the calculated number of required vertices. </param>
-    /// <param name="elementCount"> Where to output the calculated number of required elements. </param>
-    void calculateSceneSize (const std::vector<scene::Mesh>& meshes, 
-        size_t& vertexCount, size_t& elementCount) noexcept;
+    /// <summary> 
+    /// Calculates where each mesh should begin in a combined vertex and element buffer by performing a prefix sum of
+    /// the size of each mesh. Each output will contain one more value than there are meshes, the last value being
+    /// the total size of the scene.
+    /// </summary>
+    /// <param name="meshes"> Every mesh in the order they will be stored. </param>
+    /// <param name="vertexOffsets"> Where to output the index of the first vertex of each mesh. </param>
+    /// <param name="elementOffsets"> Where to output the index of the first element of each mesh. </param>
+    void calculateSceneSize (const std::vector<const scene::Mesh*>& meshes, 
+        std::vector<size_t>& vertexOffsets, std::vector<size_t>& elementOffsets) noexcept;
+
+    /// <summary>
+    /// Hashes every piece of mesh data which contributes to the assembled vertices and elements of the mesh. Meshes
+    /// with identical hashes should be compared with meshDataEquals() before being treated as duplicates.
+    /// </summary>
+    /// <param name="mesh"> The mesh to hash. </param>
+    /// <returns> A 64-bit FNV-1a hash of the positions, normals, texture co-ordinates and elements. </returns>
+    std::uint64_t hashMeshData (const scene::Mesh& mesh) noexcept;
+
+    /// <summary> Checks whether two meshes would produce byte-identical vertices and elements. </summary>
+    bool meshDataEquals (const scene::Mesh& lhs, const scene::Mesh& rhs) noexcept;
 
     /// <summary> Retrieves a physically-based shading interpretation of every material in the scene. </summary>
     /// <param name="scene"> The scene to retrieve materials from. </param>
@@ -0,0 +1,300 @@
+#include "StartupTimeline.hpp"
+
+
+// STL headers.
+#include <atomic>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+
+// Engine headers.
+#if defined _WIN32
+    #if !defined WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #if !defined NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <Windows.h>
+    #include <Psapi.h>
+    #pragma comment (lib, "Psapi.lib")
+#else
+    #include <sys/resource.h>
+#endif
+
+
+namespace
+{
+    std::atomic<std::uint64_t> uploadedBytes { 0 }; //!< The total number of bytes uploaded to OpenGL.
+
+
+    /// <summary> Gets the total CPU time used by every thread in the process, in milliseconds. </summary>
+    double processCPUTime() noexcept
+    {
+        #if defined _WIN32
+            auto creation = FILETIME { }, exit = FILETIME { }, kernel = FILETIME { }, user = FILETIME { };
+            if (!GetProcessTimes (GetCurrentProcess(), &creation, &exit, &kernel, &user))
+            {
+                return 0.0;
+            }
+
+            // FILETIME values are measured in 100 nanosecond intervals.
+            const auto toTicks = [] (const FILETIME& time)
+            {
+                return (static_cast<std::uint64_t> (time.dwHighDateTime) << 32) | time.dwLowDateTime;
+            };
+
+            return (toTicks (kernel) + toTicks (user)) / 10000.0;
+        #else
+            auto usage = rusage { };
+            getrusage (RUSAGE_SELF, &usage);
+
+            const auto toMilliseconds = [] (const timeval& time)
+            {
+                return time.tv_sec * 1000.0 + time.tv_usec / 1000.0;
+            };
+
+            return toMilliseconds (usage.ru_utime) + toMilliseconds (usage.ru_stime);
+        #endif
+    }
+
+
+    /// <summary> Gets the total number of bytes read by the process, including reads served by the OS cache. </summary>
+    std::uint64_t processBytesRead() noexcept
+    {
+        #if defined _WIN32
+            auto counters = IO_COUNTERS { };
+            return GetProcessIoCounters (GetCurrentProcess(), &counters) ? counters.ReadTransferCount : 0;
+        #else
+            auto file   = std::ifstream { "/proc/self/io" };
+            auto key    = std::string { };
+            auto value  = std::uint64_t { 0 };
+
+            while (file >> key >> value)
+            {
+                if (key == "rchar:")
+                {
+                    return value;
+                }
+            }
+
+            return 0;
+        #endif
+    }
+
+
+    /// <summary> Gets the peak memory usage of the process in bytes. </summary>
+    std::uint64_t processPeakMemory() noexcept
+    {
+        #if defined _WIN32
+            auto counters = PROCESS_MEMORY_COUNTERS { };
+            return GetProcessMemoryInfo (GetCurrentProcess(), &counters, sizeof (counters)) ?
+                counters.PeakWorkingSetSize : 0;
+        #else
+            auto usage = rusage { };
+            getrusage (RUSAGE_SELF, &usage);
+            return static_cast<std::uint64_t> (usage.ru_maxrss) * 1024;
+        #endif
+    }
+
+
+    /// <summary> Writes the given string as a JSON string literal. </summary>
+    void writeString (std::ostream& stream, const std::string& string)
+    {
+        stream << '"';
+        for (const auto character : string)
+        {
+            if (character == '"' || character == '\\')
+            {
+                stream << '\\';
+            }
+            stream << character;
+        }
+        stream << '"';
+    }
+}
+
+
+StartupTimeline& StartupTimeline::instance() noexcept
+{
+    static StartupTimeline timeline { };
+    return timeline;
+}
+
+
+void StartupTimeline::recordUpload (const std::uint64_t bytes) noexcept
+{
+    uploadedBytes.fetch_add (bytes, std::memory_order_relaxed);
+}
+
+
+void StartupTimeline::begin (const char* name) noexcept
+{
+    if (m_stopped)
+    {
+        return;
+    }
+
+    try
+    {
+        auto phase      = Phase { };
+        phase.name      = name;
+        phase.parent    = m_active.empty() ? noParent : m_active.back().index;
+
+        auto active     = Active { };
+        active.index    = m_phases.size();
+
+        m_phases.push_back (std::move (phase));
+        m_active.push_back (active);
+
+        // Sample last so the bookkeeping isn't included in the measurements.
+        m_active.back().start = sample();
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "StartupTimeline::begin(): Unable to record \"" << name << "\": " << e.what() << std::endl;
+    }
+}
+
+
+void StartupTimeline::end() noexcept
+{
+    if (m_active.empty())
+    {
+        return;
+    }
+
+    const auto now      = sample();
+    const auto active   = m_active.back();
+    auto& phase         = m_phases[active.index];
+    m_active.pop_back();
+
+    phase.wallTime      = std::chrono::duration<double, std::milli> (now.time - active.start.time).count();
+    phase.cpuTime       = now.cpuTime - active.start.cpuTime;
+    phase.diskBytesRead = now.diskBytesRead - active.start.diskBytesRead;
+    phase.uploadedBytes = now.uploadedBytes - active.start.uploadedBytes;
+    phase.peakMemory    = processPeakMemory();
+}
+
+
+void StartupTimeline::clear() noexcept
+{
+    m_phases.clear();
+    m_active.clear();
+    m_stopped = false;
+}
+
+
+bool StartupTimeline::writeJSON (const std::string& fileLocation) const noexcept
+{
+    try
+    {
+        auto file = std::ofstream { fileLocation, std::ios::trunc };
+        if (!file.is_open())
+        {
+            std::cerr << "StartupTimeline::writeJSON(): Unable to open \"" << fileLocation << "\"." << std::endl;
+            return false;
+        }
+
+        file << std::fixed << std::setprecision (3);
+        file << "{\n  \"phases\": [";
+
+        auto separator = "\n";
+        for (size_t i { 0 }; i < m_phases.size(); ++i)
+        {
+            if (m_phases[i].parent == noParent)
+            {
+                file << separator;
+                writePhase (file, i, 4);
+                separator = ",\n";
+            }
+        }
+
+        file << "\n  ]\n}\n";
+        return file.good();
+    }
+
+    catch (const std::exception& e)
+    {
+        std::cerr << "StartupTimeline::writeJSON(): " << e.what() << std::endl;
+        return false;
+    }
+}
+
+
+void StartupTimeline::printSummary() const noexcept
+{
+    constexpr auto megabyte = 1024.0 * 1024.0;
+
+    std::cout << "Startup timeline:" << std::endl;
+    std::cout << "  " << std::left << std::setw (40) << "Phase" << std::right
+              << std::setw (10) << "Wall ms" << std::setw (10) << "CPU ms" << std::setw (11) << "Read MiB"
+              << std::setw (13) << "Upload MiB" << std::setw (11) << "Peak MiB" << std::endl;
+
+    for (const auto& phase : m_phases)
+    {
+        // Indent sub-steps according to how deeply they're nested.
+        auto depth = size_t { 0 };
+        for (auto parent = phase.parent; parent != noParent; parent = m_phases[parent].parent)
+        {
+            ++depth;
+        }
+
+        const auto name = std::string (depth * 2, ' ') + phase.name;
+        std::cout << "  " << std::left << std::setw (40) << name << std::right << std::fixed << std::setprecision (1)
+                  << std::setw (10) << phase.wallTime << std::setw (10) << phase.cpuTime
+                  << std::setw (11) << phase.diskBytesRead / megabyte
+                  << std::setw (13) << phase.uploadedBytes / megabyte
+                  << std::setw (11) << phase.peakMemory / megabyte << std::endl;
+    }
+}
+
+
+StartupTimeline::Sample StartupTimeline::sample() noexcept
+{
+    auto sample             = Sample { };
+    sample.time             = Clock::now();
+    sample.cpuTime          = processCPUTime();
+    sample.diskBytesRead    = processBytesRead();
+    sample.uploadedBytes    = uploadedBytes.load (std::memory_order_relaxed);
+    return sample;
+}
+
+
+void StartupTimeline::writePhase (std::ostream& stream, const size_t index, const size_t indent) const
+{
+    const auto& phase   = m_phases[index];
+    const auto padding  = std::string (indent, ' ');
+
+    stream << padding << "{\n";
+    stream << padding << "  \"name\": ";
+    writeString (stream, phase.name);
+    stream << ",\n";
+    stream << padding << "  \"wallMs\": " << phase.wallTime << ",\n";
+    stream << padding << "  \"cpuMs\": " << phase.cpuTime << ",\n";
+    stream << padding << "  \"diskBytesRead\": " << phase.diskBytesRead << ",\n";
+    stream << padding << "  \"uploadedBytes\": " << phase.uploadedBytes << ",\n";
+    stream << padding << "  \"peakMemoryBytes\": " << phase.peakMemory << ",\n";
+    stream << padding << "  \"children\": [";
+
+    // Children always follow their parent so we only need to search the remaining phases.
+    auto hasChildren = false;
+    for (size_t i { index + 1 }; i < m_phases.size(); ++i)
+    {
+        if (m_phases[i].parent == index)
+        {
+            stream << (hasChildren ? ",\n" : "\n");
+            writePhase (stream, i, indent + 4);
+            hasChildren = true;
+        }
+    }
+
+    if (hasChildren)
+    {
+        stream << "\n" << padding << "  ";
+    }
+
+    stream << "]\n" << padding << "}";
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#if !defined    _UTIL_STARTUP_TIMELINE_
+#define         _UTIL_STARTUP_TIMELINE_
+
+// STL headers.
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+
+/// <summary>
+/// Records the cost of each phase of application startup. Phases can be nested to record sub-steps and each one
+/// stores the wall time, CPU time, bytes read from disk, bytes uploaded to OpenGL and the peak memory usage of the
+/// process when the phase ended. CPU time and disk reads are measured for the entire process so they include work
+/// performed by background threads during the phase. Phases must only be started and ended on the main thread.
+/// </summary>
+class StartupTimeline final
+{
+    public:
+
+        /// <summary> The measurements taken for a single phase. </summary>
+        struct Phase final
+        {
+            std::string     name            { };    //!< What the phase was doing.
+            size_t          parent          { 0 };  //!< The index of the enclosing phase, or noParent.
+            double          wallTime        { 0 };  //!< How many milliseconds passed during the phase.
+            double          cpuTime         { 0 };  //!< How many milliseconds of CPU time were used by the process.
+            std::uint64_t   diskBytesRead   { 0 };  //!< How many bytes the process read from disk.
+            std::uint64_t   uploadedBytes   { 0 };  //!< How many bytes were uploaded to OpenGL buffers and textures.
+            std::uint64_t   peakMemory      { 0 };  //!< The peak memory usage of the process, in bytes.
+        };
+
+        /// <summary> Starts a phase on construction and ends it on destruction. </summary>
+        class Scope final
+        {
+            public:
+
+                explicit Scope (const char* name) noexcept  { StartupTimeline::instance().begin (name); }
+                ~Scope()                                    { StartupTimeline::instance().end(); }
+
+                Scope (Scope&&)                             = delete;
+                Scope (const Scope&)                        = delete;
+                Scope& operator= (Scope&&)                  = delete;
+                Scope& operator= (const Scope&)             = delete;
+        };
+
+        constexpr static auto noParent = static_cast<size_t> (-1);
+
+    public:
+
+        StartupTimeline() noexcept                          = default;
+        ~StartupTimeline()                                  = default;
+
+        StartupTimeline (StartupTimeline&&)                 = delete;
+        StartupTimeline (const StartupTimeline&)            = delete;
+        StartupTimeline& operator= (StartupTimeline&&)      = delete;
+        StartupTimeline& operator= (const StartupTimeline&) = delete;
+
+
+        /// <summary> Gets the timeline shared by the entire application. </summary>
+        static StartupTimeline& instance() noexcept;
+
+        /// <summary>
+        /// Adds to the total number of bytes uploaded to OpenGL. This is called by buffer and texture objects and is
+        /// safe to call from any thread.
+        /// </summary>
+        static void recordUpload (const std::uint64_t bytes) noexcept;
+
+
+        /// <summary> Gets every completed phase in the order they were started. </summary>
+        const std::vector<Phase>& getPhases() const noexcept { return m_phases; }
+
+
+        /// <summary> Starts a new phase, nested inside the active phase if there is one. Ignored once stopped. </summary>
+        void begin (const char* name) noexcept;
+
+        /// <summary> Ends the most recently started phase, recording its measurements. </summary>
+        void end() noexcept;
+
+        /// <summary>
+        /// Marks the end of startup. Any phases started afterwards will be ignored, this allows phases to be placed in
+        /// functions which are also called after startup, such as when the resolution changes.
+        /// </summary>
+        void stop() noexcept { m_stopped = true; }
+
+        /// <summary> 
+        /// Discards every recorded phase, including any which haven't ended, and resumes recording if stopped. This 
+        /// should be called before startup is repeated, such as when the renderer is initialised again.
+        /// </summary>
+        void clear() noexcept;
+
+
+        /// <summary> Writes every phase to the given file as JSON, with sub-steps nested inside their phase. </summary>
+        /// <param name="fileLocation"> Where to write the file, any existing file will be overwritten. </param>
+        /// <returns> Whether the file was written successfully. </returns>
+        bool writeJSON (const std::string& fileLocation) const noexcept;
+
+        /// <summary> Writes a human-readable summary of every phase to the console. </summary>
+        void printSummary() const noexcept;
+
+    private:
+
+        using Clock = std::chrono::steady_clock;
+
+        /// <summary> A snapshot of the process taken at the start of a phase. </summary>
+        struct Sample final
+        {
+            Clock::time_point   time            { };    //!< When the sample was taken.
+            double              cpuTime         { 0 };  //!< The CPU time used by the process so far in milliseconds.
+            std::uint64_t       diskBytesRead   { 0 };  //!< The number of bytes read by the process so far.
+            std::uint64_t       uploadedBytes   { 0 };  //!< The number of bytes uploaded to OpenGL so far.
+        };
+
+        /// <summary> A phase which has been started but not ended. </summary>
+        struct Active final
+        {
+            size_t  index   { 0 };  //!< The index of the phase in m_phases.
+            Sample  start   { };    //!< The state of the process when the phase started.
+        };
+
+        std::vector<Phase>  m_phases    { };        //!< Every phase, in the order they were started.
+        std::vector<Active> m_active    { };        //!< A stack of phases which haven't ended yet.
+        bool                m_stopped   { false };  //!< Whether startup has finished and new phases should be ignored.
+
+    private:
+
+        /// <summary> Measures the current state of the process. </summary>
+        static Sample sample() noexcept;
+
+        /// <summary> Writes the phase at the given index and all of its children as JSON. </summary>
+        void writePhase (std::ostream& stream, const size_t index, const size_t indent) const;
+};
+
+#endif // _UTIL_STARTUP_TIMELINE_
@@ -0,0 +1,140 @@
+#include "TextureAtlas.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+
+namespace
+{
+    /// <summary> A row of cells in a page, every cell in the row is no taller than the shelf. </summary>
+    struct Shelf final
+    {
+        size_t  page    { 0 };  //!< The page containing the shelf.
+        size_t  y       { 0 };  //!< The top of the shelf.
+        size_t  height  { 0 };  //!< The height of the tallest cell.
+        size_t  used    { 0 };  //!< How much of the width has been filled.
+    };
+
+
+    /// <summary> Rounds the given value up to a multiple of the alignment. </summary>
+    inline size_t alignUp (const size_t value, const size_t alignment) noexcept
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+
+    /// <summary> Calculates the cell size of an image along a single axis. </summary>
+    inline size_t cellSize (const size_t size, const size_t pageDimensions, const size_t gutter,
+        const size_t alignment) noexcept
+    {
+        return size == pageDimensions ? size : alignUp (size + gutter * 2, alignment);
+    }
+}
+
+
+bool util::fitsInAtlas (const size_t width, const size_t height, const size_t pageDimensions,
+    const size_t gutter, const size_t alignment) noexcept
+{
+    return  width > 0 && height > 0 &&
+            cellSize (width, pageDimensions, gutter, alignment) <= pageDimensions &&
+            cellSize (height, pageDimensions, gutter, alignment) <= pageDimensions;
+}
+
+
+std::vector<util::AtlasRegion> util::packAtlas (const std::vector<std::pair<size_t, size_t>>& sizes,
+    const size_t pageDimensions, const size_t gutter, const size_t alignment, size_t& pageCount)
+{
+    auto regions = std::vector<AtlasRegion> (sizes.size());
+    for (size_t i { 0 }; i < sizes.size(); ++i)
+    {
+        auto& region        = regions[i];
+        region.width        = sizes[i].first;
+        region.height       = sizes[i].second;
+        region.cellWidth    = cellSize (region.width, pageDimensions, gutter, alignment);
+        region.cellHeight   = cellSize (region.height, pageDimensions, gutter, alignment);
+    }
+
+    // Tallest first keeps shelves full, ties are broken by width and then index so packing is deterministic.
+    auto order = std::vector<size_t> (sizes.size());
+    std::iota (std::begin (order), std::end (order), size_t { 0 });
+    std::sort (std::begin (order), std::end (order), [&] (const size_t a, const size_t b)
+    {
+        const auto& lhs = regions[a];
+        const auto& rhs = regions[b];
+
+        return  lhs.cellHeight != rhs.cellHeight ? lhs.cellHeight > rhs.cellHeight :
+                lhs.cellWidth != rhs.cellWidth ? lhs.cellWidth > rhs.cellWidth : a < b;
+    });
+
+    auto shelves    = std::vector<Shelf> { };
+    auto pageUsage  = std::vector<size_t> { };
+
+    for (const auto index : order)
+    {
+        auto& region    = regions[index];
+        auto shelf      = std::find_if (std::begin (shelves), std::end (shelves), [&] (const Shelf& candidate)
+        {
+            return candidate.height >= region.cellHeight && candidate.used + region.cellWidth <= pageDimensions;
+        });
+
+        // Start a new shelf on the first page with enough room, otherwise start a new page.
+        if (shelf == std::end (shelves))
+        {
+            auto page = std::find_if (std::begin (pageUsage), std::end (pageUsage),
+                [&] (const size_t used) { return used + region.cellHeight <= pageDimensions; });
+
+            if (page == std::end (pageUsage))
+            {
+                page = pageUsage.insert (page, 0);
+            }
+
+            shelves.push_back ({ static_cast<size_t> (page - std::begin (pageUsage)), *page, region.cellHeight, 0 });
+            *page += region.cellHeight;
+            shelf = std::end (shelves) - 1;
+        }
+
+        region.page     = shelf->page;
+        region.cellX    = shelf->used;
+        region.cellY    = shelf->y;
+        region.x        = region.cellX + (region.cellWidth - region.width) / 2;
+        region.y        = region.cellY + (region.cellHeight - region.height) / 2;
+        shelf->used     += region.cellWidth;
+    }
+
+    pageCount = pageUsage.size();
+    return regions;
+}
+
+
+void util::placeInAtlas (const void* texels, const size_t texelSize, const AtlasRegion& region, void* page,
+    const size_t pageDimensions) noexcept
+{
+    const auto source       = static_cast<const std::uint8_t*> (texels);
+    const auto destination  = static_cast<std::uint8_t*> (page);
+    const auto rowSize      = region.width * texelSize;
+
+    for (size_t row { 0 }; row < region.cellHeight; ++row)
+    {
+        // Rows above and below the image wrap around to the opposite edge.
+        const auto pageY    = region.cellY + row;
+        const auto imageY   = (pageY + region.height - region.y % region.height) % region.height;
+        const auto imageRow = source + imageY * rowSize;
+        auto pageRow        = destination + (pageY * pageDimensions + region.cellX) * texelSize;
+
+        // The image row is repeated across the cell starting at the column which lines up with the image.
+        auto imageX = (region.cellX + region.width - region.x % region.width) % region.width;
+        for (auto remaining = region.cellWidth; remaining > 0;)
+        {
+            const auto count = std::min (region.width - imageX, remaining);
+            std::memcpy (pageRow, imageRow + imageX * texelSize, count * texelSize);
+
+            pageRow     += count * texelSize;
+            remaining   -= count;
+            imageX      = 0;
+        }
+    }
+}
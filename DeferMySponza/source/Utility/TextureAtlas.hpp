@@ -0,0 +1,64 @@
+#pragma once
+
+#if !defined    _UTIL_TEXTURE_ATLAS_
+#define         _UTIL_TEXTURE_ATLAS_
+
+// STL headers.
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+
+namespace util
+{
+    /// <summary> Where an image has been placed in an atlas, every value is in texels. </summary>
+    struct AtlasRegion final
+    {
+        size_t  page        { 0 };  //!< Which page of the atlas the image is stored in.
+        size_t  cellX       { 0 };  //!< The left of the cell reserved for the image and its gutter.
+        size_t  cellY       { 0 };  //!< The top of the cell reserved for the image and its gutter.
+        size_t  cellWidth   { 0 };  //!< The width of the cell, a multiple of the packing alignment.
+        size_t  cellHeight  { 0 };  //!< The height of the cell, a multiple of the packing alignment.
+        size_t  x           { 0 };  //!< The left of the image itself.
+        size_t  y           { 0 };  //!< The top of the image itself.
+        size_t  width       { 0 };  //!< The width of the image.
+        size_t  height      { 0 };  //!< The height of the image.
+    };
+
+
+    /// <summary>
+    /// Checks whether an image of the given size can be packed into an atlas. Images spanning an entire page axis
+    /// don't need a gutter along it as the page itself repeats.
+    /// </summary>
+    bool fitsInAtlas (const size_t width, const size_t height, const size_t pageDimensions,
+        const size_t gutter, const size_t alignment) noexcept;
+
+    /// <summary>
+    /// Packs images into square atlas pages using first-fit shelves, taller images are placed first. Every cell starts
+    /// and ends on a multiple of the alignment so a power-of-two alignment keeps images from sharing a texel with
+    /// their neighbours in every mipmap level down to pageDimensions / alignment. Each image is surrounded by a gutter
+    /// of at least the given size which is filled by placeInAtlas().
+    /// </summary>
+    /// <param name="sizes"> The width and height of each image, each must satisfy fitsInAtlas(). </param>
+    /// <param name="pageDimensions"> The width and height of each page. </param>
+    /// <param name="gutter"> How many texels should surround each image. </param>
+    /// <param name="alignment"> The size of cells is rounded up to this. </param>
+    /// <param name="pageCount"> Set to how many pages are required. </param>
+    /// <returns> The region of each image, in the same order as the sizes. </returns>
+    std::vector<AtlasRegion> packAtlas (const std::vector<std::pair<size_t, size_t>>& sizes,
+        const size_t pageDimensions, const size_t gutter, const size_t alignment, size_t& pageCount);
+
+    /// <summary>
+    /// Copies a tightly packed image into its region of an atlas page. The rest of the cell is filled by wrapping the
+    /// image so filtering across its edges matches a repeating texture.
+    /// </summary>
+    /// <param name="texels"> The texels of the image. </param>
+    /// <param name="texelSize"> How many bytes each texel occupies, the same for the image and page. </param>
+    /// <param name="region"> Where the image has been placed. </param>
+    /// <param name="page"> The tightly packed texels of the page. </param>
+    /// <param name="pageDimensions"> The width and height of the page. </param>
+    void placeInAtlas (const void* texels, const size_t texelSize, const AtlasRegion& region, void* page,
+        const size_t pageDimensions) noexcept;
+}
+
+#endif // _UTIL_TEXTURE_ATLAS_
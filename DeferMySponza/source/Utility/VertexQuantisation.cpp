@@ -0,0 +1,152 @@
+#include "VertexQuantisation.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <cmath>
+
+
+// Engine headers.
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <glm/gtc/packing.hpp>
+#include <glm/vec2.hpp>
+
+
+// Personal headers.
+#include <Rendering/Renderer/Geometry/Internals/CompactVertex.hpp>
+#include <Rendering/Renderer/Geometry/Internals/Vertex.hpp>
+
+
+namespace
+{
+    constexpr auto unorm16Max       = 65535.f;  //!< The largest 16-bit unsigned normalised value.
+    constexpr auto snorm16Max       = 32767.f;  //!< The largest 16-bit signed normalised value.
+    constexpr auto thinAxisRatio    = 64.f;     //!< Axes are at least this fraction of the largest axis.
+    constexpr auto degrees          = 57.2957795f;
+
+
+    /// <summary> Returns -1 for negative values and 1 otherwise, zero must map to a valid octahedron face. </summary>
+    inline glm::vec2 signNotZero (const glm::vec2& v) noexcept
+    {
+        return { v.x >= 0.f ? 1.f : -1.f, v.y >= 0.f ? 1.f : -1.f };
+    }
+
+
+    /// <summary> Projects a unit vector onto an octahedron and unfolds it into the [-1, 1] square. </summary>
+    glm::vec2 encodeOctahedral (const glm::vec3& n) noexcept
+    {
+        const auto projected = glm::vec2 { n.x, n.y } / (std::abs (n.x) + std::abs (n.y) + std::abs (n.z));
+        
+        return n.z >= 0.f ? projected 
+            : (1.f - glm::abs (glm::vec2 { projected.y, projected.x })) * signNotZero (projected);
+    }
+
+
+    /// <summary> The inverse of encodeOctahedral(), this must match decodeOctahedral() in Geometry.vs.glsl. </summary>
+    glm::vec3 decodeOctahedral (const glm::vec2& e) noexcept
+    {
+        auto n          = glm::vec3 { e.x, e.y, 1.f - std::abs (e.x) - std::abs (e.y) };
+        const auto t    = std::max (-n.z, 0.f);
+        n.x += n.x >= 0.f ? -t : t;
+        n.y += n.y >= 0.f ? -t : t;
+        return glm::normalize (n);
+    }
+
+
+    inline GLushort toUnorm16 (const float value) noexcept
+    {
+        return static_cast<GLushort> (std::round (glm::clamp (value, 0.f, 1.f) * unorm16Max));
+    }
+
+
+    inline GLshort toSnorm16 (const float value) noexcept
+    {
+        return static_cast<GLshort> (std::round (glm::clamp (value, -1.f, 1.f) * snorm16Max));
+    }
+
+
+    inline float fromSnorm16 (const GLshort value) noexcept
+    {
+        return std::max (value / snorm16Max, -1.f);
+    }
+
+
+    /// <summary> The angle between two vectors in degrees, zero-length vectors have no meaningful error. </summary>
+    float angleBetween (const glm::vec3& a, const glm::vec3& b) noexcept
+    {
+        const auto lengths = glm::length (a) * glm::length (b);
+        return lengths > 0.f ? std::acos (glm::clamp (glm::dot (a, b) / lengths, -1.f, 1.f)) * degrees : 0.f;
+    }
+}
+
+
+void util::QuantisationError::merge (const QuantisationError& other) noexcept
+{
+    position        = std::max (position, other.position);
+    normalDegrees   = std::max (normalDegrees, other.normalDegrees);
+    texturePoint    = std::max (texturePoint, other.texturePoint);
+    vertices        += other.vertices;
+}
+
+
+void util::calculateQuantisation (const glm::vec3& min, const glm::vec3& max, glm::vec3& offset, 
+    glm::vec3& scale) noexcept
+{
+    const auto extent   = max - min;
+    const auto largest  = std::max (std::max (extent.x, extent.y), extent.z);
+    
+    offset  = min;
+    scale   = largest > 0.f ? glm::max (extent, glm::vec3 { largest / thinAxisRatio }) : glm::vec3 { 1.f };
+}
+
+
+CompactVertex util::compactVertex (const Vertex& vertex, const glm::vec3& offset, const glm::vec3& scale) noexcept
+{
+    const auto position = (vertex.position - offset) / scale;
+    const auto skewed   = vertex.normal / scale;
+    const auto length   = glm::length (skewed);
+    const auto normal   = length > 0.f ? encodeOctahedral (skewed / length) : glm::vec2 { 0.f };
+
+    auto compact            = CompactVertex { };
+    compact.position        = { toUnorm16 (position.x), toUnorm16 (position.y), toUnorm16 (position.z) };
+    compact.normal          = { toSnorm16 (normal.x), toSnorm16 (normal.y) };
+    compact.texturePoint    = { glm::packHalf1x16 (vertex.texturePoint.x), glm::packHalf1x16 (vertex.texturePoint.y) };
+    return compact;
+}
+
+
+Vertex util::expandVertex (const CompactVertex& vertex, const glm::vec3& offset, const glm::vec3& scale) noexcept
+{
+    const auto position = glm::vec3 { vertex.position[0], vertex.position[1], vertex.position[2] } / unorm16Max;
+    const auto skewed   = decodeOctahedral ({ fromSnorm16 (vertex.normal[0]), fromSnorm16 (vertex.normal[1]) });
+
+    return 
+    {
+        offset + position * scale,
+        glm::normalize (skewed * scale),
+        { glm::unpackHalf1x16 (vertex.texturePoint[0]), glm::unpackHalf1x16 (vertex.texturePoint[1]) }
+    };
+}
+
+
+util::QuantisationError util::compactVertices (const Vertex* vertices, const size_t count, const glm::vec3& offset,
+    const glm::vec3& scale, CompactVertex* const output) noexcept
+{
+    auto error      = QuantisationError { };
+    error.vertices  = count;
+
+    for (size_t i { 0 }; i < count; ++i)
+    {
+        const auto& original    = vertices[i];
+        output[i]               = compactVertex (original, offset, scale);
+        const auto decoded      = expandVertex (output[i], offset, scale);
+        const auto uvError      = glm::abs (decoded.texturePoint - original.texturePoint);
+
+        error.position      = std::max (error.position, glm::length (decoded.position - original.position));
+        error.normalDegrees = std::max (error.normalDegrees, angleBetween (decoded.normal, original.normal));
+        error.texturePoint  = std::max (error.texturePoint, std::max (uvError.x, uvError.y));
+    }
+
+    return error;
+}
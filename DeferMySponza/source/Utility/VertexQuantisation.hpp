@@ -0,0 +1,65 @@
+#pragma once
+
+#if !defined    _UTIL_VERTEX_QUANTISATION_
+#define         _UTIL_VERTEX_QUANTISATION_
+
+// STL headers.
+#include <cstddef>
+
+
+// Engine headers.
+#include <glm/vec3.hpp>
+
+
+// Forward declarations.
+struct CompactVertex;
+struct Vertex;
+
+
+namespace util
+{
+    /// <summary> The worst errors introduced by quantising vertices, measured by decoding each vertex. </summary>
+    struct QuantisationError final
+    {
+        float   position        { 0.f };    //!< The largest distance between an original and decoded position.
+        float   normalDegrees   { 0.f };    //!< The largest angle between an original and decoded normal.
+        float   texturePoint    { 0.f };    //!< The largest difference in a texture co-ordinate component.
+        size_t  vertices        { 0 };      //!< How many vertices were encoded.
+
+        /// <summary> Combines the errors of two sets of vertices. </summary>
+        void merge (const QuantisationError& other) noexcept;
+    };
+
+
+    /// <summary>
+    /// Chooses how the positions of a mesh are quantised from its bounds. Each axis spans the bounds so the error is
+    /// at most half a 16-bit step of each axis. Thin axes are widened to a fraction of the largest axis so that
+    /// normals, which are skewed by the inverse scale, keep enough precision.
+    /// </summary>
+    /// <param name="min"> The minimum corner of the mesh bounds. </param>
+    /// <param name="max"> The maximum corner of the mesh bounds. </param>
+    /// <param name="offset"> Outputs the position a quantised value of zero represents. </param>
+    /// <param name="scale"> Outputs the span of each axis, see Mesh::dequantise(). </param>
+    void calculateQuantisation (const glm::vec3& min, const glm::vec3& max, glm::vec3& offset, 
+        glm::vec3& scale) noexcept;
+
+    /// <summary> 
+    /// Quantises a vertex. The normal is divided by the scale before being encoded so that transforming it by the
+    /// dequantising model transform restores its original direction.
+    /// </summary>
+    CompactVertex compactVertex (const Vertex& vertex, const glm::vec3& offset, const glm::vec3& scale) noexcept;
+
+    /// <summary> Decodes a quantised vertex back into object space, matching what the shaders will see. </summary>
+    Vertex expandVertex (const CompactVertex& vertex, const glm::vec3& offset, const glm::vec3& scale) noexcept;
+
+    /// <summary> Quantises every vertex of a mesh and measures the error introduced. </summary>
+    /// <param name="vertices"> The vertices to encode. </param>
+    /// <param name="count"> How many vertices there are. </param>
+    /// <param name="offset"> The quantisation offset from calculateQuantisation(). </param>
+    /// <param name="scale"> The quantisation scale from calculateQuantisation(). </param>
+    /// <param name="output"> Where to write the quantised vertices, must have space for count vertices. </param>
+    QuantisationError compactVertices (const Vertex* vertices, const size_t count, const glm::vec3& offset, 
+        const glm::vec3& scale, CompactVertex* const output) noexcept;
+}
+
+#endif // _UTIL_VERTEX_QUANTISATION_
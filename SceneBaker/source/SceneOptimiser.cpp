@@ -0,0 +1,385 @@
+#include "SceneOptimiser.hpp"
+
+
+// STL headers.
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+
+// Engine headers.
+#include <tcf/tcf.hpp>
+#include <tcf/SimpleScene.hpp>
+
+
+// Namespaces.
+using Mesh = tcf::SimpleScene::Mesh;
+
+
+namespace
+{
+    /// <summary> The bit patterns of every attribute which survives optimisation, used to weld vertices. </summary>
+    using VertexKey = std::array<std::uint32_t, 8>;
+
+    /// <summary> An FNV-1a hash of a vertex key. </summary>
+    struct VertexKeyHash final
+    {
+        size_t operator() (const VertexKey& key) const noexcept
+        {
+            auto hash = std::uint64_t { 14695981039346656037ULL };
+            for (const auto value : key)
+            {
+                hash ^= value;
+                hash *= 1099511628211ULL;
+            }
+            return static_cast<size_t> (hash);
+        }
+    };
+
+
+    /// <summary>
+    /// Creates a key from the attributes of a vertex. The bits are compared rather than the float values so that
+    /// welding never changes the appearance of a mesh.
+    /// </summary>
+    VertexKey makeKey (const Mesh& mesh, const unsigned int index) noexcept
+    {
+        auto attributes = std::array<float, 8> { };
+
+        const auto& position    = mesh.positionArray()[index];
+        attributes[0]           = position.x;
+        attributes[1]           = position.y;
+        attributes[2]           = position.z;
+
+        if (mesh.normalArray())
+        {
+            const auto& normal  = mesh.normalArray()[index];
+            attributes[3]       = normal.x;
+            attributes[4]       = normal.y;
+            attributes[5]       = normal.z;
+        }
+
+        if (mesh.uvArray())
+        {
+            const auto& uv  = mesh.uvArray()[index];
+            attributes[6]   = uv.x;
+            attributes[7]   = uv.y;
+        }
+
+        auto key = VertexKey { };
+        std::memcpy (key.data(), attributes.data(), sizeof (key));
+        return key;
+    }
+
+
+    /// <summary> Calculates how many bytes of vertex and index data the given mesh contains. </summary>
+    size_t calculateGeometrySize (const Mesh& mesh) noexcept
+    {
+        auto vertexSize = sizeof (tcf::Vector3);
+        vertexSize      += mesh.normalArray() ? sizeof (tcf::Vector3) : 0;
+        vertexSize      += mesh.tangentArray() ? sizeof (tcf::Vector3) : 0;
+        vertexSize      += mesh.uvArray() ? sizeof (tcf::Vector2) : 0;
+
+        return vertexSize * mesh.vertexCount() + sizeof (int) * mesh.indexCount();
+    }
+
+
+    /// <summary> Retrieves the size of the given file in bytes, zero will be returned if it can't be opened. </summary>
+    size_t fileSize (const std::string& fileLocation) noexcept
+    {
+        auto file = std::ifstream { fileLocation, std::ios::binary | std::ios::ate };
+        return file.is_open() ? static_cast<size_t> (file.tellg()) : 0;
+    }
+
+
+    /// <summary> Checks that every vertex has a position and every index has an index array to come from. </summary>
+    bool hasRequiredArrays (const Mesh& mesh) noexcept
+    {
+        return (mesh.vertexCount() == 0 || mesh.positionArray()) && (mesh.indexCount() == 0 || mesh.indexArray());
+    }
+
+
+    /// <summary> Copies the instance transforms and materials of the input mesh into the output mesh. </summary>
+    void copyInstances (const Mesh& input, Mesh& output)
+    {
+        const auto hasMaterials = input.materialArray() != nullptr;
+        output.setInstances (input.instanceCount(), hasMaterials);
+
+        std::copy_n (input.transformationArray(), input.instanceCount(), output.transformationArray());
+        if (hasMaterials)
+        {
+            std::copy_n (input.materialArray(), input.instanceCount(), output.materialArray());
+        }
+    }
+
+
+    /// <summary>
+    /// Copies the geometry of the input mesh without any modification, except for the removal of tangents. This is
+    /// used for meshes which can't be welded. The input must have passed hasRequiredArrays().
+    /// </summary>
+    void copyGeometry (const Mesh& input, Mesh& output)
+    {
+        const auto vertexCount  = input.vertexCount();
+        const auto hasNormals   = input.normalArray() != nullptr;
+        const auto hasUVs       = input.uvArray() != nullptr;
+
+        output.setGeometry (input.topology(), vertexCount, hasNormals, false, hasUVs, input.indexCount());
+
+        std::copy_n (input.indexArray(), input.indexCount(), output.indexArray());
+        std::copy_n (input.positionArray(), vertexCount, output.positionArray());
+
+        if (hasNormals)
+        {
+            std::copy_n (input.normalArray(), vertexCount, output.normalArray());
+        }
+
+        if (hasUVs)
+        {
+            std::copy_n (input.uvArray(), vertexCount, output.uvArray());
+        }
+    }
+
+
+    /// <summary>
+    /// Welds identical vertices, removes degenerate triangles and discards unreferenced vertices. The remaining
+    /// vertices are stored in the order they're first referenced, keeping the vertex fetches of the index buffer as
+    /// local as possible.
+    /// </summary>
+    /// <returns> Whether the mesh was valid and has been written to the output. </returns>
+    bool weldGeometry (const Mesh& input, Mesh& output, size_t& degenerateTriangles)
+    {
+        const auto vertexCount  = input.vertexCount();
+        const auto indexCount   = input.indexCount() - input.indexCount() % 3;
+        const auto indices      = input.indexArray();
+
+        // Ensure the indices are valid before we start using them.
+        if (!input.positionArray() || !indices ||
+            std::any_of (indices, indices + indexCount, [=] (const int i) { return i < 0 || i >= (int) vertexCount; }))
+        {
+            return false;
+        }
+
+        // Firstly map every vertex onto the first vertex with identical attributes.
+        auto unique     = std::unordered_map<VertexKey, int, VertexKeyHash> { };
+        auto canonical  = std::vector<int> (vertexCount);
+        unique.reserve (vertexCount);
+
+        for (unsigned int i { 0 }; i < vertexCount; ++i)
+        {
+            canonical[i] = unique.emplace (makeKey (input, i), static_cast<int> (i)).first->second;
+        }
+
+        // Now rebuild the index buffer, assigning new vertex indices as they're first used.
+        auto remapped   = std::vector<int> (vertexCount, -1);
+        auto sources    = std::vector<int> { };
+        auto elements   = std::vector<int> { };
+        sources.reserve (unique.size());
+        elements.reserve (indexCount);
+
+        for (unsigned int i { 0 }; i < indexCount; i += 3)
+        {
+            const auto a = canonical[indices[i]];
+            const auto b = canonical[indices[i + 1]];
+            const auto c = canonical[indices[i + 2]];
+
+            // Welding can collapse triangles, these can't produce fragments so we may as well remove them.
+            if (a == b || b == c || a == c)
+            {
+                ++degenerateTriangles;
+                continue;
+            }
+
+            for (const auto vertex : { a, b, c })
+            {
+                if (remapped[vertex] < 0)
+                {
+                    remapped[vertex] = static_cast<int> (sources.size());
+                    sources.push_back (vertex);
+                }
+
+                elements.push_back (remapped[vertex]);
+            }
+        }
+
+        // Finally write the compacted geometry.
+        const auto hasNormals   = input.normalArray() != nullptr;
+        const auto hasUVs       = input.uvArray() != nullptr;
+        const auto outputCount  = static_cast<unsigned int> (sources.size());
+
+        output.setGeometry (tcf::SimpleScene::kIndexedTriangleList, outputCount, hasNormals, false, hasUVs,
+            static_cast<unsigned int> (elements.size()));
+
+        std::copy (elements.cbegin(), elements.cend(), output.indexArray());
+
+        for (unsigned int i { 0 }; i < outputCount; ++i)
+        {
+            const auto source = sources[i];
+
+            output.positionArray()[i] = input.positionArray()[source];
+
+            if (hasNormals)
+            {
+                output.normalArray()[i] = input.normalArray()[source];
+            }
+
+            if (hasUVs)
+            {
+                output.uvArray()[i] = input.uvArray()[source];
+            }
+        }
+
+        return true;
+    }
+}
+
+
+bool SceneOptimiser::optimise (const std::string& inputLocation, const std::string& outputLocation) noexcept
+{
+    m_statistics = Statistics { };
+
+    auto reader     = tcf::createReaderPtr();
+    auto input      = tcf::SimpleScenePtr { nullptr, tcf::deleteSimpleScene };
+    auto headType   = tcf::Type::nullType();
+    auto head       = std::vector<char> { };
+
+    try
+    {
+        reader->openFile (inputLocation.c_str());
+
+        // The HEAD chunk isn't used by the scene but we'll preserve it in the output.
+        reader->openChunk();
+        headType = reader->chunkType();
+        head.resize (reader->remainingData());
+
+        if (!head.empty())
+        {
+            reader->readData (static_cast<unsigned int> (head.size()), head.data());
+        }
+
+        reader->closeChunk();
+
+        // The scene itself should be the next chunk.
+        if (reader->hasChunk())
+        {
+            reader->openChunk();
+            if (tcf::chunkIsSimpleScene (reader.get()))
+            {
+                input.reset (tcf::readSimpleScene (reader.get()));
+            }
+        }
+
+        reader->closeFile();
+    }
+
+    catch (...)
+    {
+        std::cerr << "SceneOptimiser::optimise(): Unable to read \"" << inputLocation << "\"." << std::endl;
+        return false;
+    }
+
+    if (!input)
+    {
+        std::cerr << "SceneOptimiser::optimise(): \"" << inputLocation << "\" doesn't contain a scene." << std::endl;
+        return false;
+    }
+
+    // Now we can build the optimised scene.
+    auto output = tcf::createSimpleScenePtr();
+
+    try
+    {
+        m_statistics.meshes = input->meshCount();
+
+        for (unsigned int i { 0 }; i < input->meshCount(); ++i)
+        {
+            const auto& inputMesh = *input->findMeshByIndex (i);
+
+            // A mesh without positions or indices can't be copied, let alone optimised.
+            if (!hasRequiredArrays (inputMesh))
+            {
+                std::cerr << "SceneOptimiser::optimise(): Mesh \"" << inputMesh.name() 
+                          << "\" has vertices or indices without data." << std::endl;
+                return false;
+            }
+
+            auto& outputMesh = *output->createMesh (inputMesh.name());
+
+            const auto canWeld  = inputMesh.topology() == tcf::SimpleScene::kIndexedTriangleList;
+            if (!(canWeld && weldGeometry (inputMesh, outputMesh, m_statistics.degenerateTriangles)))
+            {
+                copyGeometry (inputMesh, outputMesh);
+            }
+
+            copyInstances (inputMesh, outputMesh);
+
+            m_statistics.inputVertices          += inputMesh.vertexCount();
+            m_statistics.outputVertices         += outputMesh.vertexCount();
+            m_statistics.inputIndices           += inputMesh.indexCount();
+            m_statistics.outputIndices          += outputMesh.indexCount();
+            m_statistics.droppedTangents        += inputMesh.tangentArray() ? 1 : 0;
+            m_statistics.inputGeometryBytes     += calculateGeometrySize (inputMesh);
+            m_statistics.outputGeometryBytes    += calculateGeometrySize (outputMesh);
+        }
+    }
+
+    catch (...)
+    {
+        std::cerr << "SceneOptimiser::optimise(): Unable to build the optimised scene." << std::endl;
+        return false;
+    }
+
+    // Write the HEAD chunk followed by the scene.
+    auto writer = tcf::createWriterPtr();
+
+    try
+    {
+        writer->createFile (outputLocation.c_str());
+
+        writer->createChunk (headType);
+        writer->writeData (head.data(), static_cast<unsigned int> (head.size()));
+        writer->endChunk();
+
+        tcf::writeSimpleScene (output.get(), writer.get());
+        writer->endFile();
+    }
+
+    catch (...)
+    {
+        std::cerr << "SceneOptimiser::optimise(): Unable to write \"" << outputLocation << "\"." << std::endl;
+        return false;
+    }
+
+    m_statistics.inputFileBytes     = fileSize (inputLocation);
+    m_statistics.outputFileBytes    = fileSize (outputLocation);
+    return true;
+}
+
+
+void SceneOptimiser::printStatistics() const noexcept
+{
+    const auto percentage = [] (const size_t before, const size_t after)
+    {
+        return before > 0 ? 100.0 * (static_cast<double> (before) - after) / before : 0.0;
+    };
+
+    const auto row = [&] (const char* label, const size_t before, const size_t after)
+    {
+        std::cout << "  " << std::left << std::setw (20) << label
+                  << std::right << std::setw (12) << before << " -> " << std::setw (12) << after
+                  << "  (" << std::fixed << std::setprecision (1) << percentage (before, after) << "% smaller)"
+                  << std::endl;
+    };
+
+    std::cout << "Optimised " << m_statistics.meshes << " meshes:" << std::endl;
+    row ("Vertices", m_statistics.inputVertices, m_statistics.outputVertices);
+    row ("Indices", m_statistics.inputIndices, m_statistics.outputIndices);
+    row ("Geometry bytes", m_statistics.inputGeometryBytes, m_statistics.outputGeometryBytes);
+    row ("File bytes", m_statistics.inputFileBytes, m_statistics.outputFileBytes);
+    std::cout << "  Degenerate triangles removed: " << m_statistics.degenerateTriangles << std::endl;
+    std::cout << "  Tangent streams removed:      " << m_statistics.droppedTangents << std::endl;
+}
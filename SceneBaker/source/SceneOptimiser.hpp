@@ -0,0 +1,66 @@
+#pragma once
+
+#if !defined    _SCENE_BAKER_SCENE_OPTIMISER_
+#define         _SCENE_BAKER_SCENE_OPTIMISER_
+
+// STL headers.
+#include <cstddef>
+#include <string>
+
+
+/// <summary>
+/// Reads a .tcf scene file and writes an optimised copy using tcf::Writer. Duplicate vertices are welded, streams
+/// which the renderer never uses are dropped, unreferenced vertices and degenerate triangles are removed and the
+/// remaining vertices are reordered into the order they are first referenced by the index buffer.
+/// </summary>
+class SceneOptimiser final
+{
+    public:
+
+        /// <summary> Details how much data was processed and how much was removed during optimisation. </summary>
+        struct Statistics final
+        {
+            size_t      meshes              { 0 };  //!< How many meshes were processed.
+            size_t      inputVertices       { 0 };  //!< The number of vertices in the input scene.
+            size_t      outputVertices      { 0 };  //!< The number of vertices in the output scene.
+            size_t      inputIndices        { 0 };  //!< The number of indices in the input scene.
+            size_t      outputIndices       { 0 };  //!< The number of indices in the output scene.
+            size_t      degenerateTriangles { 0 };  //!< How many triangles were removed for having zero area.
+            size_t      droppedTangents     { 0 };  //!< How many meshes had their unused tangent stream removed.
+            size_t      inputGeometryBytes  { 0 };  //!< The size of the vertex and index data in the input scene.
+            size_t      outputGeometryBytes { 0 };  //!< The size of the vertex and index data in the output scene.
+            size_t      inputFileBytes      { 0 };  //!< The size of the input file on disk.
+            size_t      outputFileBytes     { 0 };  //!< The size of the output file on disk.
+        };
+
+        SceneOptimiser() noexcept                               = default;
+        SceneOptimiser (SceneOptimiser&&) noexcept              = default;
+        SceneOptimiser& operator= (SceneOptimiser&&) noexcept   = default;
+        ~SceneOptimiser()                                       = default;
+
+        SceneOptimiser (const SceneOptimiser&)                  = delete;
+        SceneOptimiser& operator= (const SceneOptimiser&)       = delete;
+
+
+        /// <summary> Gets the statistics collected during the most recent call to optimise(). </summary>
+        const Statistics& getStatistics() const noexcept { return m_statistics; }
+
+
+        /// <summary>
+        /// Reads the scene at the given location, optimises every mesh and writes the result to the output location.
+        /// Any existing file at the output location will be overwritten.
+        /// </summary>
+        /// <param name="inputLocation"> The .tcf file to read. </param>
+        /// <param name="outputLocation"> Where to write the optimised .tcf file. </param>
+        /// <returns> Whether the scene was successfully optimised and written. </returns>
+        bool optimise (const std::string& inputLocation, const std::string& outputLocation) noexcept;
+
+        /// <summary> Writes a human-readable summary of the collected statistics to the console. </summary>
+        void printStatistics() const noexcept;
+
+    private:
+
+        Statistics  m_statistics { }; //!< Statistics from the most recent optimisation.
+};
+
+#endif // _SCENE_BAKER_SCENE_OPTIMISER_
@@ -0,0 +1,25 @@
+#include "SceneOptimiser.hpp"
+
+#include <cstdlib>
+#include <iostream>
+
+int main (int argc, char* argv[])
+{
+    if (argc != 3)
+    {
+        std::cerr << "Usage: SceneBaker <input.tcf> <output.tcf>" << std::endl;
+        std::cerr << "  Welds duplicate vertices, removes unused attribute streams" << std::endl;
+        std::cerr << "  and compacts the index buffers of every mesh in a scene." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    auto optimiser = SceneOptimiser { };
+
+    if (!optimiser.optimise (argv[1], argv[2]))
+    {
+        return EXIT_FAILURE;
+    }
+
+    optimiser.printStatistics();
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "scene_fwd.hpp"
+#include "Span.hpp"
 #include <vector>
 #include <chrono>
+#include <future>
 #include <memory>
 
 namespace scene {
@@ -13,10 +15,25 @@ public:
 
     Context();
 
+    /**
+     * When loading asynchronously the scene file is read on a background
+     * thread. Lights, materials and the camera are available immediately;
+     * meshes and instances become available during a later call to update().
+     */
+    explicit Context(bool load_asynchronously);
+
     ~Context();
 
     void update();
 
+    bool isMaterialDataReady() const;
+
+    bool isMeshDataReady() const;
+
+    bool isInstanceDataReady() const;
+
+    bool isFullyLoaded() const;
+
     bool toggleCameraAnimation();
 
     float getTimeInSeconds() const;
@@ -29,29 +46,37 @@ public:
 
     Camera& getCamera();
 
-    const std::vector<DirectionalLight>& getAllDirectionalLights() const;
+    Span<const DirectionalLight> getAllDirectionalLights() const;
 
-    const std::vector<PointLight>& getAllPointLights() const;
+    Span<const PointLight> getAllPointLights() const;
 
-    const std::vector<SpotLight>& getAllSpotLights() const;
+    Span<const SpotLight> getAllSpotLights() const;
 
-    const std::vector<Material>& getAllMaterials() const;
+    Span<const Material> getAllMaterials() const;
 
     const Material& getMaterialById(MaterialId id) const;
 
-    const std::vector<Instance>& getAllInstances() const;
+    Span<const Instance> getAllInstances() const;
 
     const Instance& getInstanceById(InstanceId id) const;
 
-    const std::vector<InstanceId> getInstancesByMeshId(MeshId id) const;
+    Span<const InstanceId> getInstancesByMeshId(MeshId id) const;
 
 private:
 
     bool readFile(std::string filepath);
 
+    void buildMaterials();
+
+    void buildInstances();
+
+    std::future<std::shared_ptr<const SceneAsset>> pending_asset_;
+
     std::chrono::system_clock::time_point start_time_;
     float time_seconds_;
 
+    std::shared_ptr<const SceneAsset> asset_;
+
     std::shared_ptr<FirstPersonMovement> camera_movement_;
     Camera camera_;
     bool animate_camera_;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "scene_fwd.hpp"
+#include "Span.hpp"
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -14,7 +16,7 @@ public:
 
     ~GeometryBuilder();
 
-    const std::vector<Mesh>& getAllMeshes() const;
+    Span<const Mesh> getAllMeshes() const;
 
     const Mesh& getMeshById(MeshId id) const;
 
@@ -22,7 +24,7 @@ private:
 
     bool readFile(std::string filepath);
 
-    std::vector<Mesh> meshes_;
+    std::shared_ptr<const SceneAsset> asset_;
 
 };
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "scene_fwd.hpp"
+#include "Span.hpp"
 #include <vector>
 
 namespace scene {
@@ -14,15 +15,15 @@ public:
 
     bool isStatic() const { return true; }
 
-    const std::vector<Vector3>& getPositionArray() const;
+    Span<const Vector3> getPositionArray() const;
 
-    const std::vector<Vector3>& getNormalArray() const;
+    Span<const Vector3> getNormalArray() const;
 
-    const std::vector<Vector3>& getTangentArray() const;
+    Span<const Vector3> getTangentArray() const;
 
-    const std::vector<Vector2>& getTextureCoordinateArray() const;
+    Span<const Vector2> getTextureCoordinateArray() const;
 
-    const std::vector<unsigned int> getElementArray() const;
+    Span<const unsigned int> getElementArray() const;
 
     void assignPositionArray(std::vector<Vector3>&& p);
     void assignNormalArray(std::vector<Vector3>&& n);
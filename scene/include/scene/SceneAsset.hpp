@@ -0,0 +1,44 @@
+#pragma once
+
+#include "scene_fwd.hpp"
+#include "Span.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace scene {
+
+/**
+ * The decoded contents of a scene file. A file is only ever decoded once per
+ * process; every subsequent load of the same file shares the same read-only
+ * data, even after every Context and GeometryBuilder using it is destroyed.
+ */
+class SceneAsset
+{
+public:
+
+    static std::shared_ptr<const SceneAsset> load(const std::string& filepath);
+
+    static void purge();
+
+    ~SceneAsset();
+
+    Span<const Mesh> getAllMeshes() const;
+
+    Span<const Matrix4x3> getTransformsByMeshIndex(size_t index) const;
+
+    size_t meshCount() const;
+
+private:
+
+    SceneAsset();
+
+    bool readFile(const std::string& filepath);
+
+    std::vector<Mesh> meshes_;
+
+    std::vector<std::vector<Matrix4x3>> transforms_by_mesh_;
+
+};
+
+} // end namespace scene
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace scene {
+
+/**
+ * A non-owning view of a contiguous array. Spans are cheap to copy and never
+ * allocate; they remain valid for as long as the object which owns the
+ * underlying storage is alive and unmodified.
+ */
+template <typename T>
+class Span
+{
+public:
+
+    typedef T value_type;
+    typedef T* iterator;
+    typedef T* const_iterator;
+
+    Span() : data_(nullptr), size_(0) {}
+
+    Span(T* data, std::size_t size) : data_(data), size_(size) {}
+
+    template <typename U, typename Alloc>
+    Span(const std::vector<U, Alloc>& vector)
+        : data_(vector.data()), size_(vector.size()) {}
+
+    T* data() const { return data_; }
+
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+    T* begin() const { return data_; }
+
+    T* end() const { return data_ + size_; }
+
+    T& operator[](std::size_t index) const { return data_[index]; }
+
+    T& front() const { return data_[0]; }
+
+    T& back() const { return data_[size_ - 1]; }
+
+private:
+
+    T* data_;
+    std::size_t size_;
+
+};
+
+} // end namespace scene
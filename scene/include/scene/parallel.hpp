@@ -0,0 +1,71 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace scene {
+
+/**
+ * Calls func once for every index in the range [0, count) using every
+ * available hardware thread. Indices are handed out one at a time so uneven
+ * workloads are balanced across threads, and the calling thread also performs
+ * work. Only returns once every thread has finished. If func throws, no more
+ * indices are handed out and the first exception is rethrown to the caller.
+ */
+template <typename Func>
+void parallelFor(std::size_t count, const Func& func)
+{
+    const std::size_t hardware_threads = std::thread::hardware_concurrency();
+    const std::size_t thread_count =
+        std::max(std::size_t(1), std::min(hardware_threads, count));
+
+    std::atomic<std::size_t> next(0);
+    auto worker = [&]() {
+        try {
+            for (std::size_t i = next++; i < count; i = next++) {
+                func(i);
+            }
+        }
+        catch (...) {
+            next = count;
+            throw;
+        }
+    };
+
+    std::vector<std::future<void>> workers;
+    workers.reserve(thread_count - 1);
+    for (std::size_t i = 1; i < thread_count; ++i) {
+        workers.push_back(std::async(std::launch::async, worker));
+    }
+
+    std::exception_ptr error;
+    try {
+        worker();
+    }
+    catch (...) {
+        error = std::current_exception();
+    }
+
+    // Every worker must be joined before returning, even after a failure.
+    for (auto& task : workers) {
+        try {
+            task.get();
+        }
+        catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // end namespace scene
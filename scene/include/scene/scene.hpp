@@ -1,9 +1,11 @@
 #pragma once
 
 #include "scene_fwd.hpp"
+#include "Span.hpp"
 #include "Camera.hpp"
 #include "Context.hpp"
 #include "GeometryBuilder.hpp"
+#include "SceneAsset.hpp"
 #include "Instance.hpp"
 #include "DirectionalLight.hpp"
 #include "PointLight.hpp"
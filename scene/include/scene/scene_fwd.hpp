@@ -9,6 +9,8 @@ typedef unsigned int InstanceId;
 typedef unsigned int MeshId;
 typedef unsigned int LightId;
 
+template <typename T> class Span;
+
 class FirstPersonMovement;
 
 class Camera;
@@ -25,6 +27,8 @@ class Mesh;
 
 class Instance;
 
+class SceneAsset;
+
 class GeometryBuilder;
 
 class Context;
@@ -1,9 +1,6 @@
 #include <scene/scene.hpp>
 #include "FirstPersonMovement.hpp"
 
-#include <tcf/tcf.hpp>
-#include <tcf/SimpleScene.hpp>
-
 #include <random>
 #include <cmath>
 
@@ -36,12 +33,23 @@ Vector3 operator-(const Vector3& lhs, const Vector3& rhs)
     return Vector3(lhs.x - rhs.x, lhs.y - rhs.y, lhs.z - rhs.z);
 }
 
-Context::Context()
+Context::Context() : Context(false)
+{
+}
+
+Context::Context(bool load_asynchronously)
 {
     start_time_ = std::chrono::system_clock::now();
     time_seconds_ = 0.f;
 
-    if (!readFile("sponza_with_friends_2x.tcf")) {
+    buildMaterials();
+
+    if (load_asynchronously) {
+        pending_asset_ = std::async(std::launch::async, []() {
+            return SceneAsset::load("sponza_with_friends_2x.tcf");
+        });
+    }
+    else if (!readFile("sponza_with_friends_2x.tcf")) {
         throw std::runtime_error("Failed to read sponza.tcf data file");
     }
 
@@ -63,44 +71,68 @@ Context::~Context()
 
 bool Context::readFile(std::string filepath)
 {
-    tcf::Reader * reader = tcf::createReader();
-    tcf::SimpleScene * tcf_scene = nullptr;
-
-    try {
-        reader->openFile(filepath.c_str());
-        reader->skipChunk(); // don't care about HEAD
-        if (reader->hasChunk()) {
-            reader->openChunk();
-            if (chunkIsSimpleScene(reader)) {
-                tcf_scene = readSimpleScene(reader);
-            }
-        }
-        reader->closeFile();
-    } catch (...) {
-        if (reader) reader->release();
-        if (tcf_scene) tcf_scene->release();
+    asset_ = SceneAsset::load(filepath);
+    if (asset_ == nullptr) {
         return false;
     }
 
+    buildInstances();
+
+    return true;
+}
+
+void Context::buildMaterials()
+{
+    Vector3 diffuse_colours[7] = {
+        Vector3(1.f, 0.33f, 0.f),
+        Vector3(0.f, 0.33f, 1.f),
+        Vector3(0.2f, 0.8f, 0.2f),
+        Vector3(0.8f, 0.8f, 0.2f),
+        Vector3(0.8f, 0.4f, 0.4f),
+        Vector3(0.4f, 0.8f, 0.4f),
+        Vector3(0.4f, 0.4f, 0.8f)
+    };
+    Vector3 specular_colours[7] = {
+        Vector3(0, 0, 0),
+        Vector3(0, 0, 0),
+        Vector3(1, 1, 1),
+        Vector3(0.8f, 0.8f, 0.2f),
+        Vector3(0.8f, 0.4f, 0.4f),
+        Vector3(0.4f, 0.8f, 0.4f),
+        Vector3(0.4f, 0.4f, 0.8f)
+    };
+    float shininess[7] = { 0.f, 0.f, 64.f, 128.f, 64.f, 0.f, 0.f };
+
+    materials_.clear();
+
+    Material new_material(200);
+    new_material.setDiffuseColour(Vector3(0.8f, 0.8f, 0.8f));
+    materials_.push_back(new_material);
+    for (int j = 0; j<7; ++j) {
+        Material new_material(200 + j + 1);
+        new_material.setDiffuseColour(diffuse_colours[j]);
+        new_material.setSpecularColour(specular_colours[j]);
+        new_material.setShininess(shininess[j]);
+        materials_.push_back(new_material);
+    }
+}
+
+void Context::buildInstances()
+{
     instances_.clear();
     instances_by_mesh_.clear();
 
-    instances_by_mesh_.reserve(tcf_scene->meshCount());
-    for (unsigned int i = 0; i < tcf_scene->meshCount(); ++i) {
-        const auto * mesh = tcf_scene->findMeshByIndex(i);
+    instances_by_mesh_.reserve(asset_->meshCount());
+    for (size_t i = 0; i < asset_->meshCount(); ++i) {
+        const auto& transforms = asset_->getTransformsByMeshIndex(i);
         std::vector<InstanceId> instances;
-        instances.reserve(mesh->instanceCount());
-        instances_.reserve(instances_.size() + mesh->instanceCount());
-        for (unsigned int j = 0; j < mesh->instanceCount(); ++j) {
-            const auto& model = mesh->transformationArray()[j];
+        instances.reserve(transforms.size());
+        instances_.reserve(instances_.size() + transforms.size());
+        for (const auto& model : transforms) {
             Instance new_model(100 + instances_.size());
             new_model.setMeshId(300 + instances_by_mesh_.size());
             new_model.setMaterialId(200);
-            new_model.setTransformationMatrix(
-                Matrix4x3(model.m00, model.m01, model.m02,
-                          model.m10, model.m11, model.m12,
-                          model.m20, model.m21, model.m22,
-                          model.m30, model.m31, model.m32));
+            new_model.setTransformationMatrix(model);
             instances.push_back(new_model.getId());
             instances_.push_back(new_model);
         }
@@ -130,48 +162,45 @@ bool Context::readFile(std::string filepath)
         sizeof(happyShapes) / sizeof(int),
         sizeof(bunnyShapes) / sizeof(int),
         sizeof(dragonShapes) / sizeof(int) };
-    Vector3 diffuse_colours[7] = {
-        Vector3(1.f, 0.33f, 0.f),
-        Vector3(0.f, 0.33f, 1.f),
-        Vector3(0.2f, 0.8f, 0.2f),
-        Vector3(0.8f, 0.8f, 0.2f),
-        Vector3(0.8f, 0.4f, 0.4f),
-        Vector3(0.4f, 0.8f, 0.4f),
-        Vector3(0.4f, 0.4f, 0.8f)
-    };
-    Vector3 specular_colours[7] = {
-        Vector3(0, 0, 0),
-        Vector3(0, 0, 0),
-        Vector3(1, 1, 1),
-        Vector3(0.8f, 0.8f, 0.2f),
-        Vector3(0.8f, 0.4f, 0.4f),
-        Vector3(0.4f, 0.8f, 0.4f),
-        Vector3(0.4f, 0.4f, 0.8f)
-    };
-    float shininess[7] = { 0.f, 0.f, 64.f, 128.f, 64.f, 0.f, 0.f };
-    Material new_material(200);
-    new_material.setDiffuseColour(Vector3(0.8f, 0.8f, 0.8f));
-    materials_.push_back(new_material);
     for (int j = 0; j<7; ++j) {
-        Material new_material(200 + j + 1);
-        new_material.setDiffuseColour(diffuse_colours[j]);
-        new_material.setSpecularColour(specular_colours[j]);
-        new_material.setShininess(shininess[j]);
-        materials_.push_back(new_material);
         for (int i = 0; i<numberOfShapes[j]; ++i) {
             int index = shapes[j][i];
-            instances_[index].setMaterialId(new_material.getId());
+            instances_[index].setMaterialId(materials_[j + 1].getId());
         }
     }
+}
 
-    reader->release();
-    tcf_scene->release();
-    
-    return true;
+bool Context::isMaterialDataReady() const
+{
+    return !materials_.empty();
+}
+
+bool Context::isMeshDataReady() const
+{
+    return asset_ != nullptr;
+}
+
+bool Context::isInstanceDataReady() const
+{
+    return !instances_by_mesh_.empty();
+}
+
+bool Context::isFullyLoaded() const
+{
+    return isMaterialDataReady() && isMeshDataReady() && isInstanceDataReady();
 }
 
 void Context::update()
 {
+    if (pending_asset_.valid() && pending_asset_.wait_for(
+        std::chrono::seconds(0)) == std::future_status::ready) {
+        asset_ = pending_asset_.get();
+        if (asset_ == nullptr) {
+            throw std::runtime_error("Failed to read sponza.tcf data file");
+        }
+        buildInstances();
+    }
+
     const auto clock_time = std::chrono::system_clock::now() - start_time_;
     const auto clock_millisecs
         = std::chrono::duration_cast<std::chrono::milliseconds>(clock_time);
@@ -319,22 +348,22 @@ Camera& Context::getCamera()
     return camera_;
 }
 
-const std::vector<DirectionalLight>& Context::getAllDirectionalLights() const
+Span<const DirectionalLight> Context::getAllDirectionalLights() const
 {
     return directional_lights_;
 }
 
-const std::vector<PointLight>& Context::getAllPointLights() const
+Span<const PointLight> Context::getAllPointLights() const
 {
     return point_lights_;
 }
 
-const std::vector<SpotLight>& Context::getAllSpotLights() const
+Span<const SpotLight> Context::getAllSpotLights() const
 {
     return spot_lights_;
 }
 
-const std::vector<Material>& Context::getAllMaterials() const
+Span<const Material> Context::getAllMaterials() const
 {
     return materials_;
 }
@@ -344,7 +373,7 @@ const Material& Context::getMaterialById(MaterialId id) const
     return materials_[id - 200];
 }
 
-const std::vector<Instance>& Context::getAllInstances() const
+Span<const Instance> Context::getAllInstances() const
 {
     return instances_;
 }
@@ -354,7 +383,7 @@ const Instance& Context::getInstanceById(InstanceId id) const
     return instances_[id - 100];
 }
 
-const std::vector<InstanceId> Context::getInstancesByMeshId(MeshId id) const
+Span<const InstanceId> Context::getInstancesByMeshId(MeshId id) const
 {
     return instances_by_mesh_[id - 300];
 }
@@ -11,52 +11,52 @@ MeshId Mesh::getId() const
     return id;
 }
 
-const std::vector<Vector3>& Mesh::getPositionArray() const
+Span<const Vector3> Mesh::getPositionArray() const
 {
     return position_array;
 }
 
 void Mesh::assignPositionArray(std::vector<Vector3>&& p)
 {
-    position_array = p;
+    position_array = std::move(p);
 }
 
-const std::vector<Vector3>& Mesh::getNormalArray() const
+Span<const Vector3> Mesh::getNormalArray() const
 {
     return normal_array;
 }
 
 void Mesh::assignNormalArray(std::vector<Vector3>&& n)
 {
-    normal_array = n;
+    normal_array = std::move(n);
 }
 
-const std::vector<Vector3>& Mesh::getTangentArray() const
+Span<const Vector3> Mesh::getTangentArray() const
 {
     return tangent_array;
 }
 
 void Mesh::assignTangentArray(std::vector<Vector3>&& t)
 {
-    tangent_array = t;
+    tangent_array = std::move(t);
 }
 
-const std::vector<Vector2>& Mesh::getTextureCoordinateArray() const
+Span<const Vector2> Mesh::getTextureCoordinateArray() const
 {
     return texcoord_array;
 }
 
 void Mesh::assignTextureCoordinateArray(std::vector<Vector2>&& t)
 {
-    texcoord_array = t;
+    texcoord_array = std::move(t);
 }
 
-const std::vector<unsigned int> Mesh::getElementArray() const
+Span<const unsigned int> Mesh::getElementArray() const
 {
     return element_array;
 }
 
 void Mesh::assignElementArray(std::vector<unsigned int>&& e)
 {
-    element_array = e;
+    element_array = std::move(e);
 }
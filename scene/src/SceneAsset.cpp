@@ -0,0 +1,170 @@
+#include <scene/scene.hpp>
+#include <scene/parallel.hpp>
+#include <tcf/tcf.hpp>
+#include <tcf/SimpleScene.hpp>
+
+#include <map>
+#include <mutex>
+
+using namespace scene;
+
+/******************************************************************************
+*
+*
+* STOP!
+*
+* You shouldn't be reading this source file.
+* You don't need to know about the implementation of the SceneAsset.
+* Do not base any of your code on how this is implemented,
+* to do so would break the concept of encapsulation.
+*
+*
+*****************************************************************************/
+
+namespace {
+
+std::mutex cache_mutex_;
+std::map<std::string, std::shared_ptr<const SceneAsset>> cache_;
+
+} // end anonymous namespace
+
+std::shared_ptr<const SceneAsset> SceneAsset::load(const std::string& filepath)
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+
+    auto cached = cache_.find(filepath);
+    if (cached != cache_.end()) {
+        return cached->second;
+    }
+
+    std::shared_ptr<SceneAsset> asset(new SceneAsset());
+    if (!asset->readFile(filepath)) {
+        return nullptr;
+    }
+
+    cache_[filepath] = asset;
+    return asset;
+}
+
+void SceneAsset::purge()
+{
+    std::lock_guard<std::mutex> lock(cache_mutex_);
+    cache_.clear();
+}
+
+SceneAsset::SceneAsset()
+{
+}
+
+SceneAsset::~SceneAsset()
+{
+}
+
+Span<const Mesh> SceneAsset::getAllMeshes() const
+{
+    return meshes_;
+}
+
+Span<const Matrix4x3> SceneAsset::getTransformsByMeshIndex(size_t index) const
+{
+    return transforms_by_mesh_[index];
+}
+
+size_t SceneAsset::meshCount() const
+{
+    return meshes_.size();
+}
+
+bool SceneAsset::readFile(const std::string& filepath)
+{
+    tcf::Reader * reader = tcf::createReader();
+    tcf::SimpleScene * tcf_scene = nullptr;
+
+    try {
+        reader->openFile(filepath.c_str());
+        reader->skipChunk(); // don't care about HEAD
+        if (reader->hasChunk()) {
+            reader->openChunk();
+            if (chunkIsSimpleScene(reader)) {
+                tcf_scene = readSimpleScene(reader);
+            }
+        }
+        reader->closeFile();
+    }
+    catch (...) {
+        if (reader) reader->release();
+        if (tcf_scene) tcf_scene->release();
+        return false;
+    }
+
+    if (tcf_scene == nullptr) {
+        reader->release();
+        return false;
+    }
+
+    const unsigned int mesh_count = tcf_scene->meshCount();
+
+    meshes_.clear();
+    transforms_by_mesh_.clear();
+
+    meshes_.reserve(mesh_count);
+    for (unsigned int i = 0; i < mesh_count; ++i) {
+        meshes_.push_back(Mesh(300 + i));
+    }
+    transforms_by_mesh_.resize(mesh_count);
+
+    // Every mesh is copied into its own preallocated slot so the meshes can
+    // be decoded on as many threads as are available.
+    try {
+        parallelFor(mesh_count, [&](std::size_t i) {
+            const auto * mesh = tcf_scene->findMeshByIndex(static_cast<unsigned int>(i));
+            Mesh& new_mesh = meshes_[i];
+            if (mesh->indexArray() != nullptr) {
+                new_mesh.assignElementArray(std::vector<unsigned int>(
+                    mesh->indexArray(),
+                    mesh->indexArray() + mesh->indexCount()));
+            }
+            if (mesh->positionArray() != nullptr) {
+                new_mesh.assignPositionArray(std::vector<Vector3>(
+                    (const Vector3 *)mesh->positionArray(),
+                    (const Vector3 *)mesh->positionArray() + mesh->vertexCount()));
+            }
+            if (mesh->normalArray() != nullptr) {
+                new_mesh.assignNormalArray(std::vector<Vector3>(
+                    (const Vector3 *)mesh->normalArray(),
+                    (const Vector3 *)mesh->normalArray() + mesh->vertexCount()));
+            }
+            if (mesh->tangentArray() != nullptr) {
+                new_mesh.assignTangentArray(std::vector<Vector3>(
+                    (const Vector3 *)mesh->tangentArray(),
+                    (const Vector3 *)mesh->tangentArray() + mesh->vertexCount()));
+            }
+            if (mesh->uvArray() != nullptr) {
+                new_mesh.assignTextureCoordinateArray(std::vector<Vector2>(
+                    (const Vector2 *)mesh->uvArray(),
+                    (const Vector2 *)mesh->uvArray() + mesh->vertexCount()));
+            }
+
+            std::vector<Matrix4x3>& transforms = transforms_by_mesh_[i];
+            transforms.reserve(mesh->instanceCount());
+            for (unsigned int j = 0; j < mesh->instanceCount(); ++j) {
+                const auto& model = mesh->transformationArray()[j];
+                transforms.push_back(
+                    Matrix4x3(model.m00, model.m01, model.m02,
+                              model.m10, model.m11, model.m12,
+                              model.m20, model.m21, model.m22,
+                              model.m30, model.m31, model.m32));
+            }
+        });
+    }
+    catch (...) {
+        reader->release();
+        tcf_scene->release();
+        return false;
+    }
+
+    reader->release();
+    tcf_scene->release();
+
+    return true;
+}